@@ -4,24 +4,27 @@
 #include <cstdint>
 #include <string>
 
-#include <netinet/in.h>
+#include <sys/socket.h>
 
 class Address {
 public:
     Address() = default;
     Address(std::string ip_address, uint16_t port, int conn_fd = -1);
-    explicit Address(const sockaddr_in& addr, int conn_fd = -1);
+    // 支持 AF_INET、AF_INET6 与 AF_UNIX
+    Address(const sockaddr_storage& addr, socklen_t length, int conn_fd = -1);
 
     [[nodiscard]] std::string ip() const;
     [[nodiscard]] uint16_t port() const;
     [[nodiscard]] int fd() const;
+    [[nodiscard]] sa_family_t family() const;
     [[nodiscard]] std::string toString() const;
 
     bool operator==(const Address& other) const;
     bool operator!=(const Address& other) const;
 
 private:
-    std::string ip_;
+    sa_family_t family_{AF_INET};
+    std::string ip_;  // Unix 域 socket 时为 socket 文件路径
     uint16_t port_{};
     int fd_{-1};
 };
@@ -0,0 +1,56 @@
+#ifndef CORE_ADMISSION_CONTROL_H
+#define CORE_ADMISSION_CONTROL_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+
+// 连接准入控制：限制所有 Reactor 的连接总数，统计被拒绝的连接，
+// 并预留一个 fd，在进程 fd 耗尽（EMFILE / ENFILE）时仍能接受连接并立即以 503 拒绝
+class AdmissionControl {
+public:
+    enum class Rejection : uint8_t {
+        OVER_LIMIT,  // 超过 max_connections
+        NO_FD,       // 文件描述符耗尽
+    };
+
+    // max_connections 为 0 表示不限制连接数
+    explicit AdmissionControl(size_t max_connections);
+    ~AdmissionControl();
+
+    AdmissionControl(const AdmissionControl&) = delete;
+    AdmissionControl& operator=(const AdmissionControl&) = delete;
+    AdmissionControl(AdmissionControl&&) = delete;
+    AdmissionControl& operator=(AdmissionControl&&) = delete;
+
+    // 占用一个连接名额，已达上限时返回 false
+    [[nodiscard]] bool tryAcquire();
+
+    // 归还连接名额
+    void release();
+
+    // 临时关闭预留 fd 并执行 action，之后重新占用；没有可用的预留 fd 时返回 false 且不执行 action
+    [[nodiscard]] bool withReserveFd(const std::function<void()>& action);
+
+    void countRejection(Rejection reason);
+
+    [[nodiscard]] size_t maxConnections() const;
+    [[nodiscard]] size_t active() const;
+    [[nodiscard]] uint64_t rejected(Rejection reason) const;
+
+private:
+    const size_t max_connections_;
+    std::atomic<size_t> active_{0};
+
+    std::atomic<uint64_t> rejected_over_limit_{0};
+    std::atomic<uint64_t> rejected_no_fd_{0};
+
+    int reserve_fd_{-1};  // 预留的 fd（打开 /dev/null），多个 Reactor 共享
+    std::mutex reserve_mutex_;
+
+    void openReserveFd();
+};
+
+#endif  // CORE_ADMISSION_CONTROL_H
@@ -2,24 +2,71 @@
 #define CORE_CONNECTION_H
 
 #include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
 #include <functional>
-
-#include <netinet/in.h>
+#include <memory>
+#include <optional>
+#include <string>
 
 #include "core/address.h"
 #include "core/http_request.h"
+#include "core/http_response.h"
+#include "utils/cancellation_token.h"
+#include "utils/read_buffer.h"
 
 // 前向声明
-class EpollManager;
+class EventBackend;
+class Http2Session;
 class Logger;
+class RequestContext;
 class StaticFile;
+class UploadFile;
 class UserManager;
-class HttpResponse;
 
-class Connection {
+struct ConnectionOptions {
+    bool linger = false;                         // 是否启用 linger 模式
+    bool keep_alive = true;                      // 是否启用长连接
+    size_t max_requests = DEFAULT_MAX_REQUESTS;  // 单个长连接最多处理的请求数
+    bool http2 = true;                           // 是否支持明文 HTTP/2（h2c）
+
+    // 请求大小限制：超出时分别返回 431 / 413，请求体上限为 0 表示不限制。
+    // 上传请求体流式写入磁盘，受 max_body_size 限制；其余请求（登录、注册等表单）的请求体整体缓存在内存中，
+    // 受 max_form_size 限制
+    size_t max_header_size = DEFAULT_MAX_HEADER_SIZE;
+    size_t max_body_size = DEFAULT_MAX_BODY_SIZE;
+    size_t max_form_size = DEFAULT_MAX_FORM_SIZE;
+
+    // 超时设置，0 表示不限制
+    std::chrono::seconds header_timeout{DEFAULT_HEADER_TIMEOUT};          // 从请求开始到请求头接收完整的时限
+    std::chrono::seconds body_timeout{DEFAULT_BODY_TIMEOUT};              // 接收请求体时两次读取之间的最长间隔
+    std::chrono::seconds idle_timeout{DEFAULT_IDLE_TIMEOUT};              // 发送响应或 HTTP/2 连接无活动的最长时间
+    std::chrono::seconds keep_alive_timeout{DEFAULT_KEEP_ALIVE_TIMEOUT};  // 长连接等待下一个请求的时限
+
+    static constexpr size_t DEFAULT_MAX_REQUESTS = 100;
+    static constexpr size_t DEFAULT_MAX_HEADER_SIZE = 32 * 1024;
+    static constexpr size_t DEFAULT_MAX_BODY_SIZE = 1024 * 1024 * 1024;
+    static constexpr size_t DEFAULT_MAX_FORM_SIZE = 16 * 1024;
+    static constexpr std::chrono::seconds DEFAULT_HEADER_TIMEOUT{10};
+    static constexpr std::chrono::seconds DEFAULT_BODY_TIMEOUT{30};
+    static constexpr std::chrono::seconds DEFAULT_IDLE_TIMEOUT{60};
+    static constexpr std::chrono::seconds DEFAULT_KEEP_ALIVE_TIMEOUT{15};
+
+    [[nodiscard]] bool hasTimeouts() const {
+        using std::chrono::seconds;
+        return header_timeout != seconds::zero() || body_timeout != seconds::zero() ||
+               idle_timeout != seconds::zero() || keep_alive_timeout != seconds::zero();
+    }
+};
+
+// 由 std::shared_ptr 持有；异步发送期间事件后端通过 shared_from_this() 保持连接存活
+class Connection : public std::enable_shared_from_this<Connection> {
 public:
-    Connection(int client_fd, const sockaddr_in& addr, EpollManager* epoll, Logger* logger, StaticFile* static_file,
-               UserManager* user_manager, bool linger = false);
+    // generation 为该 fd 在所属 Reactor 连接表中的代数，随事件注册写入事件数据
+    Connection(int client_fd, uint32_t generation, const Address& info, EventBackend* event_backend, Logger* logger,
+               StaticFile* static_file, UserManager* user_manager, const ConnectionOptions& options = {});
     ~Connection();
 
     Connection(const Connection&) = delete;
@@ -30,34 +77,117 @@ public:
     [[nodiscard]] int fd() const;
     [[nodiscard]] const Address& info() const;
 
-    void handleRead() const;
+    // shed 为 true 时（线程池过载）尚未开始接收请求体的 HTTP/1.x 请求在请求头到达后立即以 503 响应并关闭连接，
+    // HTTP/2 连接上的新流同样以 503 拒绝；正在接收请求体的请求不受影响
+    void handleRead(bool shed = false) const;
     void handleWrite() const;
 
+    // 静态资源快速路径，在事件循环线程中调用：位于请求边界时读取一次，缓冲区中的请求均可由内存缓存直接响应时
+    // 就地发送并返回 true；返回 false 表示有需要交给工作线程的请求，随后应在工作线程中调用 handleRead()
+    [[nodiscard]] bool handleReadInline() const;
+
+    // 可写事件的快速路径，在事件循环线程中调用：发送队列只含内存片段且没有待处理的请求时就地发送并返回 true，
+    // io_uring 后端的发送在此与其他请求合并提交；返回 false 表示应在工作线程中调用 handleWrite()
+    [[nodiscard]] bool handleWriteInline() const;
+
+    // 位于 HTTP/1.x 请求边界（尚未解析出请求头），过载时可在事件循环线程中读取请求头并直接拒绝，
+    // 不会在事件循环线程中处理请求体或写入磁盘
+    [[nodiscard]] bool atRequestBoundary() const;
+
+    // 当前阶段的超时截止时间；工作线程处理期间为 time_point::max()，不会超时
+    [[nodiscard]] std::chrono::steady_clock::time_point deadline() const;
+
+    // 超时：关闭 socket 的读写方向，连接随后在事件回调中按正常流程关闭
+    void expire() const;
+
+    // 连接已断开（EPOLLHUP / EPOLLERR）：取消正在处理的请求，由事件循环线程调用
+    void cancel() const;
+
+    // 服务器优雅关闭，由事件循环线程调用：空闲连接立即关闭，其余连接发送完当前响应后关闭
+    // （HTTP/1.x 不再保持长连接，HTTP/2 发送 GOAWAY 并等待已接受的流结束）
+    void drain();
+
     void setCloseRequestCallback(std::function<void(int)> callback);
 
 private:
     int client_fd_;
+    uint64_t event_data_;  // 注册事件时附带的数据（fd 与代数）
     Address info_;
-    EpollManager* epoll_manager_;
+    EventBackend* event_backend_;
     Logger* logger_;
     StaticFile* static_file_;
     UserManager* user_manager_;
+    const ConnectionOptions options_;
 
-    mutable std::string request_buffer_;  // 用于存储请求数据
+    mutable ReadBuffer request_buffer_;   // 接收缓冲区，空闲时归还存储
     mutable HttpRequest request_;         // 用于解析请求
 
-    mutable std::string write_buffer_;         // 用于存储响应数据
-    mutable std::string_view pending_buffer_;  // 用于存储待发送的数据
+    mutable std::deque<BodySegment> output_queue_;  // 按请求顺序排列的待发送响应片段
+    mutable size_t output_offset_{0};               // 队首内存片段已发送的字节数
+
+    mutable size_t request_count_{0};        // 已处理的请求数
+    mutable bool close_after_write_{false};  // 队列发送完毕后是否关闭连接
+    mutable bool shedding_{false};           // 本次读事件是否处于过载拒绝模式
+    mutable bool request_checked_{false};    // 当前请求的请求头已通过检查
+    mutable bool linger_close_{false};       // 请求体未读完即拒绝，发送响应后需要 lingering close
+    mutable bool lingering_{false};          // 已关闭写方向，正在丢弃对端剩余的数据
+    mutable bool peer_closed_{false};        // 对端已关闭写方向，处理完已收到的请求后关闭连接
+    mutable std::chrono::steady_clock::time_point linger_until_;
+
+    mutable std::unique_ptr<Http2Session> http2_;  // 升级为 HTTP/2 后的会话
+    mutable std::unique_ptr<UploadFile> upload_;   // 正在流式接收的上传请求体
+
+    mutable std::chrono::steady_clock::time_point request_start_;           // 当前请求开始接收的时间
+    mutable std::atomic<std::chrono::steady_clock::time_point> deadline_;  // 由工作线程写入、事件循环读取
+    mutable std::atomic<const char*> phase_{"request header"};             // 超时时所处的阶段，用于日志
+
+    CancellationToken cancel_token_;  // 客户端断开时取消，传递给耗时的请求处理
+    mutable bool watching_{false};    // 处理请求期间只监听连接断开
+
+    mutable std::atomic<bool> idle_{false};  // 正在等待新请求，没有未完成的请求或响应
+    std::atomic<bool> draining_{false};      // 服务器正在优雅关闭
 
     std::atomic<bool> closed_{false};  // 是否关闭连接
 
     std::function<void(int)> callback_;
 
+    // 读取数据直到 EAGAIN、累计 max_bytes 字节或缓冲区已满；连接已关闭时返回 false
+    [[nodiscard]] bool receive(size_t max_bytes) const;
+
+    // 快速路径：缓冲区头部是可由内存缓存直接响应的 GET 时将响应加入发送队列
+    [[nodiscard]] bool serveFromCache() const;
+
+    void processInput() const;
     bool tryParse() const;
+    bool parseRequest() const;
+    [[nodiscard]] std::optional<HttpResponse> checkRequest(const HttpRequest& request) const;
+
+    // 请求体上限：上传请求为 max_body_size，其余请求为 max_form_size，0 表示不限制
+    [[nodiscard]] size_t bodyLimit(const HttpRequest& request) const;
+    void rejectEarly(HttpResponse& response) const;
+    void startLingeringClose() const;
+    [[nodiscard]] std::unique_ptr<Http2Session> createHttp2Session() const;
+    bool processHttp2() const;
+    [[nodiscard]] bool upgradeToHttp2() const;
+    void queueResponse(HttpResponse& response, bool keep_alive, bool chunked) const;
+    [[nodiscard]] bool flushOutput() const;
+
+    // 发送队列已清空且需要关闭连接时开始关闭，返回是否已关闭
+    [[nodiscard]] bool closeAfterWrite() const;
+    [[nodiscard]] bool pullProducer() const;
+    [[nodiscard]] ssize_t sendMemorySegments() const;
+    [[nodiscard]] ssize_t sendFileSegment() const;
+
+    // 根据连接当前所处的阶段计算超时截止时间，之后重新注册事件
+    void updateDeadline() const;
+    void rearm(uint32_t events) const;
+
+    // 处理请求期间只监听对端关闭，不读取后续数据
+    void watchDisconnect() const;
 
     [[nodiscard]] HttpResponse handleRequest(const HttpRequest& request) const;
-    [[nodiscard]] HttpResponse handleGetRequest(const HttpRequest& request) const;
-    [[nodiscard]] HttpResponse handlePostRequest(const HttpRequest& request) const;
+    [[nodiscard]] HttpResponse handleGetRequest(const RequestContext& context) const;
+    [[nodiscard]] HttpResponse handlePostRequest(const RequestContext& context) const;
 
     void requestCloseConnection() const;
     void closeConnection();
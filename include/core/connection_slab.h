@@ -0,0 +1,95 @@
+#ifndef CORE_CONNECTION_SLAB_H
+#define CORE_CONNECTION_SLAB_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// 前向声明
+class Connection;
+
+// 以 fd 为下标的连接表：槽位按块（1024 个）在首次用到时分配，之后不再移动或释放，查找既不加锁也不哈希、不分配内存；
+// 内存占用随实际出现过的最大 fd 增长，与 RLIMIT_NOFILE 的大小无关。
+// 每个槽位带代数，随事件注册写入 epoll_event.data.u64，fd 关闭后被新连接复用时，旧连接遗留的事件因代数不符被丢弃。
+// 除 retire() 外只由所属 Reactor 的事件循环线程访问；工作线程关闭连接时只把 fd 压入无锁的待回收栈，由事件循环统一回收
+class ConnectionSlab {
+public:
+    // capacity 为可容纳的最大 fd + 1，默认取 RLIMIT_NOFILE 的软限制（accept 不会返回更大的 fd）
+    explicit ConnectionSlab(size_t capacity = defaultCapacity());
+
+    ConnectionSlab(const ConnectionSlab&) = delete;
+    ConnectionSlab& operator=(const ConnectionSlab&) = delete;
+    ConnectionSlab(ConnectionSlab&&) = delete;
+    ConnectionSlab& operator=(ConnectionSlab&&) = delete;
+
+    // 为新接受的 fd 分配下一个代数（从 1 开始，跳过 0），fd 超出容量时返回 0
+    [[nodiscard]] uint32_t assign(int fd);  // NOLINT(readability-identifier-length)
+
+    // 登记 assign() 之后创建的连接
+    void put(int fd, std::shared_ptr<Connection> conn);  // NOLINT(readability-identifier-length)
+
+    // 按事件数据查找连接；fd 超出范围、槽位为空、已请求关闭或代数不符（过期事件）时返回空指针
+    [[nodiscard]] const std::shared_ptr<Connection>& find(uint64_t event_data) const;
+
+    // 任意线程：请求回收 fd 上代数为 generation 的连接，重复请求与过期请求被忽略；
+    // 返回 true 表示待回收栈此前为空，调用方需唤醒事件循环
+    bool retire(int fd, uint32_t generation);  // NOLINT(readability-identifier-length)
+
+    // 回收所有已请求关闭的连接，返回回收的数量
+    size_t reclaim();
+
+    // 遍历所有连接（含已请求关闭但尚未回收的）
+    template <typename Func>
+    void forEach(Func&& func) const {
+        size_t visited = 0;
+        for (size_t chunk = 0; chunk < CHUNK_COUNT && visited < size_; ++chunk) {
+            if (!chunks_.at(chunk)) {
+                continue;
+            }
+            for (size_t index = 0; index < CHUNK_SIZE && visited < size_; ++index) {
+                if (const auto& conn = chunks_.at(chunk)[index].conn) {
+                    ++visited;
+                    func(conn);
+                }
+            }
+        }
+    }
+
+    // 释放所有连接
+    void clear();
+
+    [[nodiscard]] size_t size() const;
+    [[nodiscard]] size_t capacity() const;
+
+    [[nodiscard]] static size_t defaultCapacity();
+
+private:
+    struct Slot {
+        std::shared_ptr<Connection> conn;      // 只在事件循环线程中访问
+        std::atomic<uint32_t> generation{0};  // 当前连接的代数，0 表示从未使用
+        std::atomic<bool> retired{false};     // 已压入待回收栈
+        int next_retired{-1};                 // 待回收栈中的下一个 fd
+    };
+
+    static constexpr size_t MAX_CAPACITY = size_t{1} << 20;
+    static constexpr size_t CHUNK_SHIFT = 10;
+    static constexpr size_t CHUNK_SIZE = size_t{1} << CHUNK_SHIFT;
+    static constexpr size_t CHUNK_COUNT = MAX_CAPACITY / CHUNK_SIZE;
+    static constexpr int NO_FD = -1;
+
+    size_t capacity_;
+
+    // 槽位块，只在事件循环线程的 assign() 中分配。工作线程只会通过 retire() 访问自己连接的槽位，
+    // 该槽位所在的块在连接创建前已分配，连接交给工作线程时经过的同步保证其可见
+    std::array<std::unique_ptr<Slot[]>, CHUNK_COUNT> chunks_;  // NOLINT(cppcoreguidelines-avoid-c-arrays)
+    size_t size_{0};                                           // 已登记的连接数
+
+    std::atomic<int> retired_head_{NO_FD};  // 待回收栈（只整体弹出，不存在 ABA 问题）
+
+    // fd 对应的槽位，fd 超出容量或所在的块尚未分配时返回空指针
+    [[nodiscard]] Slot* slotAt(int fd) const;  // NOLINT(readability-identifier-length)
+};
+
+#endif  // CORE_CONNECTION_SLAB_H
@@ -2,27 +2,37 @@
 #define CORE_EPOLL_MANAGER_H
 
 #include <cstdint>
-#include <mutex>
+#include <memory>
 #include <span>
-#include <unordered_set>
+#include <string>
 
 #include <sys/epoll.h>
 
-class EpollManager {
+#include "core/event_backend.h"
+
+class EpollManager final : public EventBackend {
 public:
     explicit EpollManager();
-    ~EpollManager();
+    ~EpollManager() override;
 
     EpollManager(const EpollManager&) = delete;
     EpollManager& operator=(const EpollManager&) = delete;
     EpollManager(EpollManager&&) = delete;
     EpollManager& operator=(EpollManager&&) = delete;
 
-    void addFd(int fd, uint32_t events) const;  // NOLINT(readability-identifier-length)
-    void modFd(int fd, uint32_t events) const;  // NOLINT(readability-identifier-length)
-    void delFd(int fd) const;                   // NOLINT(readability-identifier-length)
+    void addFd(int fd, uint32_t events, uint64_t data) const override;  // NOLINT(readability-identifier-length)
+    void modFd(int fd, uint32_t events, uint64_t data) const override;  // NOLINT(readability-identifier-length)
+    void delFd(int fd) const override;                                  // NOLINT(readability-identifier-length)
+
+    void addListener(const Listener& listener, uint64_t data) const override;
+    [[nodiscard]] int accept(const Listener& listener, Address& peer) const override;
+    [[nodiscard]] ssize_t receive(int fd, std::span<char> buffer) const override;  // NOLINT
+    [[nodiscard]] ssize_t send(int fd, std::span<const iovec> iov,  // NOLINT(readability-identifier-length)
+                               const std::shared_ptr<const void>& owner) const override;
+
+    [[nodiscard]] int wait(std::span<epoll_event> events, int timeout = -1) const override;
 
-    [[nodiscard]] int wait(std::span<epoll_event> events, int timeout = -1) const;
+    [[nodiscard]] std::string name() const override;
 
     [[nodiscard]] int getEpollFd() const;
 
@@ -0,0 +1,73 @@
+#ifndef CORE_EVENT_BACKEND_H
+#define CORE_EVENT_BACKEND_H
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+
+#include <sys/epoll.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+
+// 前向声明
+class Address;
+class Listener;
+class Logger;
+
+// 事件后端接口：以 epoll 事件掩码（EPOLLIN / EPOLLOUT / EPOLLET / EPOLLONESHOT ...）描述关注的事件，
+// 注册时附带的 data 在就绪事件的 epoll_event.data.u64 中原样返回。
+// 已注册 socket 上的 accept / 读 / 写都经由后端完成，io_uring 后端可以在内核中提前接受连接、接收数据并异步发送
+class EventBackend {
+public:
+    EventBackend() = default;
+    virtual ~EventBackend() = default;
+
+    EventBackend(const EventBackend&) = delete;
+    EventBackend& operator=(const EventBackend&) = delete;
+    EventBackend(EventBackend&&) = delete;
+    EventBackend& operator=(EventBackend&&) = delete;
+
+    virtual void addFd(int fd, uint32_t events, uint64_t data) const = 0;  // NOLINT(readability-identifier-length)
+    virtual void modFd(int fd, uint32_t events, uint64_t data) const = 0;  // NOLINT(readability-identifier-length)
+    virtual void delFd(int fd) const = 0;                                  // NOLINT(readability-identifier-length)
+
+    // 注册监听 socket（边缘触发的 EPOLLIN），新连接通过 accept() 取出
+    virtual void addListener(const Listener& listener, uint64_t data) const = 0;
+
+    // 接受一个新连接，语义同 Listener::accept()：没有待处理的连接时返回 -1 并置 errno 为 EAGAIN
+    [[nodiscard]] virtual int accept(const Listener& listener, Address& peer) const = 0;
+
+    // 读取已注册 socket 上的数据，语义同 recv()：对端关闭写方向时返回 0，暂无数据时返回 -1 并置 errno 为 EAGAIN
+    [[nodiscard]] virtual ssize_t receive(int fd, std::span<char> buffer) const = 0;  // NOLINT
+
+    // 发送数据，语义同 sendmsg()。返回 EAGAIN 时调用方以 EPOLLOUT 重新注册，事件到达后以相同的数据开头再次调用：
+    // io_uring 后端此时可能已把数据交给内核异步发送，再次调用返回的是这次异步发送的结果。
+    // owner 在异步发送完成前保持 iov 引用的数据有效
+    [[nodiscard]] virtual ssize_t send(int fd, std::span<const iovec> iov,  // NOLINT(readability-identifier-length)
+                                       const std::shared_ptr<const void>& owner) const = 0;
+
+    [[nodiscard]] virtual int wait(std::span<epoll_event> events, int timeout = -1) const = 0;
+
+    [[nodiscard]] virtual std::string name() const = 0;
+
+    // 按名称创建事件后端（epoll / io_uring），内核不支持 io_uring 所需的特性时回退到 epoll
+    [[nodiscard]] static std::unique_ptr<EventBackend> create(const std::string& name, Logger* logger);
+
+    // 事件数据的约定：低 32 位为 fd，高 32 位为代数。客户端连接的代数从 1 开始，用于识别 fd 复用前的过期事件；
+    // 监听 socket、eventfd 等固定使用代数 0
+    [[nodiscard]] static constexpr uint64_t eventData(const int fd, const uint32_t generation = 0) {  // NOLINT
+        return (static_cast<uint64_t>(generation) << GENERATION_SHIFT) | static_cast<uint32_t>(fd);
+    }
+    [[nodiscard]] static constexpr int eventFd(const uint64_t data) {
+        return static_cast<int>(static_cast<uint32_t>(data));
+    }
+    [[nodiscard]] static constexpr uint32_t eventGeneration(const uint64_t data) {
+        return static_cast<uint32_t>(data >> GENERATION_SHIFT);
+    }
+
+private:
+    static constexpr unsigned GENERATION_SHIFT = 32;
+};
+
+#endif  // CORE_EVENT_BACKEND_H
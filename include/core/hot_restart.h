@@ -0,0 +1,54 @@
+#ifndef CORE_HOT_RESTART_H
+#define CORE_HOT_RESTART_H
+
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <sys/types.h>
+
+#include "utils/file_descriptor.h"
+
+// 前向声明
+class Listener;
+class Logger;
+struct ListenAddress;
+
+// 热重启（零停机）：旧进程 fork + exec 磁盘上的可执行文件，监听 socket 以继承的文件描述符交给新进程；
+// 新进程开始 accept 后经管道通知旧进程，旧进程随后优雅关闭。交接期间两个进程共享同一个监听队列
+class HotRestart {
+public:
+    // 读取并清除环境变量中由旧进程传入的监听 socket 与就绪管道，并记录当前可执行文件的路径
+    explicit HotRestart(Logger* logger);
+
+    // 关闭未被取用的继承 socket；未通知就绪时旧进程会认为重启失败
+    ~HotRestart();
+
+    HotRestart(const HotRestart&) = delete;
+    HotRestart& operator=(const HotRestart&) = delete;
+    HotRestart(HotRestart&&) = delete;
+    HotRestart& operator=(HotRestart&&) = delete;
+
+    // 新进程：取出一个与 address 相同的继承 socket，没有时返回 -1
+    [[nodiscard]] int takeInherited(const ListenAddress& address);
+
+    // 新进程：已开始接受连接，关闭多余的继承 socket 并通知旧进程
+    void notifyReady();
+
+    // 旧进程：启动新进程并把 listeners 交给它，返回就绪管道的读端，失败时抛出 std::runtime_error
+    [[nodiscard]] FileDescriptor spawn(const std::vector<std::shared_ptr<Listener>>& listeners);
+
+    // 旧进程：就绪管道可读时调用，返回新进程是否已就绪；新进程启动失败时回收子进程
+    [[nodiscard]] bool checkReady(int ready_fd);
+
+private:
+    Logger* logger_;
+    std::filesystem::path executable_;          // 启动时的可执行文件路径，重启时执行该路径上的新文件
+    std::multimap<std::string, int> inherited_;  // 监听地址 -> 继承的 fd
+    int ready_fd_{-1};                           // 新进程：通知旧进程就绪的管道写端
+    pid_t child_{-1};                            // 旧进程：正在启动的新进程
+};
+
+#endif  // CORE_HOT_RESTART_H
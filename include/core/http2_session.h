@@ -0,0 +1,148 @@
+#ifndef CORE_HTTP2_SESSION_H
+#define CORE_HTTP2_SESSION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "core/address.h"
+#include "core/http_request.h"
+#include "core/http_response.h"
+#include "utils/hpack.h"
+
+// 前向声明
+class Logger;
+class ReadBuffer;
+class UploadFile;
+
+// 明文 HTTP/2（h2c）会话：负责分帧、HPACK、流量控制与多路复用，
+// 每个流的请求交给与 HTTP/1.x 相同的处理函数，响应写入连接的发送队列
+class Http2Session {
+public:
+    using RequestHandler = std::function<HttpResponse(const HttpRequest&)>;
+
+    // 请求头完整后、接收请求体前调用（请求体为空），返回响应表示提前拒绝该流
+    using RequestFilter = std::function<std::optional<HttpResponse>(const HttpRequest&)>;
+
+    // 请求头完整后调用，返回该流请求体的上限，0 表示不限制
+    using BodyLimit = std::function<size_t(const HttpRequest&)>;
+
+    // 请求头完整后调用，需要边接收边写入磁盘的流（上传）返回 UploadFile，其余返回空，请求体照常缓存后交给 handler
+    using UploadFactory = std::function<std::unique_ptr<UploadFile>(const HttpRequest&)>;
+
+    static constexpr std::string_view PREFACE = "PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n";
+
+    Http2Session(std::deque<BodySegment>& output, RequestHandler handler, RequestFilter filter, BodyLimit body_limit,
+                 UploadFactory upload_factory, Logger* logger, const Address& info);
+
+    ~Http2Session();
+
+    Http2Session(const Http2Session&) = delete;
+    Http2Session& operator=(const Http2Session&) = delete;
+    Http2Session(Http2Session&&) = delete;
+    Http2Session& operator=(Http2Session&&) = delete;
+
+    // 通过 Upgrade: h2c 建立会话：升级前的 HTTP/1.1 请求成为流 1，HTTP2-Settings 作为对端的初始设置
+    void upgrade(const HttpRequest& request, std::string_view settings);
+
+    // 消费缓冲区中所有完整的帧，返回 false 表示会话已结束（已发送 GOAWAY，或对端 GOAWAY 后已无活动流）
+    bool process(ReadBuffer& buffer);
+
+    // 在流量控制窗口允许的范围内为各流的响应体轮流生成 DATA 帧，返回是否有新数据入队
+    bool fillOutput();
+
+    // 优雅关闭：发送 GOAWAY(NO_ERROR) 并拒绝新流，已接受的流处理完毕后 process 返回 false
+    void shutdown();
+
+    // 没有未完成的流
+    [[nodiscard]] bool idle() const;
+
+private:
+    struct Stream {
+        std::string header_block;  // 尚未收齐 CONTINUATION 的头部块
+        HeaderList headers;
+        std::string body;
+        std::unique_ptr<UploadFile> upload;    // 流式上传：请求体到达即写入磁盘，不再缓存到 body
+        size_t body_received = 0;              // 已接收的请求体字节数
+        size_t body_limit = 0;                 // 请求体上限，0 表示不限制
+        std::optional<size_t> content_length;  // 声明的请求体长度，DATA 帧的总长度必须与之一致
+        bool headers_done = false;             // 请求头已完整
+        bool remote_closed = false;            // 已收到 END_STREAM
+        bool refused = false;                  // 超出并发上限，头部块解码后即拒绝
+        bool rejected = false;                 // 已提前响应，后续请求体直接丢弃
+        bool responded = false;                // 提前响应已发送完毕，等待对端停止发送请求体
+
+        std::deque<BodySegment> pending;  // 待发送的响应体
+        size_t pending_offset = 0;        // 队首内存片段已发送的字节数
+        bool done = false;                // 响应已随 END_STREAM 发送完毕，可以移除
+        int64_t send_window = 0;
+        int64_t recv_window = 0;
+    };
+
+    std::deque<BodySegment>& output_;
+    RequestHandler handler_;
+    RequestFilter filter_;
+    BodyLimit body_limit_;
+    UploadFactory upload_factory_;
+    Logger* logger_;
+    const Address& info_;
+
+    HpackDecoder decoder_;
+    std::map<uint32_t, Stream> streams_;  // 按流 ID 排序，发送时依次轮转
+    uint32_t last_stream_id_ = 0;         // 已接受的最大客户端流 ID
+    uint32_t continuation_stream_ = 0;    // 正在等待 CONTINUATION 的流
+
+    bool preface_sent_ = false;
+    bool preface_received_ = false;
+    bool settings_received_ = false;
+    bool goaway_sent_ = false;
+    bool goaway_received_ = false;
+    bool draining_ = false;  // 本端已发送 GOAWAY(NO_ERROR)，等待已接受的流结束
+
+    int64_t send_window_ = DEFAULT_WINDOW_SIZE;  // 连接级发送窗口
+    int64_t recv_window_ = CONNECTION_WINDOW_SIZE;
+    int64_t peer_initial_window_ = DEFAULT_WINDOW_SIZE;
+    size_t peer_max_frame_size_ = DEFAULT_MAX_FRAME_SIZE;
+
+    static constexpr int64_t DEFAULT_WINDOW_SIZE = 65535;
+    static constexpr int64_t MAX_WINDOW_SIZE = 0x7fffffff;
+    static constexpr int64_t CONNECTION_WINDOW_SIZE = 16 * 1024 * 1024;  // 本端连接级接收窗口
+    static constexpr int64_t STREAM_WINDOW_SIZE = 1024 * 1024;           // 本端流级接收窗口
+    static constexpr size_t DEFAULT_MAX_FRAME_SIZE = 16384;
+    static constexpr size_t MAX_CONCURRENT_STREAMS = 100;
+    static constexpr size_t MAX_FILL_BYTES = 256 * 1024;  // 单次 fillOutput 最多生成的 DATA 字节数
+
+    void handleFrame(uint8_t type, uint8_t flags, uint32_t stream_id, std::string_view payload);
+    void handleData(uint8_t flags, uint32_t stream_id, std::string_view payload);
+    void handleHeaders(uint8_t flags, uint32_t stream_id, std::string_view payload);
+    void handleContinuation(uint8_t flags, uint32_t stream_id, std::string_view payload);
+    void handleSettings(uint8_t flags, uint32_t stream_id, std::string_view payload);
+    void handleWindowUpdate(uint32_t stream_id, std::string_view payload);
+    void handleRstStream(uint32_t stream_id, std::string_view payload);
+    void handleGoAway(std::string_view payload);
+
+    void applySettings(std::string_view payload);
+    void finishHeaders(uint32_t stream_id, Stream& stream);
+    [[nodiscard]] bool precheck(uint32_t stream_id, Stream& stream);
+    void reject(uint32_t stream_id, Stream& stream, HttpResponse response);
+    void dispatch(uint32_t stream_id, Stream& stream);
+    void respond(uint32_t stream_id, Stream& stream, HttpResponse response);
+    static void finishStream(Stream& stream);
+    [[nodiscard]] HttpRequest buildRequest(const Stream& stream, std::string body) const;
+    [[nodiscard]] bool sendData(uint32_t stream_id, Stream& stream, size_t& bytes);
+
+    void sendPreface();
+    void queueFrame(uint8_t type, uint8_t flags, uint32_t stream_id, std::string_view payload = {});
+    void queueHeaders(uint32_t stream_id, const std::string& block, bool end_stream);
+    void queueWindowUpdate(uint32_t stream_id, uint32_t increment);
+    void resetStream(uint32_t stream_id, uint32_t error_code);
+    void goAway(uint32_t error_code, const std::string& reason);
+};
+
+#endif  // CORE_HTTP2_SESSION_H
@@ -0,0 +1,55 @@
+#ifndef CORE_HTTP_HEADER_H
+#define CORE_HTTP_HEADER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+// 常用的请求头与响应头，按名称字母序排列（也是响应头的输出顺序）
+enum class HttpHeader : std::uint8_t {
+    ACCEPT,
+    ACCEPT_ENCODING,
+    ACCEPT_RANGES,
+    AUTHORIZATION,
+    CACHE_CONTROL,
+    CONNECTION,
+    CONTENT_DISPOSITION,
+    CONTENT_LENGTH,
+    CONTENT_RANGE,
+    CONTENT_TYPE,
+    COOKIE,
+    DATE,
+    ETAG,
+    EXPECT,
+    HOST,
+    HTTP2_SETTINGS,
+    IF_MODIFIED_SINCE,
+    IF_NONE_MATCH,
+    IF_RANGE,
+    LAST_MODIFIED,
+    LOCATION,
+    RANGE,
+    REFERER,
+    RETRY_AFTER,
+    SET_COOKIE,
+    TRANSFER_ENCODING,
+    UPGRADE,
+    USER_AGENT,
+    COUNT,
+};
+
+inline constexpr size_t HTTP_HEADER_COUNT = static_cast<size_t>(HttpHeader::COUNT);
+
+class HttpHeaders {
+public:
+    // 按名称查找常用头部（不区分大小写），不在表中时返回空
+    [[nodiscard]] static std::optional<HttpHeader> find(std::string_view name);
+
+    // 规范大小写形式的名称，如 "Content-Length"
+    [[nodiscard]] static std::string_view name(HttpHeader header);
+
+    [[nodiscard]] static constexpr size_t index(const HttpHeader header) { return static_cast<size_t>(header); }
+};
+
+#endif  // CORE_HTTP_HEADER_H
@@ -1,46 +1,142 @@
 #ifndef CORE_HTTP_REQUEST_H
 #define CORE_HTTP_REQUEST_H
 
+#include <array>
 #include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory_resource>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <unordered_map>
+#include <vector>
 
+#include "core/http_header.h"
+
+// HTTP/1.1 请求解析器。请求行、请求头与请求体不复制，只记录在原始数据（连接的接收缓冲区）中的位置，
+// 访问时以 string_view 返回；接收缓冲区整理或扩大后数据会移动，每次调用 parse*() 都会重新绑定原始数据。
+// 返回的 string_view 在下一次 parse*() 或 reset() 之前，且原始数据未被修改时有效
 class HttpRequest {
 public:
-    HttpRequest() = default;
+    // 请求头位置表与自行保存的请求头从 resource 分配，默认为当前的请求内存池（见 RequestArena）；
+    // 连接长期持有的请求在请求作用域之外创建，使用默认分配器
+    HttpRequest();
+    explicit HttpRequest(std::pmr::memory_resource* resource);
+
+    // 由其他协议（如 HTTP/2）解码得到的请求，各部分由请求自行保存
+    [[nodiscard]] static HttpRequest fromParts(std::string_view method, std::string_view path,
+                                               std::string_view version,
+                                               const std::unordered_map<std::string, std::string>& headers,
+                                               std::string body);
+
+    // 可在数据到达后重复调用，从上次扫描停下的位置继续查找请求头结尾；返回 true 表示请求头已完整
+    bool parseHeader(std::string_view raw);
+    void parseBody(std::string_view raw);
+
+    // 增量解码 chunked 请求体，可在数据到达后重复调用；返回 true 表示请求体已完整
+    bool parseChunkedBody(std::string_view raw);
+
+    using BodySink = std::function<void(std::string_view data)>;
+
+    // 流式接收请求体前调用：把请求头复制到请求自身，之后原始数据中的请求头即可丢弃
+    void retainHeader();
 
-    bool parseHeader(const std::string& raw);
-    void parseBody(const std::string& raw);
+    // 流式接收请求体：raw 从尚未处理的请求体开始，解码后的数据依次交给 sink（不在请求中保存），
+    // 返回已处理的原始字节数；可在数据到达后重复调用
+    size_t streamBody(std::string_view raw, const BodySink& sink);
+
+    [[nodiscard]] bool isBodyComplete() const;
+
+    // 已解码的请求体字节数（parseChunkedBody() 与 streamBody()）
+    [[nodiscard]] size_t bodyReceived() const;
 
     [[nodiscard]] size_t totalExpectedLength() const;
 
-    [[nodiscard]] const std::string& method() const;
-    [[nodiscard]] const std::string& path() const;
-    [[nodiscard]] const std::string& version() const;
-    [[nodiscard]] const std::unordered_map<std::string, std::string>& headers() const;
-    [[nodiscard]] const std::string& body() const;
+    // 请求头（含结尾空行）的长度，以及 Content-Length 声明的请求体长度
+    [[nodiscard]] size_t headerLength() const;
+    [[nodiscard]] size_t contentLength() const;
+
+    [[nodiscard]] std::string_view method() const;
+    [[nodiscard]] std::string_view path() const;
+    [[nodiscard]] std::string_view version() const;
+    [[nodiscard]] std::string_view body() const;
+
+    // 按名称查找请求头（不区分大小写），同名字段以最后一个为准；常用头部直接按下标取得
+    [[nodiscard]] std::optional<std::string_view> getHeader(HttpHeader header) const;
+    [[nodiscard]] std::optional<std::string_view> getHeader(std::string_view key) const;
+
+    [[nodiscard]] std::optional<std::string_view> getBoundary() const;
 
-    [[nodiscard]] std::optional<std::string> getHeader(const std::string& key) const;
+    [[nodiscard]] bool keepAlive() const;
 
-    [[nodiscard]] std::optional<std::string> getBoundary() const;
+    // 是否携带 Expect: 100-continue
+    [[nodiscard]] bool expectsContinue() const;
 
     [[nodiscard]] bool isHeaderParsed() const;
 
+    [[nodiscard]] bool isChunked() const;
+
     void reset();
 
 private:
-    std::string method_;
-    std::string path_;
-    std::string version_;
-    std::unordered_map<std::string, std::string> headers_;
-    std::string body_;
+    // 原始数据中的一段
+    struct Field {
+        size_t offset{0};
+        size_t length{0};
+    };
+
+    struct Header {
+        Field name;
+        Field value;
+    };
+
+    std::string_view raw_;      // 最近一次 parse*() 传入的原始数据
+    std::pmr::string storage_;  // fromParts() 构造的请求自行保存的请求行与请求头
+
+    Field method_;
+    Field path_;
+    Field version_;
+    std::pmr::vector<Header> headers_;  // reset() 后保留容量，长连接上的后续请求不再分配
+    std::array<uint32_t, HTTP_HEADER_COUNT> known_headers_{};  // 常用头部在 headers_ 中的下标 + 1，0 表示未出现
+    Field body_field_;                  // Content-Length 请求体
+    std::string body_;                  // 解码后的 chunked 请求体，或由其他协议传入的请求体
 
     bool header_parsed_ = false;
+    size_t header_scan_pos_ = 0;  // 下次查找请求头结尾的起始位置
     size_t header_end_pos_ = std::string::npos;
     size_t content_length_ = 0;
 
-    static void trim(std::string& str);
+    enum class ChunkState : std::uint8_t {
+        SIZE,      // 等待分块大小行
+        DATA,      // 读取分块数据
+        DATA_END,  // 等待分块数据后的 CRLF
+        TRAILER,   // 读取尾部字段，直到空行
+        DONE,
+    };
+
+    bool chunked_ = false;
+    ChunkState chunk_state_ = ChunkState::SIZE;
+    size_t chunk_pos_ = 0;                     // 下一个待解码字节在原始数据中的位置
+    size_t chunk_remaining_ = 0;               // 当前分块剩余的数据长度
+    size_t body_end_pos_ = std::string::npos;  // chunked 请求体在原始数据中的结束位置
+    size_t body_received_ = 0;                 // 已解码的请求体字节数
+
+    static constexpr size_t MAX_CHUNK_LINE_LENGTH = 4096;
+
+    // 请求行与请求头所在的数据：fromParts() 构造时为 storage_，否则为 raw_
+    [[nodiscard]] std::string_view source() const;
+    [[nodiscard]] std::string_view view(Field field) const;
+
+    void parseRequestLine(std::string_view line);
+    void parseHeaderLine(std::string_view line, size_t offset);
+    void addHeader(Field name, Field value);
+    void parseFraming();
+
+    // 从 pos 开始解码分块，数据交给 sink，pos 前移到下一个待解码的字节；返回 true 表示请求体已完整
+    bool decodeChunks(std::string_view raw, size_t& pos, const BodySink& sink);
+
+    static std::string_view trim(std::string_view str);
 };
 
 #endif  // CORE_HTTP_REQUEST_H
@@ -1,24 +1,118 @@
 #ifndef CORE_HTTP_RESPONSE_H
 #define CORE_HTTP_RESPONSE_H
 
-#include <map>
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <sys/types.h>
+
+#include "core/http_header.h"
+
+// 前向声明
+class FileDescriptor;
+
+// 流式响应体生成器：每次调用向 chunk 写入下一段数据，返回 false 表示数据已全部生成
+using BodyProducer = std::function<bool(std::string& chunk)>;
+
+// 响应体片段：内存数据、通过 sendfile 发送的文件区间，或以 chunked 编码发送的生成器
+struct BodySegment {
+    std::string data{};                           // 内存数据（file 与 producer 为空时有效）
+    std::shared_ptr<const std::string> shared{};  // 共享的不可变内存数据（如缓存内容），不为空时代替 data
+    std::shared_ptr<FileDescriptor> file{};       // 文件描述符
+    off_t offset = 0;                             // 文件起始偏移
+    size_t length = 0;                            // 文件区间长度
+    BodyProducer producer{};                      // 生成器，长度未知
+
+    [[nodiscard]] std::string_view view() const { return shared ? std::string_view(*shared) : std::string_view(data); }
+    [[nodiscard]] size_t size() const { return file ? length : view().size(); }
+    [[nodiscard]] bool isData() const { return !file && !producer; }
+};
 
 class HttpResponse {
 public:
-    HttpResponse& setStatus(const std::string& status);
+    // 默认 Content-Type 为 application/octet-stream。状态行与响应头从 resource 分配，默认为当前的请求内存池；
+    // 响应体以 std::string 保存，发送时直接移入发送队列
+    HttpResponse();
+    explicit HttpResponse(std::pmr::memory_resource* resource);
+
+    // 复制构造使用默认分配器，可在请求结束后继续保存（如缓存）；需要复制到请求内存池时指定 resource
+    HttpResponse(const HttpResponse& other) = default;
+    HttpResponse(const HttpResponse& other, std::pmr::memory_resource* resource);
+    HttpResponse(HttpResponse&& other) noexcept = default;
+    HttpResponse& operator=(const HttpResponse& other) = default;
+    HttpResponse& operator=(HttpResponse&& other) = default;
+    ~HttpResponse() = default;
+
+    HttpResponse& setStatus(std::string_view status);
 
-    HttpResponse& setContentType(const std::string& type);
+    HttpResponse& setContentType(std::string_view type);
 
     HttpResponse& setBody(const std::string& body);
 
-    HttpResponse& addHeader(const std::string& key, const std::string& value);
+    // 以文件区间作为响应体，发送时由连接通过 sendfile 直接从文件描述符传输
+    HttpResponse& setFile(std::shared_ptr<FileDescriptor> file, off_t offset, size_t length);
+
+    // 追加响应体片段（用于 multipart/byteranges 等由内存与文件区间交替组成的响应体）
+    HttpResponse& appendData(std::string data);
+    HttpResponse& appendFile(std::shared_ptr<FileDescriptor> file, off_t offset, size_t length);
+
+    // 把内存响应体移入共享的不可变片段：之后复制响应只复制响应头，发送时也不再复制响应体（用于缓存）
+    HttpResponse& shareBody();
+
+    // 以生成器作为响应体，发送时按 chunked 编码边生成边发送
+    HttpResponse& setProducer(BodyProducer producer);
+
+    // 以生成器的输出替换模板占位符 {{key}}，占位符前后的内容作为首尾数据块一同流式发送；
+    // 替换推迟到 build() 时进行，因此之后仍可对其余占位符调用 renderTemplate()
+    HttpResponse& streamTemplate(std::string key, BodyProducer producer);
+
+    // 设置响应头，同名头部（不区分大小写）被替换；常用头部直接存入对应下标的槽位
+    HttpResponse& addHeader(HttpHeader header, std::string_view value);
+    HttpResponse& addHeader(std::string_view key, std::string_view value);
 
     HttpResponse& renderTemplate(std::string key, const std::string& value);
 
-    [[nodiscard]] std::string getContentType() const;
+    [[nodiscard]] std::optional<std::string_view> getHeader(HttpHeader header) const;
+
+    [[nodiscard]] std::string_view getContentType() const;
+
+    // build() 之后需要追加发送的响应体片段
+    [[nodiscard]] const std::vector<BodySegment>& segments() const;
+
+    [[nodiscard]] bool hasFileBody() const;
+
+    [[nodiscard]] bool isStreaming() const;
 
-    [[nodiscard]] std::string build();
+    [[nodiscard]] std::string_view status() const;
+
+    // 按输出顺序遍历响应头：先是常用头部（按名称字母序），再是其他头部（按设置顺序）
+    template <typename Func>
+    void forEachHeader(Func&& func) const {
+        for (size_t index = 0; index < HTTP_HEADER_COUNT; ++index) {
+            if (known_set_.test(index)) {
+                func(HttpHeaders::name(static_cast<HttpHeader>(index)),
+                     std::string_view(known_headers_[index]));  // NOLINT
+            }
+        }
+        for (const auto& [key, value] : other_headers_) {
+            func(std::string_view(key), std::string_view(value));
+        }
+    }
+
+    // 取出完整响应体（内存数据在前，随后是各片段），供 HTTP/2 等自行分帧的协议使用
+    [[nodiscard]] std::vector<BodySegment> takeBody();
+
+    // chunked 为 false 时（如 HTTP/1.0 客户端）生成器的输出将被完整收集后以 Content-Length 发送
+    [[nodiscard]] std::string build(bool keep_alive = false, bool chunked = true);
 
     [[nodiscard]] static HttpResponse responseError(int code, const std::string& tips = "");
 
@@ -28,11 +122,19 @@ public:
     [[nodiscard]] static HttpResponse responseRedirect(int code, const std::string& location);
 
 private:
-    std::string status_ = "200 OK";
+    std::pmr::string status_;
     std::string body_;
-    std::map<std::string, std::string> headers_ = {
-        {"Content-Type", "application/octet-stream"},
-    };
+    std::vector<BodySegment> segments_;
+    std::string stream_key_;
+    BodyProducer stream_producer_;
+    std::array<std::pmr::string, HTTP_HEADER_COUNT> known_headers_;  // 常用头部的值，按 HttpHeader 下标存放
+    std::bitset<HTTP_HEADER_COUNT> known_set_;                        // 已设置的常用头部
+    std::pmr::vector<std::pair<std::pmr::string, std::pmr::string>> other_headers_;
+
+    void removeHeader(HttpHeader header);
+
+    void applyStreamTemplate();
+    void collectProducers();
 };
 
 #endif  // CORE_HTTP_RESPONSE_H
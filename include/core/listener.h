@@ -0,0 +1,59 @@
+#ifndef CORE_LISTENER_H
+#define CORE_LISTENER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <sys/socket.h>
+
+// 前向声明
+class Address;
+class Logger;
+
+// 监听地址：纯端口、IPv4 地址:端口、[IPv6 地址]:端口，或 unix:/path 形式的 Unix 域 socket
+struct ListenAddress {
+    sa_family_t family = AF_INET;
+    std::string host = "0.0.0.0";  // IP 地址（family 为 AF_INET / AF_INET6 时有效）
+    uint16_t port = 0;
+    std::string path{};            // socket 文件路径（family 为 AF_UNIX 时有效）
+
+    [[nodiscard]] bool isUnix() const { return family == AF_UNIX; }
+    [[nodiscard]] std::string toString() const;
+
+    // 解析单个监听地址，格式错误时抛出 std::invalid_argument
+    [[nodiscard]] static ListenAddress parse(const std::string& spec);
+
+    // 解析以逗号分隔的多个监听地址
+    [[nodiscard]] static std::vector<ListenAddress> parseList(const std::string& specs);
+};
+
+// 非阻塞监听 socket，Unix 域 socket 的文件在析构时删除
+class Listener {
+public:
+    // inherited_fd 为热重启时从旧进程继承的监听 socket，不为 -1 时直接使用，不再重新绑定
+    Listener(ListenAddress address, bool reuse_port, Logger* logger, int inherited_fd = -1);
+    ~Listener();
+
+    Listener(const Listener&) = delete;
+    Listener& operator=(const Listener&) = delete;
+    Listener(Listener&&) = delete;
+    Listener& operator=(Listener&&) = delete;
+
+    [[nodiscard]] int fd() const;
+    [[nodiscard]] const ListenAddress& address() const;
+
+    // 接受一个新连接，返回的 socket 已设置为非阻塞；没有待处理的连接时返回 -1 并保留 errno
+    [[nodiscard]] int accept(Address& peer) const;
+
+    // 已交给热重启的新进程：析构时只关闭本进程的 fd，不删除 Unix 域 socket 文件
+    void handOff();
+
+private:
+    ListenAddress address_;
+    int listen_fd_{-1};
+    bool handed_off_{false};
+    Logger* logger_;
+};
+
+#endif  // CORE_LISTENER_H
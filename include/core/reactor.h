@@ -0,0 +1,109 @@
+#ifndef CORE_REACTOR_H
+#define CORE_REACTOR_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/admission_control.h"
+#include "core/connection.h"
+#include "core/connection_slab.h"
+#include "core/event_backend.h"
+#include "core/listener.h"
+#include "core/timer_wheel.h"
+
+// 前向声明
+class Logger;
+class ThreadPool;
+class StaticFile;
+class UserManager;
+
+// 事件循环：拥有独立的事件后端与连接表，连接在其整个生命周期内只属于一个 Reactor
+// TCP 监听 socket 每个 Reactor 各有一份（SO_REUSEPORT），Unix 域 socket 由所有 Reactor 共享
+class Reactor {
+public:
+    Reactor(size_t reactor_id, std::vector<std::shared_ptr<Listener>> listeners, const std::string& event_backend,
+            const ConnectionOptions& options, std::atomic<bool>& running, AdmissionControl* admission,
+            Logger* logger, ThreadPool* thread_pool, StaticFile* static_file, UserManager* user_manager);
+
+    ~Reactor();
+
+    Reactor(const Reactor&) = delete;
+    Reactor& operator=(const Reactor&) = delete;
+    Reactor(Reactor&&) = delete;
+    Reactor& operator=(Reactor&&) = delete;
+
+    // 事件循环，直到 running 被置为 false，或优雅关闭时所有连接已关闭 / 到达截止时间
+    void run();
+
+    // 唤醒阻塞在 epoll_wait 上的事件循环
+    void wakeup() const;
+
+    // 优雅关闭（可在任意线程调用）：停止接受新连接，等待现有连接发送完当前响应，最迟到 deadline 为止
+    void drain(TimerWheel::Clock::time_point deadline);
+
+private:
+    const size_t id_;                                   // Reactor 编号
+    std::vector<std::shared_ptr<Listener>> listeners_;  // 监听 socket
+    int wakeup_fd_{-1};                                 // 用于唤醒事件循环的 eventfd
+    const ConnectionOptions options_;                   // 连接选项
+    std::unique_ptr<EventBackend> event_backend_;       // 事件后端（epoll / io_uring）
+    std::atomic<bool>& running_;                        // 运行状态
+
+    ConnectionSlab connections_;  // 客户端连接表，按 fd 索引
+
+    TimerWheel timer_wheel_;  // 连接超时定时器，只在事件循环线程中访问
+
+    AdmissionControl* admission_;                // 连接准入控制（所有 Reactor 共享）
+    bool accept_paused_{false};                  // 资源耗尽时暂停 accept，退避后重试
+    std::chrono::milliseconds accept_backoff_;  // 下一次暂停的时长
+
+    std::atomic<bool> drain_requested_{false};                    // 已请求优雅关闭
+    std::atomic<TimerWheel::Clock::time_point> drain_deadline_{};  // 优雅关闭的截止时间
+    bool draining_{false};                                         // 已停止 accept，只在事件循环线程中访问
+
+    Logger* logger_;             // 日志
+    ThreadPool* thread_pool_;    // 线程池
+    StaticFile* static_file_;    // 静态文件目录
+    UserManager* user_manager_;  // 用户管理器
+
+    // 将监听 socket 与唤醒 eventfd 添加到事件后端
+    void setupEpoll();
+
+    // 处理新客户端连接
+    void handleNewConnection(const Listener& listener);
+
+    // 发送预先生成的 503 响应并关闭连接
+    void rejectConnection(int client_fd, const Address& client_addr, AdmissionControl::Rejection reason) const;
+
+    // fd 耗尽时借助预留 fd 接受积压的连接并逐个拒绝
+    void shedWithReserveFd(const Listener& listener) const;
+
+    // 暂停 accept 一段时间（指数退避），到期后重新接受所有监听 socket 上积压的连接
+    void pauseAccept(const std::string& reason);
+    void resumeAccept();
+
+    // 分发任务，event_data 中带有连接的 fd 与代数
+    void dispatchClient(uint64_t event_data, uint32_t events);
+
+    // 回收工作线程已请求关闭的连接
+    void reclaimConnections();
+
+    // 关闭监听 socket 并通知所有连接进入优雅关闭
+    void beginDrain();
+
+    // 所有连接已关闭或已到达截止时间
+    [[nodiscard]] bool drained();
+
+    // 按连接当前的截止时间添加超时定时器
+    void armTimeout(const std::shared_ptr<Connection>& conn);
+
+    // 定时器到期：截止时间已过则关闭连接，否则按新的截止时间重新添加
+    void checkTimeout(const std::weak_ptr<Connection>& weak_conn);
+};
+
+#endif  // CORE_REACTOR_H
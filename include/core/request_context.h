@@ -0,0 +1,47 @@
+#ifndef CORE_REQUEST_CONTEXT_H
+#define CORE_REQUEST_CONTEXT_H
+
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "utils/cookie_parser.h"
+
+// 前向声明
+class HttpRequest;
+class SessionManager;
+
+// 单个请求的处理上下文，每个请求创建一次，依次传给各处理函数。
+// Cookie 与会话在第一次用到时解析并缓存，同一请求中多次判断登录状态只解析一次 Cookie、只查询一次会话
+class RequestContext {
+public:
+    RequestContext(const HttpRequest& request, SessionManager* session_manager);
+
+    RequestContext(const RequestContext&) = delete;
+    RequestContext& operator=(const RequestContext&) = delete;
+    RequestContext(RequestContext&&) = delete;
+    RequestContext& operator=(RequestContext&&) = delete;
+    ~RequestContext() = default;
+
+    [[nodiscard]] const HttpRequest& request() const;
+
+    // 返回值指向请求头，在请求有效期间有效
+    [[nodiscard]] std::optional<std::string_view> cookie(std::string_view name) const;
+
+    [[nodiscard]] std::optional<std::string_view> sessionId() const;
+
+    // 会话对应的用户名；未携带 session_id 或会话已过期时为空
+    [[nodiscard]] const std::optional<std::string>& username() const;
+
+    [[nodiscard]] bool isLoggedIn() const;
+
+private:
+    const HttpRequest& request_;
+    SessionManager* session_manager_;
+
+    mutable std::optional<CookieParser::CookieList> cookies_;  // 尚未解析时为空
+    mutable bool session_resolved_ = false;
+    mutable std::optional<std::string> username_;
+};
+
+#endif  // CORE_REQUEST_CONTEXT_H
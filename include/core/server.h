@@ -1,29 +1,48 @@
 #ifndef CORE_SERVER_H
 #define CORE_SERVER_H
 
+#include <atomic>
+#include <chrono>
+#include <cstddef>
 #include <cstdint>
 #include <memory>
-#include <mutex>
-#include <unordered_map>
-
-#include <sys/types.h>
+#include <string>
+#include <vector>
 
+#include "core/admission_control.h"
 #include "core/connection.h"
 #include "core/epoll_manager.h"
+#include "core/hot_restart.h"
+#include "core/listener.h"
+#include "core/reactor.h"
+#include "utils/file_descriptor.h"
 
 // 前向声明
 class Logger;
+class SignalHandler;
 class ThreadPool;
 class StaticFile;
 class UserManager;
 
+struct ServerOptions {
+    std::vector<ListenAddress> listen = {{.port = DEFAULT_PORT}};  // 监听地址
+    size_t reactor_count = 1;              // Reactor 数量，大于 1 时 TCP 监听启用 SO_REUSEPORT
+    std::string event_backend = "epoll";   // 事件后端（epoll / io_uring）
+    size_t max_connections = DEFAULT_MAX_CONNECTIONS;  // 所有 Reactor 的连接总数上限，0 表示不限制
+    std::chrono::seconds shutdown_timeout{DEFAULT_SHUTDOWN_TIMEOUT};  // 收到退出信号后等待连接结束的最长时间
+
+    static constexpr uint16_t DEFAULT_PORT = 8080;
+    static constexpr size_t DEFAULT_MAX_CONNECTIONS = 10000;
+    static constexpr std::chrono::seconds DEFAULT_SHUTDOWN_TIMEOUT{30};
+};
+
 class Server {
 public:
-    // 构造函数：初始化服务器并指定监听端口
-    Server(uint16_t port, bool linger, std::atomic<bool>& running, Logger* logger, ThreadPool* thread_pool,
-           StaticFile* static_file, UserManager* user_manager);
+    // 构造函数：初始化服务器并按配置创建 Reactor
+    Server(const ServerOptions& server_options, const ConnectionOptions& options, const SignalHandler* signal_handler,
+           Logger* logger, ThreadPool* thread_pool, StaticFile* static_file, UserManager* user_manager);
 
-    // 析构函数：关闭 socket 与 epoll 相关资源
+    // 析构函数：关闭所有 Reactor 及其资源
     ~Server();
 
     Server(const Server&) = delete;
@@ -31,38 +50,39 @@ public:
     Server(Server&&) = delete;
     Server& operator=(Server&&) = delete;
 
-    // 启动服务器主循环，开始处理客户端请求
+    // 启动所有 Reactor 并在当前线程中等待信号：第一次收到退出信号时优雅关闭，再次收到时立即退出；
+    // SIGHUP 热重启：启动新进程并交出监听 socket，新进程就绪后本进程优雅关闭
     void run();
 
 private:
-    const uint16_t port_;         // 服务器监听端口
-    int listen_fd_{};             // 监听 socket 文件描述符
-    const bool linger_;           // 是否启用 linger 模式
-    EpollManager epoll_manager_;  // epoll 管理器
-    std::atomic<bool>& running_;  // 运行状态
+    const ServerOptions server_options_;    // 服务器选项
+    const SignalHandler* signal_handler_;  // 退出信号（signalfd）
+    std::atomic<bool> running_{true};       // 运行状态，置为 false 时 Reactor 立即退出
+    bool shutting_down_{false};             // 已开始优雅关闭
+    Logger* logger_;                        // 日志
+    ThreadPool* thread_pool_;               // 线程池
+
+    AdmissionControl admission_;  // 连接准入控制，生命周期长于所有 Reactor
 
-    std::unordered_map<int, std::shared_ptr<Connection>> connections_;  // 客户端连接列表
-    std::mutex connections_mutex_;
+    HotRestart hot_restart_;                           // 热重启，须在创建监听 socket 之前读取继承的 fd
+    std::vector<std::shared_ptr<Listener>> listeners_;  // 所有监听 socket，热重启时交给新进程
+    FileDescriptor restart_pipe_{-1};                   // 正在热重启时新进程的就绪管道
 
-    Logger* logger_;             // 日志
-    ThreadPool* thread_pool_;    // 线程池
-    StaticFile* static_file_;    // 静态文件目录
-    UserManager* user_manager_;  // 用户管理器
+    EpollManager control_;  // 主线程等待信号、Reactor 退出与热重启就绪通知
 
-    // 创建并配置 socket，绑定端口并监听连接
-    void setupSocket();
+    std::vector<std::unique_ptr<Reactor>> reactors_;  // 事件循环列表
 
-    // 创建 epoll 实例并添加监听 socket
-    void setupEpoll() const;
+    // 读取并处理所有待处理的信号
+    void handleSignals();
 
-    // 处理新客户端连接
-    void handleNewConnection();
+    // 优雅关闭：释放监听 socket，所有 Reactor 停止 accept 并等待连接结束
+    void beginShutdown();
 
-    // 分发任务
-    void dispatchClient(int client_fd, uint32_t events);
+    // 启动新进程并等待其就绪通知
+    void startHotRestart();
 
-    // 设置为非阻塞模式
-    static int setNonBlocking(int socket_fd);
+    // 就绪管道可读：新进程已就绪则交出监听 socket 并优雅关闭，否则继续服务
+    void finishHotRestart();
 };
 
 #endif  // CORE_SERVER_H
@@ -1,20 +1,37 @@
 #ifndef CORE_STATIC_FILE_H
 #define CORE_STATIC_FILE_H
 
+#include <atomic>
 #include <cctype>
+#include <chrono>
+#include <cstddef>
 #include <filesystem>
-#include <mutex>
+#include <functional>
+#include <memory>
 #include <optional>
+#include <shared_mutex>
 #include <string>
+#include <string_view>
 #include <unordered_map>
+#include <vector>
 
 #include "core/http_response.h"
+#include "utils/cancellation_token.h"
+#include "utils/string_hash.h"
 
 struct CacheEntry {
-    HttpResponse builder{};                         // 文件内容
+    std::shared_ptr<const HttpResponse> builder;    // 文件内容
     std::filesystem::file_time_type last_modified;  // 最后修改时间
 };
 
+// 快速路径索引的槽位：解码后的请求路径 -> 最近一次由工作线程确认未过期的缓存内容
+struct FastCacheEntry {
+    std::string url;
+    std::shared_ptr<const HttpResponse> builder;
+    std::chrono::steady_clock::time_point validated_at;  // 最近一次确认的时间
+    std::atomic<bool> referenced{false};                 // CLOCK 淘汰的访问位，命中时在共享锁下设置
+};
+
 enum class PageType : std::uint8_t {
     INDEX,   // 首页
     AUTH,    // 认证页面
@@ -26,14 +43,20 @@ enum class PageType : std::uint8_t {
 class Address;
 class Logger;
 class HttpRequest;
-class SessionManager;
+class RequestContext;
 
 class StaticFile {
 public:
     explicit StaticFile(const std::filesystem::path& root, const std::string& static_dir, std::string drive_dir,
-                        Logger* logger, SessionManager* session_manager);
+                        Logger* logger);
+
+    // cancel 被取消（客户端已断开）时抛出 OperationCancelled，不再继续生成响应
+    [[nodiscard]] HttpResponse serve(const RequestContext& context, const Address& info,
+                                     const CancellationToken& cancel = {}) const;
 
-    [[nodiscard]] HttpResponse serve(const HttpRequest& request, const Address& info) const;
+    // 事件循环线程的快速路径：url（忽略查询参数，解码后匹配）对应已缓存、无需渲染的静态资源，
+    // 且最近已确认未过期时返回其内容，否则返回空，由工作线程按 serve() 正常处理。不访问文件系统
+    [[nodiscard]] std::shared_ptr<const HttpResponse> findCached(std::string_view url) const;
 
     [[nodiscard]] std::string getDriveUrl() const;
     [[nodiscard]] std::filesystem::path getDrivePath() const;
@@ -48,25 +71,41 @@ private:
     const std::string drive_url_;                 // 网盘文件目录 URL
     const std::filesystem::path drive_path_;      // 网盘文件目录
     Logger* logger_;                              // 日志
-    SessionManager* session_manager_;             // 会话管理器
 
     mutable std::unordered_map<std::filesystem::path, CacheEntry> cache_;
-    mutable std::mutex cache_mutex_;
+    // 快速路径索引：路径 -> 槽位。槽位数量固定，用完后按 CLOCK 逐个淘汰
+    mutable std::unordered_map<std::string, size_t, StringHash, std::equal_to<>> fast_cache_;
+    mutable std::vector<FastCacheEntry> fast_cache_slots_;
+    mutable size_t fast_cache_used_{0};  // 已使用的槽位数
+    mutable size_t fast_cache_hand_{0};  // CLOCK 指针
+    mutable std::shared_mutex cache_mutex_;
 
-    [[nodiscard]] HttpResponse serveRaw(const HttpRequest& request, const Address& info, PageType& page_type) const;
+    [[nodiscard]] HttpResponse serveRaw(const HttpRequest& request, const Address& info, PageType& page_type,
+                                        const CancellationToken& cancel) const;
+
+    [[nodiscard]] HttpResponse serveFile(const std::filesystem::path& path, const HttpRequest& request,
+                                         const Address& info) const;
 
     [[nodiscard]] bool isPathSafe(const std::filesystem::path& path) const;
     [[nodiscard]] static bool isNameSafe(const std::string& name);
 
-    [[nodiscard]] std::optional<HttpResponse> readFromCache(const std::filesystem::path& path,
-                                                            const Address& info) const;
+    [[nodiscard]] std::shared_ptr<const HttpResponse> readFromCache(const std::filesystem::path& path,
+                                                                    const Address& info) const;
 
     [[nodiscard]] HttpResponse generateDirectoryListing(const std::filesystem::path& path,
-                                                        const std::string& request_path) const;
+                                                        const std::string& request_path,
+                                                        const CancellationToken& cancel) const;
+
+    [[nodiscard]] std::shared_ptr<const HttpResponse> updateCache(const std::filesystem::path& path,
+                                                                  HttpResponse builder) const;
+
+    // 记录刚确认未过期的缓存内容，供快速路径使用；path 为解码后的请求路径
+    void updateFastCache(std::string_view path, std::shared_ptr<const HttpResponse> builder) const;
 
-    void updateCache(const std::filesystem::path& path, const HttpResponse& builder) const;
+    // 槽位用完时按 CLOCK 淘汰一个最近未被访问的条目，返回空出的槽位。需持有 cache_mutex_ 独占锁
+    [[nodiscard]] size_t evictFastCache() const;
 
-    [[nodiscard]] HttpResponse render(HttpResponse builder, const HttpRequest& request, PageType page_type) const;
+    [[nodiscard]] HttpResponse render(HttpResponse builder, const RequestContext& context, PageType page_type) const;
 
     [[nodiscard]] std::optional<std::string> getTemplate(const std::string& name) const;
 };
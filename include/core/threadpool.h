@@ -1,8 +1,11 @@
 #ifndef CORE_THREADPOOL_H
 #define CORE_THREADPOOL_H
 
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <functional>
+#include <mutex>
 #include <queue>
 #include <thread>
 #include <vector>
@@ -12,8 +15,13 @@ class Logger;
 // 简单的线程池实现：用于将任务分发给固定数量的线程执行
 class ThreadPool {
 public:
+    static constexpr std::chrono::milliseconds DEFAULT_QUEUE_TARGET{50};
+    static constexpr std::chrono::milliseconds DEFAULT_QUEUE_INTERVAL{500};
+
     // 构造函数：创建指定数量的工作线程
-    explicit ThreadPool(size_t thread_count, Logger* logger);
+    // 任务排队时间持续 queue_interval 都高于 queue_target 时视为过载（CoDel），queue_target 为 0 时不检测
+    ThreadPool(size_t thread_count, Logger* logger, std::chrono::milliseconds queue_target = DEFAULT_QUEUE_TARGET,
+               std::chrono::milliseconds queue_interval = DEFAULT_QUEUE_INTERVAL);
 
     // 析构函数：停止所有线程并回收资源
     ~ThreadPool();
@@ -26,18 +34,45 @@ public:
     // 提交一个任务给线程池执行
     void enqueue(std::function<void()> task);
 
+    // 是否过载：过载期间新请求应直接拒绝，而不是继续排队。
+    // 按队首任务已等待的时间判断，所有工作线程都被慢请求占住、没有任务出队时同样能检测到
+    [[nodiscard]] bool overloaded();
+
+    // 等待队列中以及正在执行的任务全部完成
+    void waitIdle();
+
 private:
     std::vector<std::thread> workers_;  // 工作线程列表
     std::atomic<bool> stop_;
 
-    std::queue<std::function<void()>> tasks_;  // 任务队列
+    using Clock = std::chrono::steady_clock;
+
+    struct Task {
+        std::function<void()> function;
+        Clock::time_point enqueued;  // 入队时间，用于计算排队时间
+    };
+
+    std::queue<Task> tasks_;  // 任务队列
     std::mutex tasks_mutex_;
     std::condition_variable condition_;
+    std::condition_variable idle_condition_;  // 队列为空且没有正在执行的任务时通知
+    size_t active_{0};                        // 正在执行的任务数
+
+    const std::chrono::milliseconds queue_target_;    // 可接受的排队时间
+    const std::chrono::milliseconds queue_interval_;  // 排队时间持续超标多久视为过载
+    Clock::time_point above_target_since_{};          // 排队时间开始持续超标的时间
+    std::atomic<bool> overloaded_{false};
 
     Logger* logger_;  // 日志
 
     // 工作线程主循环函数
     void workerLoop(size_t thread_id);
+
+    // 根据排队时间更新过载状态，调用时需持有 tasks_mutex_
+    void updateOverload(Clock::duration sojourn);
+
+    // 根据队首任务已等待的时间更新过载状态，调用时需持有 tasks_mutex_
+    void updateOverloadFromHead();
 };
 
 #endif  // CORE_THREADPOOL_H
@@ -0,0 +1,61 @@
+#ifndef CORE_TIMER_WHEEL_H
+#define CORE_TIMER_WHEEL_H
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// 分层时间轮：4 层、每层 64 个槽，添加与到期均为 O(1)，高层槽位在低层转完一圈时向下迁移
+// 非线程安全，只由所属 Reactor 的事件循环线程访问
+class TimerWheel {
+public:
+    using Clock = std::chrono::steady_clock;
+    using Callback = std::function<void()>;
+
+    static constexpr std::chrono::milliseconds DEFAULT_TICK{100};  // 时间轮精度
+
+    explicit TimerWheel(std::chrono::milliseconds tick = DEFAULT_TICK, Clock::time_point now = Clock::now());
+
+    // 添加在 when 时刻到期的定时器，向上取整到整数个 tick（不会提前触发），回调在事件循环线程中执行
+    void add(Clock::time_point when, Callback callback);
+
+    // 推进到 now，依次执行所有到期定时器的回调（回调中可以继续添加定时器）
+    void advance(Clock::time_point now);
+
+    // 距离下一次可能有定时器到期的毫秒数，供 epoll_wait 使用；没有定时器时返回 -1
+    [[nodiscard]] int timeoutMs(Clock::time_point now) const;
+
+    [[nodiscard]] size_t size() const;
+
+private:
+    static constexpr size_t LEVELS = 4;
+    static constexpr size_t SLOT_BITS = 6;
+    static constexpr size_t SLOTS = 1U << SLOT_BITS;
+    static constexpr uint64_t SLOT_MASK = SLOTS - 1;
+    static constexpr uint64_t MAX_DELAY_TICKS = (uint64_t{1} << (SLOT_BITS * LEVELS)) - 1;
+
+    struct Timer {
+        uint64_t expire_tick;
+        Callback callback;
+    };
+
+    using Slot = std::vector<Timer>;
+
+    std::chrono::milliseconds tick_;
+    Clock::time_point start_;
+    uint64_t current_tick_{0};  // 已处理到的 tick
+    size_t size_{0};
+
+    std::array<std::array<Slot, SLOTS>, LEVELS> wheels_{};
+
+    // 按剩余 tick 数放入对应层的槽位
+    void place(Timer timer);
+
+    // 将第 level 层当前槽位的定时器重新分配到低层
+    void cascade(size_t level);
+};
+
+#endif  // CORE_TIMER_WHEEL_H
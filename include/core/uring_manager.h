@@ -0,0 +1,180 @@
+#ifndef CORE_URING_MANAGER_H
+#define CORE_URING_MANAGER_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <linux/io_uring.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+
+#include "core/event_backend.h"
+
+// 基于 io_uring 的事件后端：
+// - 监听 socket 使用多次触发的 accept，新连接在内核中接受后排队，accept() 直接取出；
+// - 客户端 socket 使用多次触发的 recv，数据写入内核从缓冲区环中选取的缓冲区，receive() 复制后立即归还，
+//   重新注册 EPOLLIN 只是修改标志，不再需要 epoll_ctl 与 recv 系统调用；
+// - 事件循环线程中的发送（缓存命中的快速路径）只写入提交队列，与等待合并为一次 io_uring_enter 批量提交；
+//   工作线程先直接 sendmsg，socket 缓冲区已满时交给内核在可写后异步发送，完成后以 EPOLLOUT 事件通知。
+// 就绪语义与 epoll 的 EPOLLONESHOT 相同：上报一次事件后禁用，直到 modFd 重新注册
+class UringManager final : public EventBackend {
+public:
+    // 内核不支持所需特性（多次触发的 recv 与缓冲区环需要 Linux 6.0）时抛出 std::runtime_error
+    explicit UringManager(unsigned entries = DEFAULT_ENTRIES);
+    ~UringManager() override;
+
+    UringManager(const UringManager&) = delete;
+    UringManager& operator=(const UringManager&) = delete;
+    UringManager(UringManager&&) = delete;
+    UringManager& operator=(UringManager&&) = delete;
+
+    void addFd(int fd, uint32_t events, uint64_t data) const override;  // NOLINT(readability-identifier-length)
+    void modFd(int fd, uint32_t events, uint64_t data) const override;  // NOLINT(readability-identifier-length)
+    void delFd(int fd) const override;                                  // NOLINT(readability-identifier-length)
+
+    void addListener(const Listener& listener, uint64_t data) const override;
+    [[nodiscard]] int accept(const Listener& listener, Address& peer) const override;
+    [[nodiscard]] ssize_t receive(int fd, std::span<char> buffer) const override;  // NOLINT
+    [[nodiscard]] ssize_t send(int fd, std::span<const iovec> iov,  // NOLINT(readability-identifier-length)
+                               const std::shared_ptr<const void>& owner) const override;
+
+    [[nodiscard]] int wait(std::span<epoll_event> events, int timeout = -1) const override;
+
+    [[nodiscard]] std::string name() const override;
+
+private:
+    static constexpr unsigned DEFAULT_ENTRIES = 4096;
+    static constexpr unsigned CQ_ENTRIES_FACTOR = 4;  // 完成队列相对提交队列的倍数（多次触发的请求产生多个 CQE）
+
+    static constexpr uint16_t BUFFER_GROUP = 0;
+    static constexpr unsigned BUFFER_COUNT = 256;     // 接收缓冲区数量，必须为 2 的幂
+    static constexpr size_t BUFFER_SIZE = 16 * 1024;  // 每个接收缓冲区的大小
+    static constexpr size_t MAX_HELD_BUFFERS = 8;     // 单个连接最多占用的接收缓冲区，超出时暂停接收
+
+    // 以 fd 为下标的状态表，与 ConnectionSlab 相同按块分配、之后不再移动
+    static constexpr size_t MAX_FDS = size_t{1} << 20;
+    static constexpr size_t CHUNK_SHIFT = 10;
+    static constexpr size_t CHUNK_SIZE = size_t{1} << CHUNK_SHIFT;
+    static constexpr size_t CHUNK_COUNT = MAX_FDS / CHUNK_SIZE;
+
+    enum class Kind : uint8_t { NONE, SOCKET, LISTENER, POLL };
+    enum class Op : uint8_t { IGNORED, RECV, SEND, POLL, ACCEPT };
+
+    // 已收到数据、尚未被 receive() 读完的缓冲区
+    struct HeldBuffer {
+        uint16_t id;
+        uint32_t offset;
+        uint32_t length;
+    };
+
+    struct FdState {
+        std::mutex mutex;
+        Kind kind{Kind::NONE};
+        uint64_t data{};       // 就绪事件中返回的数据
+        uint32_t events{};     // 关注的事件（EPOLLIN / EPOLLOUT）
+        bool enabled{false};  // 上报一次事件后禁用，直到 modFd 重新注册
+
+        std::deque<HeldBuffer> inbox;  // 按到达顺序排列的已收到数据
+        bool recv_active{false};       // recv 请求尚未终止
+        bool recv_paused{false};       // 占用的缓冲区过多，已取消 recv，读取后恢复
+        bool eof{false};               // 对端已关闭写方向
+        int error{0};                  // recv 失败的错误码
+
+        std::vector<iovec> send_iov;             // 异步发送的数据（引用 owner 持有的内存）
+        msghdr send_msg{};
+        std::shared_ptr<const void> send_owner;  // 异步发送完成前保持数据有效
+        bool send_active{false};                 // 异步发送尚未完成
+        bool send_done{false};                   // 异步发送已完成，结果由下一次 send() 返回
+        int send_result{0};
+        bool poll_active{false};                 // 等待可写的 poll 请求尚未完成
+
+        std::deque<int> accepted;     // 已接受、尚未取出的连接
+        bool accept_active{false};    // accept 请求尚未终止
+        bool accept_notified{false};  // 已上报 EPOLLIN，取空队列前不再重复上报
+        int accept_error{0};          // accept 失败的错误码，由下一次 accept() 返回
+    };
+
+    int ring_fd_{-1};
+
+    void* ring_ptr_{};       // SQ / CQ 共享映射
+    size_t ring_size_{};     // 共享映射大小
+    void* sqes_ptr_{};       // SQE 数组映射
+    size_t sqes_size_{};     // SQE 数组映射大小
+    unsigned sq_entries_{};  // SQ 容量
+
+    uint32_t* sq_head_{};
+    uint32_t* sq_tail_{};
+    uint32_t sq_mask_{};
+    io_uring_sqe* sqes_{};
+
+    uint32_t* cq_head_{};
+    uint32_t* cq_tail_{};
+    uint32_t cq_mask_{};
+    io_uring_cqe* cqes_{};
+
+    void* buffer_ring_ptr_{};  // 注册给内核的缓冲区环
+    char* buffers_{};          // 接收缓冲区
+    mutable uint16_t buffer_tail_{0};
+    mutable std::mutex buffer_mutex_;           // 归还缓冲区（任意线程）
+    mutable std::atomic<int> free_buffers_{0};  // 内核可用的缓冲区数量
+    mutable std::vector<std::pair<int, uint64_t>> starved_;  // 缓冲区耗尽而终止接收的 fd 与事件数据，只在事件循环线程中访问
+    mutable std::atomic<bool> starving_{false};              // 有连接在等待空闲缓冲区
+
+    mutable std::array<std::unique_ptr<FdState[]>, CHUNK_COUNT> states_;  // NOLINT(cppcoreguidelines-avoid-c-arrays)
+
+    mutable std::mutex sq_mutex_;                      // 写入提交队列（任意线程）
+    mutable std::atomic<std::thread::id> loop_thread_;  // 调用 wait() 的事件循环线程
+
+    mutable std::mutex events_mutex_;
+    mutable std::vector<epoll_event> pending_events_;  // 已就绪、尚未由 wait() 返回的事件
+    mutable bool waiting_{false};                      // 事件循环是否阻塞在 io_uring_enter 中
+
+    void setupRing(unsigned entries);
+    void setupBuffers();
+    void probe();
+    void release() noexcept;
+
+    // fd 对应的状态，addFd 时按需分配所在的块
+    [[nodiscard]] FdState& stateAt(int fd, bool allocate = false) const;  // NOLINT(readability-identifier-length)
+
+    [[nodiscard]] bool onLoopThread() const;
+
+    // 写入提交队列；事件循环线程中留待下一次 wait() 批量提交，其他线程（或 now 为 true 时）立即提交
+    void submit(const io_uring_sqe& sqe, bool now = false) const;
+    void enter() const;
+
+    void submitRecv(int fd, FdState& state) const;    // NOLINT(readability-identifier-length)
+    void submitAccept(int fd, FdState& state) const;  // NOLINT(readability-identifier-length)
+    void submitPoll(int fd, FdState& state, uint32_t events, bool multishot) const;  // NOLINT
+
+    // 把缓冲区归还给内核
+    void recycle(uint16_t buffer_id) const;
+    [[nodiscard]] char* bufferAt(uint16_t buffer_id) const;
+
+    // 记录就绪事件，由事件循环在下一次 wait() 中返回
+    void emit(const FdState& state, uint32_t events) const;
+
+    // 缓冲区恢复后重新开始因缓冲区耗尽而终止的接收
+    void rearmStarved() const;
+
+    void reap() const;
+    void handleCompletion(const io_uring_cqe& cqe) const;
+    void onRecv(int fd, FdState& state, const io_uring_cqe& cqe) const;  // NOLINT(readability-identifier-length)
+    void onAccept(FdState& state, const io_uring_cqe& cqe) const;
+    [[nodiscard]] std::shared_ptr<const void> onSend(FdState& state, const io_uring_cqe& cqe) const;
+    void onPoll(int fd, FdState& state, const io_uring_cqe& cqe) const;  // NOLINT(readability-identifier-length)
+
+    // user_data：高 8 位为操作，其后 24 位为代数的低位，低 32 位为 fd
+    [[nodiscard]] static uint64_t userData(Op op, int fd, uint64_t data);  // NOLINT(readability-identifier-length)
+};
+
+#endif  // CORE_URING_MANAGER_H
@@ -11,6 +11,7 @@ class Logger;
 class SessionManager;
 class HttpRequest;
 class HttpResponse;
+class RequestContext;
 
 class UserManager {
 public:
@@ -23,16 +24,16 @@ public:
     UserManager(UserManager&&) = delete;
     UserManager& operator=(UserManager&&) = delete;
 
-    [[nodiscard]] HttpResponse registerUser(const HttpRequest& request);
+    // 创建请求上下文，请求的会话通过本对象使用的会话管理器解析
+    [[nodiscard]] RequestContext createContext(const HttpRequest& request) const;
 
-    [[nodiscard]] HttpResponse loginUser(const HttpRequest& request);
+    [[nodiscard]] HttpResponse registerUser(const RequestContext& context);
 
-    [[nodiscard]] HttpResponse changePassword(const HttpRequest& request);
+    [[nodiscard]] HttpResponse loginUser(const RequestContext& context);
 
-    [[nodiscard]] HttpResponse logoutUser(const HttpRequest& request) const;
+    [[nodiscard]] HttpResponse changePassword(const RequestContext& context);
 
-    [[nodiscard]] bool isLoggedIn(const HttpRequest& request) const;
-    [[nodiscard]] bool isLoggedIn(const std::string& session_id) const;
+    [[nodiscard]] HttpResponse logoutUser(const RequestContext& context) const;
 
 private:
     size_t loadUsers();
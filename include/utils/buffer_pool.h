@@ -0,0 +1,42 @@
+#ifndef UTILS_BUFFER_POOL_H
+#define UTILS_BUFFER_POOL_H
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+// 按大小分级（4 KiB / 16 KiB / 64 KiB / 256 KiB / 1 MiB）的缓冲区池，分配时不初始化内容。
+// 空闲缓冲区缓存在各线程本地，取用与归还无需加锁；超过最大级别的缓冲区按 2 的幂分配，归还时直接释放
+class BufferPool {
+public:
+    struct Block {
+        std::unique_ptr<char[]> data;  // NOLINT(cppcoreguidelines-avoid-c-arrays)
+        size_t capacity{0};
+    };
+
+    // 取得容量不小于 min_size 的缓冲区；max_size 不为 0 时容量不超过 max_size（但不小于 min_size），
+    // 此时不在分级上的缓冲区直接分配，归还时释放
+    [[nodiscard]] static Block acquire(size_t min_size, size_t max_size = 0);
+
+    // 归还缓冲区，本线程缓存已满时直接释放
+    static void release(Block block);
+
+    // 容纳 min_size 所需的分级容量
+    [[nodiscard]] static size_t roundUp(size_t min_size);
+
+    static constexpr size_t MIN_BLOCK_SIZE = 4 * 1024;
+    static constexpr size_t MAX_POOLED_SIZE = 1024 * 1024;
+
+private:
+    static constexpr size_t CLASS_COUNT = 5;
+    static constexpr size_t CLASS_SHIFT = 2;                 // 相邻级别相差 4 倍
+    static constexpr size_t MAX_CACHED_BYTES = 1024 * 1024;  // 每个线程每个级别最多缓存的字节数
+
+    // 各级别的空闲缓冲区，随线程退出释放
+    static thread_local std::array<std::vector<std::unique_ptr<char[]>>, CLASS_COUNT> free_blocks_;  // NOLINT
+
+    [[nodiscard]] static size_t classIndex(size_t capacity);
+};
+
+#endif  // UTILS_BUFFER_POOL_H
@@ -0,0 +1,24 @@
+#ifndef UTILS_BYTE_SCANNER_H
+#define UTILS_BYTE_SCANNER_H
+
+#include <cstddef>
+#include <string_view>
+
+// 解析器共用的分隔符查找。x86-64 上按 CPU 支持情况在启动时选择 AVX2 或 SSE2 实现，其他平台使用标量实现。
+// 多字节分隔符先用向量比较同时筛选首、尾字节都匹配的位置，只对候选位置比较中间部分
+class ByteScanner {
+public:
+    // 从 pos 开始查找 needle，找不到时返回 std::string_view::npos
+    [[nodiscard]] static size_t find(std::string_view haystack, std::string_view needle, size_t pos = 0);
+
+    // 查找 "\r\n"
+    [[nodiscard]] static size_t findCrlf(std::string_view haystack, size_t pos = 0);
+
+    // 查找请求头结尾 "\r\n\r\n"
+    [[nodiscard]] static size_t findHeaderEnd(std::string_view haystack, size_t pos = 0);
+
+    // 当前使用的实现："avx2"、"sse2" 或 "scalar"
+    [[nodiscard]] static std::string_view implementation();
+};
+
+#endif  // UTILS_BYTE_SCANNER_H
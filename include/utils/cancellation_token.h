@@ -0,0 +1,47 @@
+#ifndef UTILS_CANCELLATION_TOKEN_H
+#define UTILS_CANCELLATION_TOKEN_H
+
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+
+// 请求已被放弃（客户端断开）时由耗时操作抛出，不再生成响应
+class OperationCancelled : public std::runtime_error {
+public:
+    OperationCancelled() : std::runtime_error("Operation cancelled.") {}
+};
+
+// 取消标记：副本共享同一状态，可在事件循环线程中取消、在工作线程中检查
+// 默认构造的标记不可取消，用于不需要取消的调用方
+class CancellationToken {
+public:
+    CancellationToken() = default;
+
+    [[nodiscard]] static CancellationToken create() {
+        CancellationToken token;
+        token.state_ = std::make_shared<std::atomic<bool>>(false);
+        return token;
+    }
+
+    void cancel() const {
+        if (state_) {
+            state_->store(true, std::memory_order_relaxed);
+        }
+    }
+
+    [[nodiscard]] bool cancelled() const {
+        return state_ && state_->load(std::memory_order_relaxed);
+    }
+
+    // 耗时循环中的检查点
+    void throwIfCancelled() const {
+        if (cancelled()) {
+            throw OperationCancelled();
+        }
+    }
+
+private:
+    std::shared_ptr<std::atomic<bool>> state_;
+};
+
+#endif  // UTILS_CANCELLATION_TOKEN_H
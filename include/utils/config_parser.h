@@ -40,23 +40,7 @@ public:
     template <typename T>
     T get(const std::string& key, const T& default_value) const;
 
-    LogLevel getLogLevel() const {
-        std::string value = get("log_level", std::string("INFO"));
-        if (value == "DEBUG") {
-            return LogLevel::DEBUG;
-        }
-        if (value == "INFO") {
-            return LogLevel::INFO;
-        }
-        if (value == "WARNING") {
-            return LogLevel::WARNING;
-        }
-        if (value == "ERROR") {
-            return LogLevel::ERROR;
-        }
-
-        return LogLevel::INFO;  // 默认值
-    }
+    LogLevel getLogLevel() const;
 
 private:
     std::unordered_map<std::string, std::string> config_map_;
@@ -86,4 +70,31 @@ inline bool ConfigParser::get<bool>(const std::string& key, const bool& default_
     return default_value;
 }
 
+// 字符串取整行值，允许包含空格（如以逗号分隔的 listen 列表）
+template <>
+inline std::string ConfigParser::get<std::string>(const std::string& key, const std::string& default_value) const {
+    if (const auto iter = config_map_.find(key); iter != config_map_.end()) {
+        return iter->second;
+    }
+    return default_value;
+}
+
+inline LogLevel ConfigParser::getLogLevel() const {
+    std::string value = get("log_level", std::string("INFO"));
+    if (value == "DEBUG") {
+        return LogLevel::DEBUG;
+    }
+    if (value == "INFO") {
+        return LogLevel::INFO;
+    }
+    if (value == "WARNING") {
+        return LogLevel::WARNING;
+    }
+    if (value == "ERROR") {
+        return LogLevel::ERROR;
+    }
+
+    return LogLevel::INFO;  // 默认值
+}
+
 #endif  // UTILS_CONFIG_PARSER_H
@@ -1,63 +1,61 @@
 #ifndef UTILS_COOKIE_PARSER_H
 #define UTILS_COOKIE_PARSER_H
 
+#include <memory_resource>
 #include <optional>
-#include <sstream>
-#include <string>
-#include <unordered_map>
+#include <ranges>
+#include <string_view>
+#include <utility>
+#include <vector>
 
-#include "core/http_request.h"
+#include "utils/request_arena.h"
 
+// 解析 Cookie 请求头，名称与值均指向原请求头，不复制；列表默认从当前的请求内存池分配
 class CookieParser {
 public:
-    static std::unordered_map<std::string, std::string> parse(const HttpRequest& request) {
-        auto cookie_header = request.getHeader("Cookie");
-        if (!cookie_header) {
-            return {};
-        }
-        return parse(*cookie_header);
-    }
+    using Cookie = std::pair<std::string_view, std::string_view>;
+    using CookieList = std::pmr::vector<Cookie>;
 
-    static std::unordered_map<std::string, std::string> parse(const std::string& cookie_header) {
-        std::unordered_map<std::string, std::string> cookies;
-        std::istringstream iss(cookie_header);
-        std::string pair;
+    static CookieList parse(std::string_view cookie_header,
+                            std::pmr::memory_resource* resource = RequestArena::resource()) {
+        CookieList cookies(resource);
 
-        while (std::getline(iss, pair, ';')) {
-            const auto pos = pair.find('=');
-            if (pos != std::string::npos) {
-                std::string key = pair.substr(0, pos);
-                std::string value = pair.substr(pos + 1);
-                trim(key);
-                trim(value);
+        while (!cookie_header.empty()) {
+            const size_t end = cookie_header.find(';');
+            const std::string_view pair = cookie_header.substr(0, end);
+            cookie_header.remove_prefix(end == std::string_view::npos ? cookie_header.size() : end + 1);
 
-                cookies[key] = value;
+            if (const auto pos = pair.find('='); pos != std::string_view::npos) {
+                cookies.emplace_back(trim(pair.substr(0, pos)), trim(pair.substr(pos + 1)));
             }
         }
 
         return cookies;
     }
 
-    static std::optional<std::string> get(const HttpRequest& request, const std::string& key) {
-        const auto cookies = parse(request);
-        if (const auto iter = cookies.find(key); iter != cookies.end()) {
-            return iter->second;
+    // 同名 Cookie 以最后一个为准
+    static std::optional<std::string_view> find(const CookieList& cookies, const std::string_view key) {
+        for (const auto& [name, value] : std::views::reverse(cookies)) {
+            if (name == key) {
+                return value;
+            }
         }
         return std::nullopt;
     }
 
-    static std::optional<std::string> get(const std::string& cookie_header, const std::string& key) {
-        const auto cookies = parse(cookie_header);
-        if (const auto iter = cookies.find(key); iter != cookies.end()) {
-            return iter->second;
-        }
-        return std::nullopt;
+    static std::optional<std::string_view> get(const std::string_view cookie_header, const std::string_view key) {
+        return find(parse(cookie_header), key);
     }
 
 private:
-    static void trim(std::string& str) {
-        str.erase(0, str.find_first_not_of(" \t"));
-        str.erase(str.find_last_not_of(" \t") + 1);
+    static std::string_view trim(std::string_view str) {
+        const size_t start = str.find_first_not_of(" \t");
+        if (start == std::string_view::npos) {
+            return {};
+        }
+        str.remove_prefix(start);
+        str.remove_suffix(str.size() - str.find_last_not_of(" \t") - 1);
+        return str;
     }
 };
 
@@ -0,0 +1,65 @@
+#ifndef UTILS_FILE_DESCRIPTOR_H
+#define UTILS_FILE_DESCRIPTOR_H
+
+#include <filesystem>
+#include <memory>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// RAII 封装的只读文件描述符
+class FileDescriptor {
+public:
+    explicit FileDescriptor(const int fd) : fd_(fd) {}  // NOLINT(readability-identifier-length)
+
+    ~FileDescriptor() {
+        if (fd_ != -1) {
+            close(fd_);
+        }
+    }
+
+    FileDescriptor(const FileDescriptor&) = delete;
+    FileDescriptor& operator=(const FileDescriptor&) = delete;
+    FileDescriptor(FileDescriptor&& other) noexcept : fd_(std::exchange(other.fd_, -1)) {}
+    FileDescriptor& operator=(FileDescriptor&& other) noexcept {
+        if (this != &other) {
+            if (fd_ != -1) {
+                close(fd_);
+            }
+            fd_ = std::exchange(other.fd_, -1);
+        }
+        return *this;
+    }
+
+    [[nodiscard]] int get() const { return fd_; }
+
+    [[nodiscard]] bool valid() const { return fd_ != -1; }
+
+    // 文件当前大小，失败时返回 -1
+    [[nodiscard]] off_t size() const {
+        struct stat file_stat {};
+        return fstat(fd_, &file_stat) == -1 ? -1 : file_stat.st_size;
+    }
+
+    // 以只读方式打开常规文件，失败时返回 nullptr
+    [[nodiscard]] static std::shared_ptr<FileDescriptor> openReadOnly(const std::filesystem::path& path) {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg)
+        auto file = std::make_shared<FileDescriptor>(open(path.c_str(), O_RDONLY | O_CLOEXEC));
+        if (!file->valid()) {
+            return nullptr;
+        }
+
+        struct stat file_stat {};
+        if (fstat(file->get(), &file_stat) == -1 || !S_ISREG(file_stat.st_mode)) {
+            return nullptr;
+        }
+        return file;
+    }
+
+private:
+    int fd_{-1};
+};
+
+#endif  // UTILS_FILE_DESCRIPTOR_H
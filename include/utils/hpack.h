@@ -0,0 +1,55 @@
+#ifndef UTILS_HPACK_H
+#define UTILS_HPACK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// HTTP/2 头部压缩（RFC 7541）
+using HeaderField = std::pair<std::string, std::string>;
+using HeaderList = std::vector<HeaderField>;
+
+// 解码器：维护对端编码器同步的动态表，支持 Huffman 编码的字符串
+// 头部块格式错误时抛出 std::invalid_argument，调用方应以 COMPRESSION_ERROR 关闭连接
+class HpackDecoder {
+public:
+    static constexpr size_t DEFAULT_TABLE_SIZE = 4096;
+    static constexpr size_t DEFAULT_MAX_HEADER_LIST_SIZE = 64 * 1024;
+
+    explicit HpackDecoder(size_t max_table_size = DEFAULT_TABLE_SIZE,
+                          size_t max_header_list_size = DEFAULT_MAX_HEADER_LIST_SIZE);
+
+    [[nodiscard]] HeaderList decode(std::string_view block);
+
+private:
+    size_t max_table_size_;        // SETTINGS_HEADER_TABLE_SIZE，动态表大小更新不得超过该值
+    size_t table_size_limit_;      // 对端通过动态表大小更新指定的当前上限
+    size_t max_header_list_size_;  // 解码后头部列表的最大大小
+
+    std::deque<HeaderField> dynamic_table_;  // 新条目位于队首
+    size_t dynamic_table_size_ = 0;
+
+    [[nodiscard]] const HeaderField& lookup(uint64_t index) const;
+    void insert(HeaderField field);
+    void evict(size_t limit);
+
+    [[nodiscard]] static uint64_t decodeInteger(std::string_view block, size_t& pos, int prefix_bits);
+    [[nodiscard]] static std::string decodeString(std::string_view block, size_t& pos);
+    [[nodiscard]] static std::string decodeHuffman(std::string_view data);
+};
+
+// 编码器：不使用动态表，名称尽量引用静态表，值以原始字面量发送
+class HpackEncoder {
+public:
+    [[nodiscard]] static std::string encode(const HeaderList& headers);
+
+private:
+    static void encodeInteger(std::string& out, uint64_t value, int prefix_bits, uint8_t flags);
+    static void encodeString(std::string& out, std::string_view str);
+};
+
+#endif  // UTILS_HPACK_H
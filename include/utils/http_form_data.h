@@ -1,27 +1,37 @@
 #ifndef UTILS_HTTP_FORM_DATA_H
 #define UTILS_HTTP_FORM_DATA_H
 
+#include <functional>
 #include <initializer_list>
+#include <memory_resource>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 
+#include "utils/request_arena.h"
+#include "utils/string_hash.h"
+
 // 前向声明
 class HttpResponse;
 
+// application/x-www-form-urlencoded 表单，字段默认从当前的请求内存池分配
 class HttpFormData {
 public:
+    using FieldMap = std::pmr::unordered_map<std::pmr::string, std::pmr::string, StringHash, std::equal_to<>>;
+
     HttpFormData() = default;
 
-    explicit HttpFormData(const std::string& body);
+    explicit HttpFormData(std::string_view body, std::pmr::memory_resource* resource = RequestArena::resource());
 
-    [[nodiscard]] static std::unordered_map<std::string, std::string> parse(const std::string& body);
+    [[nodiscard]] static FieldMap parse(std::string_view body,
+                                        std::pmr::memory_resource* resource = RequestArena::resource());
 
-    [[nodiscard]] std::optional<std::string> get(const std::string& key) const;
+    [[nodiscard]] std::optional<std::string> get(std::string_view key) const;
 
-    bool contains(const std::string& key) const;
+    bool contains(std::string_view key) const;
 
-    [[nodiscard]] const std::unordered_map<std::string, std::string>& getData() const;
+    [[nodiscard]] const FieldMap& getData() const;
 
     [[nodiscard]] size_t size() const;
 
@@ -32,7 +42,7 @@ public:
     [[nodiscard]] std::optional<HttpResponse> check(const std::initializer_list<std::string>& required_fields) const;
 
 private:
-    std::unordered_map<std::string, std::string> data_;
+    FieldMap data_;
 };
 
 #endif  // UTILS_HTTP_FORM_DATA_H
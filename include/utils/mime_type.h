@@ -1,13 +1,17 @@
 #ifndef UTILS_MIME_TYPE_H
 #define UTILS_MIME_TYPE_H
 
-#include <algorithm>
+#include <array>
+#include <cstddef>
 #include <filesystem>
 #include <string>
-#include <unordered_map>
+#include <string_view>
+#include <utility>
+
+#include "utils/perfect_hash.h"
 
 namespace detail {
-    inline const std::unordered_map<std::string_view, std::string> MIME_MAP = {
+    inline constexpr std::array<std::pair<std::string_view, std::string_view>, 27> MIME_MAP = {{
         {".html", "text/html; charset=UTF-8"},
         {".htm", "text/html; charset=UTF-8"},
         {".css", "text/css; charset=UTF-8"},
@@ -35,14 +39,21 @@ namespace detail {
         {".ttf", "font/ttf"},
         {".otf", "font/otf"},
         {".eot", "application/vnd.ms-fontobject"},
-    };
+    }};
 
-    [[nodiscard]] inline std::string getMime(const std::filesystem::path& path) {
-        std::string ext = path.extension().string();
-        std::ranges::transform(ext, ext.begin(), tolower);
+    inline constexpr PerfectHash<MIME_MAP.size()> MIME_TABLE = [] {
+        std::array<std::string_view, MIME_MAP.size()> extensions{};
+        for (size_t index = 0; index < MIME_MAP.size(); ++index) {
+            extensions[index] = MIME_MAP[index].first;
+        }
+        return PerfectHash<MIME_MAP.size()>(extensions);
+    }();
 
-        if (const auto mime_iter = MIME_MAP.find(ext); mime_iter != MIME_MAP.end()) {
-            return mime_iter->second;
+    // 扩展名不区分大小写，查找时无需转换为小写副本
+    [[nodiscard]] inline std::string_view getMime(const std::filesystem::path& path) {
+        const std::string ext = path.extension().string();
+        if (const auto index = MIME_TABLE.find(ext)) {
+            return MIME_MAP[*index].second;
         }
         return "application/octet-stream";
     }
@@ -50,7 +61,7 @@ namespace detail {
 
 class MimeType {
 public:
-    [[nodiscard]] static std::string get(const std::filesystem::path& path) { return detail::getMime(path); }
+    [[nodiscard]] static std::string_view get(const std::filesystem::path& path) { return detail::getMime(path); }
 };
 
 #endif  // UTILS_MIME_TYPE_H
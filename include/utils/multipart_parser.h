@@ -1,44 +1,76 @@
 #ifndef UTILS_MULTIPART_PARSER_H
 #define UTILS_MULTIPART_PARSER_H
 
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <string>
-#include <unordered_map>
-#include <vector>
+#include <string_view>
 
-struct FormField {
-    std::string name;
-    std::string value;
-};
-
-struct UploadedFile {
-    std::string field_name;
-    std::string filename;
-    std::string content_type;
-    std::string data;
+// multipart/form-data 各部分的头部信息
+struct MultipartPart {
+    std::string name;          // 表单字段名
+    std::string filename;      // 文件名，普通表单字段为空
+    std::string content_type = "application/octet-stream";  // 未声明时的默认值
 };
 
+// 推送式 multipart/form-data 解析器：请求体按到达顺序分段送入 feed()，各部分的数据解析后立即交给回调，
+// 解析器只保留可能跨越两段数据的分隔符前缀与部分头部，内存占用与请求体大小无关
 class MultipartParser {
 public:
-    MultipartParser(std::string body, std::string boundary);
+    struct Handler {
+        std::function<void(const MultipartPart& part)> on_part_begin;
+        std::function<void(std::string_view data)> on_part_data;  // 同一部分的数据可能分多次回调
+        std::function<void()> on_part_end;
+    };
+
+    MultipartParser(std::string_view boundary, Handler handler);
+
+    // 送入下一段请求体，格式错误时抛出 std::invalid_argument
+    void feed(std::string_view data);
 
-    [[nodiscard]] const std::vector<FormField>& fields() const;
-    [[nodiscard]] const std::vector<UploadedFile>& files() const;
+    // 是否已读到结束分隔符
+    [[nodiscard]] bool finished() const;
+
+    // 是否正处于某个部分的数据中（请求体不完整时调用方据此清理）
+    [[nodiscard]] bool inPart() const;
 
 private:
-    std::string body_;
-    std::string boundary_;
+    enum class State : std::uint8_t {
+        PREAMBLE,       // 第一个分隔符之前的内容，忽略
+        BOUNDARY_TAIL,  // 分隔符之后，等待 CRLF（下一部分）或 "--"（结束）
+        HEADERS,        // 部分头部，直到空行
+        DATA,           // 部分数据，直到下一个分隔符
+        END,            // 结束分隔符之后的内容，忽略
+    };
+
+    enum class TailState : std::uint8_t {
+        START,
+        DASH,  // 已读到一个 '-'
+        CR,    // 已读到 '\r'
+    };
+
+    static constexpr size_t MAX_PART_HEADER_SIZE = 8192;
 
-    mutable std::unordered_map<std::string, std::string> headers_;
-    mutable std::vector<FormField> fields_;
-    mutable std::vector<UploadedFile> files_;
+    std::string delimiter_;  // "\r\n--" + boundary
+    Handler handler_;
+    State state_ = State::PREAMBLE;
+    TailState tail_state_ = TailState::START;
 
-    void parse() const;
+    // PREAMBLE / DATA：上一段末尾可能是分隔符前缀的数据（少于分隔符长度）；HEADERS：已接收的部分头部
+    std::string carry_;
+    std::string probe_;  // 拼接 carry_ 与新数据开头，检查跨越两段数据的分隔符
 
-    void parseHeaders(const std::string& headers) const;
+    [[nodiscard]] std::string_view scanBody(std::string_view data);
+    [[nodiscard]] std::string_view scanBoundaryTail(std::string_view data);
+    [[nodiscard]] std::string_view scanHeaders(std::string_view data);
 
-    static std::string getHeaderValue(const std::string& header, const std::string& key);
+    void emit(std::string_view data) const;
+    void onDelimiter();
 
-    static void trim(std::string& str);
+    [[nodiscard]] static MultipartPart parseHeaders(std::string_view headers);
+    [[nodiscard]] static std::string getParameter(std::string_view header, std::string_view key);
+    [[nodiscard]] static std::string_view trim(std::string_view str);
 };
 
 #endif  // UTILS_MULTIPART_PARSER_H
@@ -0,0 +1,90 @@
+#ifndef UTILS_PERFECT_HASH_H
+#define UTILS_PERFECT_HASH_H
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+// 固定字符串集合的完美哈希表（不区分 ASCII 大小写），需以 constexpr 变量构造。
+// 编译期寻找使所有键互不冲突的哈希种子，查找时只需计算一次哈希、比较一次字符串，不分配内存
+template <size_t N>
+class PerfectHash {
+public:
+    static_assert(N > 0 && N < UINT8_MAX, "slot index must fit in uint8_t");
+
+    constexpr explicit PerfectHash(const std::array<std::string_view, N>& keys) : keys_(keys) {
+        for (uint32_t seed = 0; seed < MAX_SEED; ++seed) {
+            if (tryBuild(seed)) {
+                return;
+            }
+        }
+        throw "no collision-free seed found";  // NOLINT(hicpp-exception-baseclass) 编译期失败
+    }
+
+    // 返回键在构造时数组中的下标
+    [[nodiscard]] constexpr std::optional<size_t> find(const std::string_view key) const {
+        const uint8_t slot = slots_[hash(key, seed_) & (TABLE_SIZE - 1)];
+        if (slot == 0 || !equalsIgnoreCase(keys_[slot - 1], key)) {
+            return std::nullopt;
+        }
+        return slot - 1;
+    }
+
+    [[nodiscard]] constexpr std::string_view key(const size_t index) const { return keys_[index]; }
+
+    [[nodiscard]] static constexpr char toLower(const char chr) {
+        return chr >= 'A' && chr <= 'Z' ? static_cast<char>(chr - 'A' + 'a') : chr;
+    }
+
+    [[nodiscard]] static constexpr bool equalsIgnoreCase(const std::string_view lhs, const std::string_view rhs) {
+        if (lhs.size() != rhs.size()) {
+            return false;
+        }
+        for (size_t index = 0; index < lhs.size(); ++index) {
+            if (toLower(lhs[index]) != toLower(rhs[index])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    static constexpr size_t TABLE_SIZE = std::bit_ceil(N * 4);  // 装载率不超过 1/4，容易找到无冲突的种子
+    static constexpr uint32_t MAX_SEED = 1 << 16;
+
+    std::array<std::string_view, N> keys_;
+    std::array<uint8_t, TABLE_SIZE> slots_{};  // 键下标 + 1，0 表示空槽
+    uint32_t seed_{0};
+
+    // FNV-1a，按小写字母计算
+    [[nodiscard]] static constexpr uint32_t hash(const std::string_view key, const uint32_t seed) {
+        constexpr uint32_t offset_basis = 2166136261U;
+        constexpr uint32_t prime = 16777619U;
+        constexpr uint32_t fold_shift = 15;
+
+        uint32_t value = offset_basis ^ seed;
+        for (const char chr : key) {
+            value ^= static_cast<uint8_t>(toLower(chr));
+            value *= prime;
+        }
+        return value ^ (value >> fold_shift);
+    }
+
+    constexpr bool tryBuild(const uint32_t seed) {
+        slots_ = {};
+        for (size_t index = 0; index < N; ++index) {
+            uint8_t& slot = slots_[hash(keys_[index], seed) & (TABLE_SIZE - 1)];
+            if (slot != 0) {
+                return false;
+            }
+            slot = static_cast<uint8_t>(index + 1);
+        }
+        seed_ = seed;
+        return true;
+    }
+};
+
+#endif  // UTILS_PERFECT_HASH_H
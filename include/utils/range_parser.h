@@ -0,0 +1,165 @@
+#ifndef UTILS_RANGE_PARSER_H
+#define UTILS_RANGE_PARSER_H
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+struct ByteRange {
+    uint64_t first;  // 起始字节（含）
+    uint64_t last;   // 结束字节（含）
+
+    [[nodiscard]] uint64_t length() const { return last - first + 1; }
+};
+
+class RangeParser {
+public:
+    // 解析 Range 请求头（仅支持 bytes 单位）
+    // 重叠或相邻的范围按起始位置排序后合并；
+    // 返回 std::nullopt 表示语法无效、范围过多或明显是放大攻击，应忽略 Range 并返回完整内容；
+    // 返回空列表表示所有范围均不可满足，应返回 416
+    [[nodiscard]] static std::optional<std::vector<ByteRange>> parse(std::string_view header, const uint64_t size) {
+        constexpr std::string_view unit = "bytes=";
+        if (!header.starts_with(unit)) {
+            return std::nullopt;
+        }
+        header.remove_prefix(unit.size());
+
+        std::vector<ByteRange> ranges;
+        size_t spec_count = 0;
+        while (!header.empty()) {
+            const size_t comma = header.find(',');
+            std::string_view spec = trim(header.substr(0, comma));
+            header = comma == std::string_view::npos ? std::string_view{} : header.substr(comma + 1);
+
+            if (spec.empty()) {
+                continue;
+            }
+            if (++spec_count > MAX_RANGES) {
+                return std::nullopt;
+            }
+
+            const size_t dash = spec.find('-');
+            if (dash == std::string_view::npos) {
+                return std::nullopt;
+            }
+
+            const std::string_view first_str = spec.substr(0, dash);
+            const std::string_view last_str = spec.substr(dash + 1);
+
+            if (first_str.empty()) {
+                // 后缀范围：-N 表示最后 N 个字节
+                const auto suffix = toNumber(last_str);
+                if (!suffix) {
+                    return std::nullopt;
+                }
+                if (*suffix > 0 && size > 0) {
+                    ranges.push_back({.first = size - std::min(*suffix, size), .last = size - 1});
+                }
+                continue;
+            }
+
+            const auto first = toNumber(first_str);
+            if (!first) {
+                return std::nullopt;
+            }
+
+            uint64_t last = size == 0 ? 0 : size - 1;
+            if (!last_str.empty()) {
+                const auto parsed_last = toNumber(last_str);
+                if (!parsed_last || *parsed_last < *first) {
+                    return std::nullopt;
+                }
+                last = std::min(*parsed_last, last);
+            }
+
+            if (*first < size) {
+                ranges.push_back({.first = *first, .last = last});
+            }
+        }
+
+        if (spec_count == 0) {
+            return std::nullopt;
+        }
+        return coalesce(std::move(ranges), size);
+    }
+
+    // 比较 If-Range 条件：强 ETag 需完全一致，日期需与 Last-Modified 完全一致
+    [[nodiscard]] static bool ifRangeMatches(const std::string_view if_range, const std::string_view etag,
+                                             const std::string_view last_modified) {
+        if (if_range.starts_with("W/")) {
+            return false;  // 弱 ETag 不能用于范围请求
+        }
+        if (if_range.starts_with('"')) {
+            return if_range == etag;
+        }
+        return if_range == last_modified;
+    }
+
+private:
+    static constexpr size_t MAX_RANGES = 16;           // 单个请求最多允许的范围数
+    static constexpr size_t MAX_SMALL_RANGES = 2;      // 合并后超过该数量时要求每段的平均长度不小于 MIN_RANGE_LENGTH
+    static constexpr uint64_t MIN_RANGE_LENGTH = 256;  // multipart 每段的头部约 100 字节，过小的分段开销大于数据本身
+
+    // 合并重叠或相邻的范围；请求的总字节数超过文件大小（大量重叠）或合并后仍是大量小分段时返回 std::nullopt
+    [[nodiscard]] static std::optional<std::vector<ByteRange>> coalesce(std::vector<ByteRange> ranges,
+                                                                        const uint64_t size) {
+        if (ranges.size() <= 1) {
+            return ranges;
+        }
+
+        uint64_t requested = 0;
+        for (const auto& range : ranges) {
+            requested += range.length();
+        }
+        if (requested > size) {
+            return std::nullopt;
+        }
+
+        std::ranges::sort(ranges, {}, &ByteRange::first);
+        std::vector<ByteRange> merged;
+        merged.reserve(ranges.size());
+        for (const auto& range : ranges) {
+            if (!merged.empty() && range.first <= merged.back().last + 1) {
+                merged.back().last = std::max(merged.back().last, range.last);
+            } else {
+                merged.push_back(range);
+            }
+        }
+
+        uint64_t total = 0;
+        for (const auto& range : merged) {
+            total += range.length();
+        }
+        if (merged.size() > MAX_SMALL_RANGES && total < merged.size() * MIN_RANGE_LENGTH) {
+            return std::nullopt;
+        }
+        return merged;
+    }
+
+    [[nodiscard]] static std::string_view trim(std::string_view str) {
+        const size_t start = str.find_first_not_of(" \t");
+        if (start == std::string_view::npos) {
+            return {};
+        }
+        const size_t end = str.find_last_not_of(" \t");
+        return str.substr(start, end - start + 1);
+    }
+
+    [[nodiscard]] static std::optional<uint64_t> toNumber(const std::string_view str) {
+        uint64_t value = 0;
+        const auto [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), value);
+        if (ec != std::errc{} || ptr != str.data() + str.size() || str.empty()) {
+            return std::nullopt;
+        }
+        return value;
+    }
+};
+
+#endif  // UTILS_RANGE_PARSER_H
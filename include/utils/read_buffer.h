@@ -0,0 +1,55 @@
+#ifndef UTILS_READ_BUFFER_H
+#define UTILS_READ_BUFFER_H
+
+#include <cstddef>
+#include <span>
+#include <string_view>
+
+#include "utils/buffer_pool.h"
+
+// 连接的接收缓冲区：recv 直接写入尾部的空闲空间，已处理的数据从头部丢弃（只移动偏移）。
+// 存储从 BufferPool 取得，不够时按级别扩大（不超过上限）；清空后可归还，等待下一个请求的长连接不占用缓冲区
+class ReadBuffer {
+public:
+    // limit 为缓冲区最多保存的字节数，0 表示不限制
+    explicit ReadBuffer(size_t limit = 0);
+    ~ReadBuffer();
+
+    ReadBuffer(const ReadBuffer&) = delete;
+    ReadBuffer& operator=(const ReadBuffer&) = delete;
+    ReadBuffer(ReadBuffer&&) = delete;
+    ReadBuffer& operator=(ReadBuffer&&) = delete;
+
+    // 可写入的空闲空间，不足时整理或扩大存储；已达到上限时返回空
+    [[nodiscard]] std::span<char> prepare();
+
+    // 确认 prepare() 返回的空间中已写入 bytes 字节
+    void commit(size_t bytes);
+
+    // 丢弃头部已处理的 bytes 字节
+    void consume(size_t bytes);
+
+    void clear();
+
+    // 缓冲区为空时把存储归还给 BufferPool，下次写入时按最近的用量重新取得
+    void release();
+
+    [[nodiscard]] std::string_view view() const;
+    [[nodiscard]] size_t size() const;
+    [[nodiscard]] bool empty() const;
+
+    // 已达到上限，无法再写入
+    [[nodiscard]] bool full() const;
+
+private:
+    static constexpr size_t MAX_INITIAL_SIZE = 64 * 1024;  // 重新取得存储时的最大初始容量
+
+    BufferPool::Block block_;
+    size_t begin_{0};                                  // 未处理数据的起始位置
+    size_t end_{0};                                    // 未处理数据的结束位置
+    size_t limit_;                                     // 上限，0 表示不限制
+    size_t initial_size_{BufferPool::MIN_BLOCK_SIZE};  // 下次取得存储时的容量，随最近的用量调整
+    size_t peak_{0};                                   // 本次持有存储期间的最大数据量
+};
+
+#endif  // UTILS_READ_BUFFER_H
@@ -0,0 +1,43 @@
+#ifndef UTILS_REQUEST_ARENA_H
+#define UTILS_REQUEST_ARENA_H
+
+#include <array>
+#include <cstddef>
+#include <memory_resource>
+
+// 请求级内存池。工作线程处理一个请求期间，请求头、Cookie、表单与响应头等短期对象从本线程的单调缓冲区分配，
+// 请求处理结束后整体释放；超出初始缓冲区的部分向本线程的内存池申请，释放后留待下一个请求复用，不经过全局分配器。
+// 在作用域内创建的对象不能在作用域结束后继续使用：需要长期保存的对象（如缓存）应以默认分配器复制一份
+class RequestArena {
+public:
+    // 在当前线程上开启请求作用域，嵌套时由最外层结束时释放
+    class Scope {
+    public:
+        Scope();
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+        Scope(Scope&&) = delete;
+        Scope& operator=(Scope&&) = delete;
+    };
+
+    // 当前线程处于请求作用域内时返回请求内存池，否则返回默认分配器
+    [[nodiscard]] static std::pmr::memory_resource* resource();
+
+    static constexpr size_t INITIAL_BUFFER_SIZE = 16 * 1024;
+    static constexpr size_t MAX_POOLED_BLOCK_SIZE = 256 * 1024;
+
+private:
+    struct State {
+        std::pmr::unsynchronized_pool_resource pool{
+            std::pmr::pool_options{.max_blocks_per_chunk = 0, .largest_required_pool_block = MAX_POOLED_BLOCK_SIZE}};
+        alignas(std::max_align_t) std::array<std::byte, INITIAL_BUFFER_SIZE> buffer{};
+        std::pmr::monotonic_buffer_resource arena{buffer.data(), buffer.size(), &pool};
+        size_t depth = 0;  // 当前嵌套的作用域数量
+    };
+
+    static State& state();
+};
+
+#endif  // UTILS_REQUEST_ARENA_H
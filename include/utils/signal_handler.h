@@ -1,26 +1,62 @@
 #ifndef UTILS_SIGNAL_HANDLER_H
 #define UTILS_SIGNAL_HANDLER_H
 
-#include <atomic>
 #include <csignal>
+#include <cstring>
+#include <format>
+#include <stdexcept>
 
+#include <pthread.h>
+#include <sys/signalfd.h>
+#include <unistd.h>
+
+// 退出信号（SIGINT / SIGTERM / SIGQUIT）与热重启信号（SIGHUP）经 signalfd 读取，由主线程的事件循环统一处理，
+// 而不是在任意线程中打断系统调用。必须在创建任何线程之前构造，之后创建的线程会继承信号屏蔽字
 class SignalHandler {
 public:
-    [[nodiscard]] static std::atomic<bool>& setup() {
-        static std::atomic running{true};
+    SignalHandler() {
+        sigset_t mask;
+        sigemptyset(&mask);
+        sigaddset(&mask, SIGINT);
+        sigaddset(&mask, SIGTERM);
+        sigaddset(&mask, SIGHUP);
+        sigaddset(&mask, SIGQUIT);
+
+        if (const int error = pthread_sigmask(SIG_BLOCK, &mask, nullptr); error != 0) {
+            throw std::runtime_error(std::format("Failed to block signals: {}", strerror(error)));
+        }
+
+        signal_fd_ = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+        if (signal_fd_ == -1) {
+            throw std::runtime_error(std::format("Failed to create signalfd: {}", strerror(errno)));
+        }
+
+        // 对端已关闭（或超时被 shutdown）的 socket 上 sendfile 会触发 SIGPIPE，改为返回 EPIPE
+        signal(SIGPIPE, SIG_IGN);
+    }
+
+    ~SignalHandler() {
+        close(signal_fd_);
+    }
 
-        struct sigaction action {};
-        action.sa_handler = [](int /*signum*/) { running.store(false, std::memory_order_relaxed); };
-        action.sa_flags = SA_RESTART;
-        sigemptyset(&action.sa_mask);
+    SignalHandler(const SignalHandler&) = delete;
+    SignalHandler& operator=(const SignalHandler&) = delete;
+    SignalHandler(SignalHandler&&) = delete;
+    SignalHandler& operator=(SignalHandler&&) = delete;
 
-        sigaction(SIGINT, &action, nullptr);
-        sigaction(SIGTERM, &action, nullptr);
-        sigaction(SIGHUP, &action, nullptr);
-        sigaction(SIGQUIT, &action, nullptr);
+    [[nodiscard]] int fd() const { return signal_fd_; }
 
-        return running;
+    // 读取一个待处理的信号，返回信号编号；没有待处理的信号时返回 0
+    [[nodiscard]] int next() const {
+        signalfd_siginfo info{};
+        if (read(signal_fd_, &info, sizeof(info)) != sizeof(info)) {
+            return 0;
+        }
+        return static_cast<int>(info.ssi_signo);
     }
+
+private:
+    int signal_fd_{-1};
 };
 
 #endif  // UTILS_SIGNAL_HANDLER_H
@@ -0,0 +1,17 @@
+#ifndef UTILS_STRING_HASH_H
+#define UTILS_STRING_HASH_H
+
+#include <cstddef>
+#include <functional>
+#include <string_view>
+
+// 支持以 string_view 查找的字符串哈希，查找时不构造临时字符串（需配合 std::equal_to<>）
+struct StringHash {
+    using is_transparent = void;
+
+    size_t operator()(const std::string_view str) const {
+        return std::hash<std::string_view>{}(str);
+    }
+};
+
+#endif  // UTILS_STRING_HASH_H
@@ -1,42 +1,87 @@
 #ifndef UTILS_UPLOAD_FILE_H
 #define UTILS_UPLOAD_FILE_H
 
+#include <cstddef>
 #include <filesystem>
 #include <optional>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
+#include "core/address.h"
 #include "core/http_response.h"
+#include "utils/cancellation_token.h"
+#include "utils/multipart_parser.h"
 
 // 前向声明
 class Logger;
-class HttpRequest;
 class StaticFile;
-class Address;
 
+// 处理 multipart/form-data 上传。请求体按到达顺序交给 write()，文件数据边解析边写入目标目录中的临时文件，
+// 每个文件接收完毕后再改名为目标文件名；内存占用与上传大小无关，未写完的文件不会出现在网盘中
 class UploadFile {
 public:
-    UploadFile(const HttpRequest& request, Logger* logger, StaticFile* static_file, const Address& info);
+    // 接收中的临时文件名前缀，目录列表中不显示
+    static constexpr std::string_view TEMP_FILE_PREFIX = ".upload-";
 
-    [[nodiscard]] HttpResponse process() const;
+    // 流式上传：请求头到达后创建，先检查 rejection()，之后依次 write() 请求体，接收完毕后调用 finish()
+    UploadFile(std::string_view request_path, std::string_view boundary, Logger* logger, StaticFile* static_file,
+               const Address& info, CancellationToken cancel = {});
+
+    ~UploadFile();
+
+    UploadFile(const UploadFile&) = delete;
+    UploadFile& operator=(const UploadFile&) = delete;
+    UploadFile(UploadFile&&) = delete;
+    UploadFile& operator=(UploadFile&&) = delete;
+
+    // 缺少边界或上传路径不安全时，请求体无需再接收，直接返回该响应
+    [[nodiscard]] const std::optional<HttpResponse>& rejection() const;
+
+    // 送入下一段请求体，格式错误时抛出 std::invalid_argument；
+    // cancel 被取消（客户端已断开）时删除未写完的文件并抛出 OperationCancelled
+    void write(std::string_view data);
+
+    // 请求体接收完毕，返回上传结果
+    [[nodiscard]] HttpResponse finish();
 
 private:
     Logger* logger_;
     StaticFile* static_file_;
     std::filesystem::path drive_path_;  // 网盘文件目录
+    Address info_;
+    CancellationToken cancel_;  // 客户端断开时取消
+
+    std::filesystem::path upload_path_;      // 上传目标目录
+    std::optional<HttpResponse> rejection_;  // 请求头阶段即可确定的错误响应
+    std::optional<MultipartParser> parser_;
+    size_t unchecked_bytes_ = 0;  // 上次检查取消状态后写入的字节数
+
+    // 正在接收的文件
+    std::string filename_;
+    std::filesystem::path temp_path_;
+    int temp_fd_ = -1;
+    bool receiving_ = false;  // 当前部分是文件
+    bool skipping_ = false;   // 当前文件已失败，丢弃其余数据
 
-    HttpResponse response_;
     std::vector<std::pair<std::string, std::string>> failure_files_;  // 失败文件列表
     size_t success_count_ = 0;                                        // 成功文件数量
+    size_t file_count_ = 0;                                           // 已出现的文件数量
 
-    [[nodiscard]] HttpResponse handle(const HttpRequest& request, const Address& info);
+    void onPartBegin(const MultipartPart& part);
+    void onPartData(std::string_view data);
+    void onPartEnd();
 
-    [[nodiscard]] std::optional<std::string> checkFilename(const std::string& name, const Address& info) const;
-    [[nodiscard]] bool checkPath(const std::filesystem::path& path, const Address& info) const;
-    [[nodiscard]] std::optional<std::string> checkFilePath(const std::filesystem::path& path,
-                                                           const Address& info) const;
+    [[nodiscard]] bool openTemp();
+    [[nodiscard]] bool writeTemp(std::string_view data);
+    [[nodiscard]] std::optional<std::string> commitTemp(const std::filesystem::path& path);
+    void fail(std::string message);
+    void discardTemp();
 
-    [[nodiscard]] bool write(const std::filesystem::path& path, const std::string& data, const Address& info) const;
+    [[nodiscard]] std::optional<std::string> checkFilename(const std::string& name) const;
+    [[nodiscard]] bool checkPath(const std::filesystem::path& path) const;
+    [[nodiscard]] std::optional<std::string> checkFilePath(const std::filesystem::path& path) const;
 
     [[nodiscard]] HttpResponse buildMessage(const std::string& location) const;
     [[nodiscard]] HttpResponse buildJsonResponse() const;
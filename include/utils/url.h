@@ -5,16 +5,17 @@
 #include <iomanip>
 #include <sstream>
 #include <string>
+#include <string_view>
 
 class Url {
 public:
-    [[nodiscard]] static std::string decode(const std::string& url) {
+    [[nodiscard]] static std::string decode(const std::string_view url) {
         std::ostringstream decoded;
         for (size_t i = 0; i < url.size(); ++i) {
             if (url[i] == '+') {
                 decoded << ' ';
             } else if (url[i] == '%' && i + 2 < url.size()) {
-                std::string hex = url.substr(i + 1, 2);
+                const std::string hex(url.substr(i + 1, 2));
                 try {
                     const char decoded_char = static_cast<char>(std::stoi(hex, nullptr, 16));
                     decoded << decoded_char;
@@ -29,6 +30,11 @@ public:
         return decoded.str();
     }
 
+    // 去掉查询参数与片段，只保留路径部分
+    [[nodiscard]] static std::string_view stripQuery(const std::string_view url) {
+        return url.substr(0, url.find_first_of("?#"));
+    }
+
     [[nodiscard]] static std::string encode(const std::string& url) {
         std::ostringstream encoded;
         encoded.fill('0');
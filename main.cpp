@@ -1,5 +1,7 @@
+#include <chrono>
 #include <cstdint>
 #include <iostream>
+#include <string>
 
 #include "core/server.h"
 #include "core/static_file.h"
@@ -23,7 +25,8 @@ std::filesystem::path getRootPath() {
 
 int main() {
     try {
-        auto& running = SignalHandler::setup();
+        // 必须先于线程池等任何线程创建，使所有线程继承信号屏蔽字
+        const SignalHandler signal_handler;
 
         auto root_path = getRootPath();
 
@@ -32,21 +35,48 @@ int main() {
         Logger logger(config.getLogLevel());
         logger.logDivider("Server init");
 
-        ThreadPool thread_pool(config.get("thread_count", 4), &logger);
+        ThreadPool thread_pool(
+            config.get("thread_count", 4), &logger,
+            std::chrono::milliseconds(config.get("queue_delay_target", ThreadPool::DEFAULT_QUEUE_TARGET.count())),
+            std::chrono::milliseconds(config.get("queue_delay_interval", ThreadPool::DEFAULT_QUEUE_INTERVAL.count())));
 
         SessionManager session_manager;
 
         const std::string static_dir = config.get("static_dir", std::string("static"));
         const std::string drive_dir = config.get("drive_dir", std::string("files"));
-        StaticFile static_file(root_path, static_dir, drive_dir, &logger, &session_manager);
+        StaticFile static_file(root_path, static_dir, drive_dir, &logger);
 
         const std::string user_file = config.get("user_file", std::string("users.dat"));
         const std::filesystem::path user_path = weakly_canonical(root_path / "data" / user_file);
         UserManager user_manager(user_path, &logger, &session_manager, drive_dir);
 
-        const uint16_t port = config.get("port", 8080);
-        const bool linger = config.get("linger", true);
-        Server server(port, linger, running, &logger, &thread_pool, &static_file, &user_manager);
+        const ConnectionOptions options{
+            .linger = config.get("linger", true),
+            .keep_alive = config.get("keep_alive", true),
+            .max_requests = config.get("keep_alive_requests", ConnectionOptions::DEFAULT_MAX_REQUESTS),
+            .http2 = config.get("http2", true),
+            .max_header_size = config.get("max_header_size", ConnectionOptions::DEFAULT_MAX_HEADER_SIZE),
+            .max_body_size = config.get("max_body_size", ConnectionOptions::DEFAULT_MAX_BODY_SIZE),
+            .max_form_size = config.get("max_form_size", ConnectionOptions::DEFAULT_MAX_FORM_SIZE),
+            .header_timeout = std::chrono::seconds(
+                config.get("header_timeout", ConnectionOptions::DEFAULT_HEADER_TIMEOUT.count())),
+            .body_timeout =
+                std::chrono::seconds(config.get("body_timeout", ConnectionOptions::DEFAULT_BODY_TIMEOUT.count())),
+            .idle_timeout =
+                std::chrono::seconds(config.get("idle_timeout", ConnectionOptions::DEFAULT_IDLE_TIMEOUT.count())),
+            .keep_alive_timeout = std::chrono::seconds(
+                config.get("keep_alive_timeout", ConnectionOptions::DEFAULT_KEEP_ALIVE_TIMEOUT.count())),
+        };
+        const ServerOptions server_options{
+            .listen = ListenAddress::parseList(
+                config.get("listen", std::to_string(config.get("port", ServerOptions::DEFAULT_PORT)))),
+            .reactor_count = config.get("reactor_count", static_cast<size_t>(1)),
+            .event_backend = config.get("event_backend", std::string("epoll")),
+            .max_connections = config.get("max_connections", ServerOptions::DEFAULT_MAX_CONNECTIONS),
+            .shutdown_timeout = std::chrono::seconds(
+                config.get("shutdown_timeout", ServerOptions::DEFAULT_SHUTDOWN_TIMEOUT.count())),
+        };
+        Server server(server_options, options, &signal_handler, &logger, &thread_pool, &static_file, &user_manager);
         server.run();
     } catch (const std::exception& e) {
         std::cerr << "Server crashed: " << e.what() << '\n';
@@ -1,19 +1,51 @@
 #include "core/address.h"
 
 #include <array>
+#include <cstddef>
+#include <cstring>
 #include <format>
 #include <utility>
 
 #include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/un.h>
 
 Address::Address(std::string ip_address, const uint16_t port, const int conn_fd)
     : ip_(std::move(ip_address)), port_(port), fd_(conn_fd) {}
 
-Address::Address(const sockaddr_in& addr, const int conn_fd) : port_(ntohs(addr.sin_port)), fd_(conn_fd) {
-    std::array<char, INET_ADDRSTRLEN> ip_str{};
-    inet_ntop(AF_INET, &addr.sin_addr, ip_str.data(), ip_str.size());
-    ip_ = ip_str.data();
+// NOLINTBEGIN(cppcoreguidelines-pro-type-reinterpret-cast)
+Address::Address(const sockaddr_storage& addr, const socklen_t length, const int conn_fd)
+    : family_(addr.ss_family), fd_(conn_fd) {
+    std::array<char, INET6_ADDRSTRLEN> ip_str{};
+
+    switch (family_) {
+        case AF_INET: {
+            const auto* addr_in = reinterpret_cast<const sockaddr_in*>(&addr);
+            inet_ntop(AF_INET, &addr_in->sin_addr, ip_str.data(), ip_str.size());
+            ip_ = ip_str.data();
+            port_ = ntohs(addr_in->sin_port);
+            break;
+        }
+        case AF_INET6: {
+            const auto* addr_in6 = reinterpret_cast<const sockaddr_in6*>(&addr);
+            inet_ntop(AF_INET6, &addr_in6->sin6_addr, ip_str.data(), ip_str.size());
+            ip_ = ip_str.data();
+            port_ = ntohs(addr_in6->sin6_port);
+            break;
+        }
+        case AF_UNIX: {
+            // 客户端通常未绑定路径，此时 sun_path 为空
+            const auto* addr_un = reinterpret_cast<const sockaddr_un*>(&addr);
+            const size_t path_offset = offsetof(sockaddr_un, sun_path);
+            const size_t path_length = length > path_offset ? length - path_offset : 0;
+            ip_.assign(addr_un->sun_path, strnlen(addr_un->sun_path, path_length));
+            break;
+        }
+        default:
+            break;
+    }
 }
+// NOLINTEND(cppcoreguidelines-pro-type-reinterpret-cast)
 
 std::string Address::ip() const {
     return ip_;
@@ -27,15 +59,25 @@ int Address::fd() const {
     return fd_;
 }
 
+sa_family_t Address::family() const {
+    return family_;
+}
+
 std::string Address::toString() const {
+    if (family_ == AF_UNIX) {
+        return ip_.empty() ? "unix" : "unix:" + ip_;
+    }
     if (ip_.empty()) {
         return "Unknown";
     }
+    if (family_ == AF_INET6) {
+        return std::format("[{}]:{}", ip_, port_);
+    }
     return std::format("{}:{}", ip_, port_);
 }
 
 bool Address::operator==(const Address& other) const {
-    return ip_ == other.ip_ && port_ == other.port_;
+    return family_ == other.family_ && ip_ == other.ip_ && port_ == other.port_;
 }
 
 bool Address::operator!=(const Address& other) const {
@@ -0,0 +1,72 @@
+#include "core/admission_control.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+AdmissionControl::AdmissionControl(const size_t max_connections) : max_connections_(max_connections) {
+    openReserveFd();
+}
+
+AdmissionControl::~AdmissionControl() {
+    if (reserve_fd_ != -1) {
+        close(reserve_fd_);
+    }
+}
+
+bool AdmissionControl::tryAcquire() {
+    size_t current = active_.load(std::memory_order_relaxed);
+    do {
+        if (max_connections_ != 0 && current >= max_connections_) {
+            return false;
+        }
+    } while (!active_.compare_exchange_weak(current, current + 1, std::memory_order_relaxed));
+    return true;
+}
+
+void AdmissionControl::release() {
+    active_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+bool AdmissionControl::withReserveFd(const std::function<void()>& action) {
+    std::lock_guard lock(reserve_mutex_);
+    if (reserve_fd_ == -1) {
+        // 上次释放后没能重新占用（fd 被其他线程抢先用掉），再试一次
+        openReserveFd();
+        if (reserve_fd_ == -1) {
+            return false;
+        }
+    }
+
+    close(reserve_fd_);
+    reserve_fd_ = -1;
+    action();
+    openReserveFd();
+    return true;
+}
+
+void AdmissionControl::countRejection(const Rejection reason) {
+    auto& counter = reason == Rejection::OVER_LIMIT ? rejected_over_limit_ : rejected_no_fd_;
+    counter.fetch_add(1, std::memory_order_relaxed);
+}
+
+size_t AdmissionControl::maxConnections() const {
+    return max_connections_;
+}
+
+size_t AdmissionControl::active() const {
+    return active_.load(std::memory_order_relaxed);
+}
+
+uint64_t AdmissionControl::rejected(const Rejection reason) const {
+    const auto& counter = reason == Rejection::OVER_LIMIT ? rejected_over_limit_ : rejected_no_fd_;
+    return counter.load(std::memory_order_relaxed);
+}
+
+void AdmissionControl::openReserveFd() {
+    reserve_fd_ = open("/dev/null", O_RDONLY | O_CLOEXEC);
+}
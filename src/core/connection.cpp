@@ -1,42 +1,87 @@
 #include "core/connection.h"
 
+#include <algorithm>
+#include <array>
+#include <chrono>
 #include <cstddef>
 #include <cstring>
 #include <format>
+#include <span>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <utility>
 
+#include <sys/sendfile.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
-#include "core/epoll_manager.h"
+#include "core/event_backend.h"
+#include "core/http2_session.h"
 #include "core/http_request.h"
 #include "core/http_response.h"
+#include "core/request_context.h"
 #include "core/static_file.h"
 #include "user/user_manager.h"
+#include "utils/cancellation_token.h"
+#include "utils/file_descriptor.h"
 #include "utils/logger.h"
+#include "utils/request_arena.h"
 #include "utils/upload_file.h"
 #include "utils/url.h"
 
 namespace {
+    constexpr size_t MAX_QUEUED_SEGMENTS = 64;  // 管线化解析时发送队列的最大片段数
+    constexpr size_t MAX_IOV_COUNT = 64;        // 单次 sendmsg 最多合并的片段数
+
+    // 单次读事件最多读取的字节数，达到后先解析并检查大小限制，再重新注册事件继续读取
+    constexpr size_t MAX_READ_PER_EVENT = 1024 * 1024;
+
+    // 上传请求体流式写入磁盘，不受接收缓冲区大小的约束
+    bool isUpload(const HttpRequest& request) {
+        return request.method() == "POST" && request.path().ends_with("/upload");
+    }
+
+    // 接收缓冲区的上限：一个最大的请求头与表单请求体，另留一个请求头的余量给分块编码的开销与管线化的后续请求；
+    // 上传请求体边接收边移出缓冲区，HTTP/2 帧不超过 16 KiB，均能容纳
+    size_t bufferLimit(const ConnectionOptions& options) {
+        if (options.max_form_size == 0) {
+            return 0;  // 请求体不限制时缓冲区也不限制
+        }
+        return (2 * options.max_header_size) + options.max_form_size;
+    }
+
+    // 提前拒绝请求后，丢弃对端剩余数据的最长时间
+    constexpr std::chrono::seconds LINGERING_TIMEOUT{5};
+
     std::string formatSize(const size_t bytes) {
         return std::format("{} {}", bytes, bytes == 1 ? "byte" : "bytes");
     }
 }  // namespace
 
-Connection::Connection(const int client_fd, const sockaddr_in& addr, EpollManager* epoll, Logger* logger,
-                       StaticFile* static_file, UserManager* user_manager, const bool linger)
+Connection::Connection(const int client_fd, const uint32_t generation, const Address& info,
+                       EventBackend* event_backend, Logger* logger, StaticFile* static_file, UserManager* user_manager,
+                       const ConnectionOptions& options)
     : client_fd_(client_fd),
-      info_(addr, client_fd),
-      epoll_manager_(epoll),
+      event_data_(EventBackend::eventData(client_fd, generation)),
+      info_(info),
+      event_backend_(event_backend),
       logger_(logger),
       static_file_(static_file),
-      user_manager_(user_manager) {
+      user_manager_(user_manager),
+      options_(options),
+      request_buffer_(bufferLimit(options)),
+      request_start_(std::chrono::steady_clock::now()),
+      cancel_token_(CancellationToken::create()) {
     // 设置 linger 选项
-    applyLinger(linger);
+    applyLinger(options_.linger);
+
+    // 连接建立后开始计算请求头超时
+    updateDeadline();
 
-    // 将客户端 socket 添加到 epoll 中，监听读写事件
-    epoll_manager_->addFd(client_fd_, EPOLLIN | EPOLLET | EPOLLONESHOT);
+    // 将客户端 socket 添加到事件后端中，监听读写事件
+    event_backend_->addFd(client_fd_, EPOLLIN | EPOLLET | EPOLLONESHOT, event_data_);
 
     logger_->log(LogLevel::INFO, info_, "New client connected.");
 }
@@ -53,32 +98,199 @@ const Address& Connection::info() const {
     return info_;
 }
 
-void Connection::handleRead() const {
+std::chrono::steady_clock::time_point Connection::deadline() const {
+    return deadline_;
+}
+
+void Connection::expire() const {
+    if (closed_) {
+        return;
+    }
+
+    logger_->log(LogLevel::INFO, info_, std::format("Timed out waiting for {}.", phase_.load()));
+    shutdown(client_fd_, SHUT_RDWR);
+}
+
+void Connection::cancel() const {
+    cancel_token_.cancel();
+}
+
+void Connection::drain() {
+    draining_ = true;
+
+    // 工作线程可能恰好开始读取新请求，此时该请求会随连接关闭而丢失，与长连接空闲关闭的竞争相同，客户端会重试
+    if (idle_) {
+        logger_->log(LogLevel::DEBUG, info_, "Closing idle connection for shutdown.");
+        shutdown(client_fd_, SHUT_RDWR);
+    }
+}
+
+void Connection::updateDeadline() const {
+    using std::chrono::seconds;
+
+    idle_ = !lingering_ && output_queue_.empty() && request_buffer_.empty() && !request_.isHeaderParsed() &&
+            (!http2_ || http2_->idle());
+
+    if (lingering_) {
+        phase_ = "client to close";
+        deadline_ = linger_until_;
+        return;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    seconds timeout{};
+    if (!output_queue_.empty() || http2_) {
+        // 对端不读取响应，或 HTTP/2 连接上没有新的帧
+        phase_ = http2_ ? "HTTP/2 frames" : "client to read response";
+        timeout = options_.idle_timeout;
+    } else if (request_.isHeaderParsed()) {
+        // 请求体按两次读取之间的间隔计时，大文件上传不受总时长限制
+        phase_ = "request body";
+        timeout = options_.body_timeout;
+    } else if (request_buffer_.empty() && request_count_ > 0) {
+        phase_ = "next request";
+        timeout = options_.keep_alive_timeout;
+    } else {
+        // 请求头从请求开始时计时，逐字节慢速发送也无法延长
+        phase_ = "request header";
+        start = request_start_;
+        timeout = options_.header_timeout;
+    }
+
+    deadline_ = timeout == seconds::zero() ? std::chrono::steady_clock::time_point::max() : start + timeout;
+}
+
+void Connection::rearm(const uint32_t events) const {
+    if (peer_closed_ && (events & EPOLLIN) != 0) {
+        // 对端已半关闭，已收到的请求均已响应，不会再有新的请求
+        requestCloseConnection();
+        return;
+    }
+
+    // 没有未处理的数据时归还接收缓冲区，等待下一个请求的长连接不占用内存
+    request_buffer_.release();
+
+    // 先更新截止时间再注册事件，注册后连接可能立即被其他工作线程处理
+    updateDeadline();
+    watching_ = false;
+    event_backend_->modFd(client_fd_, events, event_data_);
+}
+
+void Connection::watchDisconnect() const {
+    // EPOLLONESHOT 已使连接在工作线程处理期间不产生任何事件；这里只关注总会上报的 EPOLLHUP / EPOLLERR，
+    // 事件循环收到后取消请求，缓冲区中的后续请求数据不会触发事件。
+    // 不关注 EPOLLRDHUP：对端半关闭（HTTP/1.0 风格的客户端发送请求后 shutdown(SHUT_WR)）时仍在等待响应
+    watching_ = true;
+    event_backend_->modFd(client_fd_, EPOLLET | EPOLLONESHOT, event_data_);
+}
+
+void Connection::handleRead(const bool shed) const {
     if (closed_) {
         logger_->log(LogLevel::WARNING, info_, "Connection already closed.");
         return;
     }
+    deadline_ = std::chrono::steady_clock::time_point::max();
+    idle_ = false;
+    shedding_ = shed && (http2_ || !request_.isHeaderParsed());
 
-    constexpr std::size_t buffer_size = 65536;  // 64KB 缓冲区
-    std::array<char, buffer_size> buffer{};     // 用于存储从客户端接收到的数据
+    // 数据持续到达时不等到 EAGAIN：先检查请求大小限制，避免超限的请求体全部读入内存，
+    // 也避免单个快速上传长期占用工作线程；重新注册事件后未读的数据会立即再次触发
+    if (receive(MAX_READ_PER_EVENT)) {
+        processInput();
+    }
+}
 
-    while (true) {
-        const ssize_t bytes_read = recv(client_fd_, buffer.data(), buffer_size, 0);
+bool Connection::atRequestBoundary() const {
+    return !closed_ && !http2_ && !lingering_ && !upload_ && !request_.isHeaderParsed();
+}
+
+bool Connection::handleReadInline() const {
+    // 只在请求边界上尝试；请求体、HTTP/2 帧与未发送完的响应仍由工作线程处理
+    if (closed_ || http2_ || lingering_ || !output_queue_.empty() || !request_buffer_.empty() ||
+        request_.isHeaderParsed()) {
+        return false;
+    }
+    deadline_ = std::chrono::steady_clock::time_point::max();
+    idle_ = false;
+    shedding_ = false;
+
+    // 只读取一次，剩余的数据在重新注册事件后再次触发，或由工作线程继续读取
+    if (!receive(1)) {
+        return true;
+    }
+
+    bool served = false;
+    while (serveFromCache()) {
+        served = true;
+    }
+    if (!served) {
+        if (request_buffer_.empty()) {
+            rearm(EPOLLIN | EPOLLET | EPOLLONESHOT);
+            return true;
+        }
+        return false;
+    }
+
+    // 缓存内容已在内存中，直接发送；socket 缓冲区已满时由工作线程在可写后继续发送
+    if (!flushOutput() || closeAfterWrite()) {
+        return true;
+    }
+    if (!request_buffer_.empty()) {
+        return false;  // 管线化的后续请求不适合快速路径
+    }
+    if (draining_) {
+        requestCloseConnection();
+        return true;
+    }
+    rearm(EPOLLIN | EPOLLET | EPOLLONESHOT);
+    return true;
+}
+
+bool Connection::handleWriteInline() const {
+    // 只处理全部位于内存中的响应：sendfile 可能读盘、生成器可能耗时，管线化的后续请求需要解析，均交给工作线程
+    if (closed_ || http2_ || lingering_ || upload_ || request_.isHeaderParsed() || !request_buffer_.empty() ||
+        !std::ranges::all_of(output_queue_, &BodySegment::isData)) {
+        return false;
+    }
+    deadline_ = std::chrono::steady_clock::time_point::max();
+    idle_ = false;
+
+    if (!flushOutput() || closeAfterWrite()) {
+        return true;
+    }
+    if (draining_) {
+        requestCloseConnection();
+        return true;
+    }
+    rearm(EPOLLIN | EPOLLET | EPOLLONESHOT);
+    return true;
+}
+
+bool Connection::receive(const size_t max_bytes) const {
+    size_t received = 0;
+    while (received < max_bytes) {
+        // 直接读入接收缓冲区的空闲空间；缓冲区已达上限时先处理已收到的数据
+        const std::span<char> space = request_buffer_.prepare();
+        if (space.empty()) {
+            return true;
+        }
+
+        const ssize_t bytes_read = event_backend_->receive(client_fd_, space);
 
         if (bytes_read == 0) {
-            // 客户端关闭连接
-            requestCloseConnection();
-            return;
+            if (request_buffer_.empty() || lingering_) {
+                // 客户端关闭连接
+                requestCloseConnection();
+                return false;
+            }
+            // 对端只是关闭了写方向：已收到的请求（包括管线化的后续请求）照常处理并响应，之后再关闭
+            peer_closed_ = true;
+            return true;
         }
 
         if (bytes_read < 0) {
             if (errno == EAGAIN || errno == EWOULDBLOCK) {
-                if (tryParse()) {
-                    epoll_manager_->modFd(client_fd_, EPOLLOUT | EPOLLET | EPOLLONESHOT);
-                } else {
-                    epoll_manager_->modFd(client_fd_, EPOLLIN | EPOLLET | EPOLLONESHOT);
-                }
-                return;
+                return true;
             }
             if (errno == ECONNRESET) {
                 logger_->log(LogLevel::INFO, info_, "Connection reset by peer.");
@@ -87,54 +299,445 @@ void Connection::handleRead() const {
             }
 
             requestCloseConnection();
+            return false;
+        }
+
+        if (lingering_) {
+            // 被拒绝请求的剩余数据，不提交即丢弃
+        } else {
+            if (request_buffer_.empty() && request_count_ > 0) {
+                // 长连接上的下一个请求开始到达
+                request_start_ = std::chrono::steady_clock::now();
+            }
+            request_buffer_.commit(static_cast<size_t>(bytes_read));
+        }
+        received += static_cast<size_t>(bytes_read);
+    }
+    return true;
+}
+
+bool Connection::serveFromCache() const {
+    if (close_after_write_ || output_queue_.size() >= MAX_QUEUED_SEGMENTS || request_buffer_.empty()) {
+        return false;
+    }
+
+    const std::string_view input = request_buffer_.view();
+    if (options_.http2 && request_count_ == 0 &&
+        Http2Session::PREFACE.starts_with(input.substr(0, Http2Session::PREFACE.size()))) {
+        return false;  // 可能是 HTTP/2 连接前言
+    }
+
+    try {
+        if (!request_.parseHeader(input)) {
+            return false;
+        }
+    } catch (const std::invalid_argument&) {
+        return false;  // 由工作线程重新解析并返回 400
+    }
+
+    // 只处理无请求体、无需检查权限与协议升级的 GET
+    if (request_.method() != "GET" || request_.isChunked() || request_.contentLength() != 0 ||
+        request_.headerLength() > options_.max_header_size || request_.getHeader(HttpHeader::EXPECT) ||
+        request_.getHeader(HttpHeader::UPGRADE)) {
+        return false;
+    }
+
+    const auto cached = static_file_->findCached(request_.path());
+    if (!cached) {
+        return false;
+    }
+    logger_->log(LogLevel::DEBUG, info_, std::format("Serving GET for path: {} from cache", request_.path()));
+
+    ++request_count_;
+    request_start_ = std::chrono::steady_clock::now();
+    const bool keep_alive = options_.keep_alive && request_.keepAlive() && request_count_ < options_.max_requests &&
+                            !draining_;
+    const bool chunked = request_.version() == "HTTP/1.1";
+    const RequestArena::Scope arena;
+    HttpResponse response(*cached, RequestArena::resource());
+
+    request_buffer_.consume(request_.headerLength());
+    request_.reset();
+    queueResponse(response, keep_alive, chunked);
+    return true;
+}
+
+void Connection::processInput() const {
+    if (lingering_) {
+        rearm(EPOLLIN | EPOLLET | EPOLLONESHOT);
+        return;
+    }
+
+    const bool parsed = tryParse();
+    if (cancel_token_.cancelled()) {
+        // 客户端在处理期间断开，已生成的响应无人接收
+        requestCloseConnection();
+        return;
+    }
+
+    if (!parsed) {
+        if (request_buffer_.full()) {
+            // 缓冲区已达上限仍无法解析出完整的请求（如分块编码的开销过大）
+            logger_->log(LogLevel::INFO, info_, "Request exceeds connection buffer limit.");
+            if (http2_) {
+                requestCloseConnection();
+                return;
+            }
+            constexpr int error_code = 413;
+            HttpResponse response = HttpResponse::responseError(error_code);
+            rejectEarly(response);
+            request_buffer_.clear();
+        } else {
+            rearm(EPOLLIN | EPOLLET | EPOLLONESHOT);
             return;
         }
+    }
 
-        request_buffer_.append(buffer.data(), bytes_read);
+    if (shedding_) {
+        // 拒绝响应很小，直接在当前线程发送，不再经过线程池
+        handleWrite();
+        return;
     }
+    rearm(EPOLLOUT | EPOLLET | EPOLLONESHOT);
 }
 
 bool Connection::tryParse() const {
-    std::string response;
+    if (!http2_ && options_.http2 && request_count_ == 0 && output_queue_.empty() && !request_buffer_.empty()) {
+        // 以连接前言开头的连接直接按 HTTP/2 处理（prior knowledge）
+        const std::string_view preface = Http2Session::PREFACE;
+        const size_t length = std::min(request_buffer_.size(), preface.size());
+        if (request_buffer_.view().substr(0, length) == preface.substr(0, length)) {
+            if (length < preface.size()) {
+                return false;  // 连接前言不完整
+            }
+
+            logger_->log(LogLevel::INFO, info_, "Using HTTP/2 with prior knowledge.");
+            http2_ = createHttp2Session();
+        }
+    }
+
+    if (http2_) {
+        return processHttp2();
+    }
+
+    // 一次性解析缓冲区中所有完整的请求（HTTP 管线化），响应按顺序进入发送队列
+    bool queued = false;
+    while (!http2_ && !close_after_write_ && output_queue_.size() < MAX_QUEUED_SEGMENTS && parseRequest()) {
+        queued = true;
+    }
+
+    if (http2_) {
+        // 通过 Upgrade: h2c 升级，缓冲区中剩余的数据已属于 HTTP/2
+        processHttp2();
+    }
+    return queued;
+}
+
+bool Connection::processHttp2() const {
+    const RequestArena::Scope arena;
+    if (draining_) {
+        http2_->shutdown();
+    }
+
+    if (http2_->process(request_buffer_)) {
+        http2_->fillOutput();
+    } else {
+        // 对端可能仍在发送 WINDOW_UPDATE 等帧，直接 close 会发送 RST，使客户端丢弃尚未读取的响应数据
+        close_after_write_ = true;
+        linger_close_ = true;
+    }
+    return !output_queue_.empty() || close_after_write_;
+}
+
+bool Connection::upgradeToHttp2() const {
+    const auto upgrade = request_.getHeader(HttpHeader::UPGRADE);
+    const auto settings = request_.getHeader(HttpHeader::HTTP2_SETTINGS);
+    if (request_.version() != "HTTP/1.1" || !upgrade || !settings || upgrade->find("h2c") == std::string_view::npos) {
+        return false;
+    }
+
+    auto session = createHttp2Session();
+    session->upgrade(request_, *settings);
+    http2_ = std::move(session);
+    return true;
+}
+
+std::unique_ptr<Http2Session> Connection::createHttp2Session() const {
+    return std::make_unique<Http2Session>(
+        output_queue_, [this](const HttpRequest& request) { return handleRequest(request); },
+        [this](const HttpRequest& request) { return checkRequest(request); },
+        [this](const HttpRequest& request) { return bodyLimit(request); },
+        [this](const HttpRequest& request) -> std::unique_ptr<UploadFile> {
+            if (!isUpload(request)) {
+                return nullptr;
+            }
+            return std::make_unique<UploadFile>(request.path(), request.getBoundary().value_or(""), logger_,
+                                                static_file_, info_, cancel_token_);
+        },
+        logger_, info_);
+}
+
+bool Connection::parseRequest() const {
+    // 本次处理中的临时分配在响应进入发送队列后整体释放；跨越多次调用的状态（request_、upload_）不从中分配
+    const RequestArena::Scope arena;
+    HttpResponse response;
+    bool keep_alive = false;
+    bool chunked = true;
 
     try {
-        if (!request_.isHeaderParsed()) {
-            if (!request_.parseHeader(request_buffer_)) {
-                // 请求头不完整
+        // 每次都重新绑定接收缓冲区：请求头解析完成后缓冲区仍可能因接收请求体而整理或扩大
+        if (!request_.parseHeader(request_buffer_.view())) {
+            if (request_buffer_.size() > options_.max_header_size) {
+                logger_->log(LogLevel::INFO, info_, "Request header too large.");
+                constexpr int error_code = 431;
+                response = HttpResponse::responseError(error_code);
+                rejectEarly(response);
+                return true;
+            }
+            // 请求头不完整
+            return false;
+        }
+
+        if (!request_checked_) {
+            if (request_.headerLength() > options_.max_header_size) {
+                logger_->log(LogLevel::INFO, info_, "Request header too large.");
+                constexpr int error_code = 431;
+                response = HttpResponse::responseError(error_code);
+                rejectEarly(response);
+                return true;
+            }
+
+            if (shedding_) {
+                // 线程池过载：不再等待请求体，立即拒绝并在响应发送后关闭连接
+                logger_->log(LogLevel::INFO, info_, "Server overloaded, rejecting request.");
+                constexpr int error_code = 503;
+                response = HttpResponse::responseError(error_code);
+                rejectEarly(response);
+                return true;
+            }
+
+            // 请求头到达后立即检查权限与大小，被拒绝的请求不再接收请求体
+            if (auto rejection = checkRequest(request_)) {
+                rejectEarly(*rejection);
+                return true;
+            }
+            request_checked_ = true;
+
+            if (request_.expectsContinue() && request_.version() == "HTTP/1.1" &&
+                request_buffer_.size() == request_.headerLength() &&
+                (request_.isChunked() || request_.contentLength() > 0)) {
+                // 客户端等待确认后才发送请求体
+                output_queue_.push_back({.data = "HTTP/1.1 100 Continue\r\n\r\n"});
+                return true;
+            }
+        }
+
+        if (isUpload(request_)) {
+            // 上传请求体边接收边写入磁盘，已处理的数据立即从接收缓冲区中移除
+            if (!upload_) {
+                request_.retainHeader();
+                request_buffer_.consume(request_.headerLength());
+                upload_ = std::make_unique<UploadFile>(request_.path(), request_.getBoundary().value_or(""), logger_,
+                                                       static_file_, info_, cancel_token_);
+                if (upload_->rejection()) {
+                    response = *upload_->rejection();
+                    upload_.reset();
+                    rejectEarly(response);
+                    return true;
+                }
+                logger_->log(LogLevel::DEBUG, info_, std::format("Streaming upload for path: {}", request_.path()));
+            }
+
+            const size_t consumed = request_.streamBody(
+                request_buffer_.view(), [this](const std::string_view data) { upload_->write(data); });
+            request_buffer_.consume(consumed);
+
+            if (options_.max_body_size != 0 && request_.bodyReceived() > options_.max_body_size) {
+                logger_->log(LogLevel::INFO, info_, "Upload request body exceeds limit.");
+                constexpr int error_code = 413;
+                response = HttpResponse::responseError(error_code);
+                upload_.reset();
+                rejectEarly(response);
+                return true;
+            }
+            if (!request_.isBodyComplete()) {
+                // 请求体不完整，已到达的数据已写入磁盘
                 return false;
             }
+
+            logger_->log(LogLevel::DEBUG, info_,
+                         std::format("Received upload of {} from client.", formatSize(request_.bodyReceived())));
+            ++request_count_;
+            request_checked_ = false;
+            request_start_ = std::chrono::steady_clock::now();
+
+            keep_alive = options_.keep_alive && request_.keepAlive() && request_count_ < options_.max_requests &&
+                         !draining_;
+            chunked = request_.version() == "HTTP/1.1";
+            response = upload_->finish();
+
+            // 请求体已从接收缓冲区中移除，缓冲区中只剩后续请求的数据
+            upload_.reset();
+            request_.reset();
+            queueResponse(response, keep_alive, chunked);
+            return true;
+        }
+
+        if (request_.isChunked() && !request_.parseChunkedBody(request_buffer_.view())) {
+            if (const size_t limit = bodyLimit(request_); limit != 0 && request_.body().size() > limit) {
+                logger_->log(LogLevel::INFO, info_, "Chunked request body exceeds limit.");
+                constexpr int error_code = 413;
+                response = HttpResponse::responseError(error_code);
+                rejectEarly(response);
+                return true;
+            }
+            // chunked 请求体不完整，已到达的分块已解码
+            return false;
         }
 
-        if (request_buffer_.size() < request_.totalExpectedLength()) {
+        const size_t request_length = request_.totalExpectedLength();
+        if (request_buffer_.size() < request_length) {
             // 请求体不完整
             return false;
         }
 
-        logger_->log(LogLevel::DEBUG, info_,
-                     std::format("Received {} from client.", formatSize(request_buffer_.size())));
+        logger_->log(LogLevel::DEBUG, info_, std::format("Received {} from client.", formatSize(request_length)));
+
+        request_.parseBody(request_buffer_.view());
+        ++request_count_;
+        request_checked_ = false;
+        request_start_ = std::chrono::steady_clock::now();  // 管线化的下一个请求从此刻开始计时
+
+        if (options_.http2 && upgradeToHttp2()) {
+            // 101 响应与流 1 的响应已由 HTTP/2 会话写入发送队列
+            request_buffer_.consume(request_length);
+            request_.reset();
+            return true;
+        }
+        keep_alive = options_.keep_alive && request_.keepAlive() && request_count_ < options_.max_requests &&
+                     !draining_;
+        chunked = request_.version() == "HTTP/1.1";  // HTTP/1.0 客户端不支持 chunked 编码
+        response = handleRequest(request_);
 
-        request_.parseBody(request_buffer_);
-        response = handleRequest(request_).build();
+        // 移除已处理的请求，保留后续数据供下一个请求使用
+        request_buffer_.consume(request_length);
+        request_.reset();
+    } catch (const OperationCancelled&) {
+        // 客户端已断开，未写完的文件已删除，连接随后关闭
+        logger_->log(LogLevel::INFO, info_, "Client disconnected during upload.");
+        upload_.reset();
+        close_after_write_ = true;
+        return false;
     } catch (const std::invalid_argument& e) {
+        upload_.reset();
         logger_->log(LogLevel::INFO, info_, std::format("Invalid HTTP request: {}", e.what()));
         constexpr int error_code = 400;
-        response = HttpResponse::responseError(error_code).build();
+        keep_alive = false;
+        linger_close_ = true;
+        response = HttpResponse::responseError(error_code);
     } catch (const std::exception& e) {
+        upload_.reset();
         logger_->log(LogLevel::ERROR, info_, std::format("Exception during request parsing: {}", e.what()));
         constexpr int error_code = 500;
-        response = HttpResponse::responseError(error_code).build();
+        keep_alive = false;
+        response = HttpResponse::responseError(error_code);
+    }
+
+    queueResponse(response, keep_alive, chunked);
+    return true;
+}
+
+size_t Connection::bodyLimit(const HttpRequest& request) const {
+    return isUpload(request) ? options_.max_body_size : options_.max_form_size;
+}
+
+std::optional<HttpResponse> Connection::checkRequest(const HttpRequest& request) const {
+    if (request.method() == "GET" && (request.isChunked() || request.contentLength() > 0)) {
+        logger_->log(LogLevel::INFO, info_, "GET request with a body.");
+        constexpr int error_code = 400;
+        return HttpResponse::responseError(error_code, "GET requests must not have a body.");
     }
 
-    if (response.empty()) {
+    if (const size_t limit = bodyLimit(request); limit != 0 && request.contentLength() > limit) {
+        logger_->log(LogLevel::INFO, info_,
+                     std::format("Request body of {} exceeds limit.", formatSize(request.contentLength())));
+        constexpr int error_code = 413;
+        return HttpResponse::responseError(error_code, std::format("The limit is {}.", formatSize(limit)));
+    }
+
+    if (request.getHeader(HttpHeader::EXPECT) && !request.expectsContinue()) {
+        constexpr int error_code = 417;
+        return HttpResponse::responseError(error_code);
+    }
+
+    if (isUpload(request) && !user_manager_->createContext(request).isLoggedIn()) {
+        logger_->log(LogLevel::DEBUG, info_, "Unauthorized upload attempt.");
+        constexpr int error_code = 401;
+        return HttpResponse::responseError(error_code, "You must be logged in to upload files.");
+    }
+
+    return std::nullopt;
+}
+
+void Connection::rejectEarly(HttpResponse& response) const {
+    // 请求体可能还在传输中，响应发送后不能直接 close
+    linger_close_ = true;
+    queueResponse(response, false, false);
+}
+
+void Connection::startLingeringClose() const {
+    // 接收缓冲区中还有未读数据时 close 会发送 RST，客户端可能因此收不到已发送的响应；
+    // 先关闭写方向，继续读取并丢弃数据，直到对端关闭或超时
+    shutdown(client_fd_, SHUT_WR);
+    lingering_ = true;
+    linger_until_ = std::chrono::steady_clock::now() + LINGERING_TIMEOUT;
+    request_buffer_.clear();
+    request_buffer_.release();
+    rearm(EPOLLIN | EPOLLET | EPOLLONESHOT);
+}
+
+void Connection::queueResponse(HttpResponse& response, bool keep_alive, const bool chunked) const {
+    std::string header = response.build(keep_alive, chunked);
+
+    if (header.empty()) {
         logger_->log(LogLevel::ERROR, info_, "Generated response is empty.");
         constexpr int error_code = 500;
-        response = HttpResponse::responseError(error_code).build();
+        keep_alive = false;
+        response = HttpResponse::responseError(error_code);
+        header = response.build(keep_alive);
     }
 
-    write_buffer_ = std::move(response);
-    pending_buffer_ = write_buffer_;
-    logger_->log(LogLevel::DEBUG, info_, std::format("Pending buffer size: {}", formatSize(pending_buffer_.size())));
-    return true;
+    // 响应头与内存响应体作为一个片段，文件片段随后通过 sendfile 发送
+    logger_->log(LogLevel::DEBUG, info_, std::format("Queued response of {}", formatSize(header.size())));
+    output_queue_.push_back({.data = std::move(header)});
+
+    if (!response.isStreaming()) {
+        for (const auto& segment : response.segments()) {
+            logger_->log(LogLevel::DEBUG, info_, std::format("Queued file segment of {}", formatSize(segment.size())));
+            output_queue_.push_back(segment);
+        }
+        close_after_write_ = !keep_alive;
+        return;
+    }
+
+    // chunked 编码：已知长度的片段在此加上分块头尾，生成器在发送时按需拉取数据
+    for (const auto& segment : response.segments()) {
+        if (segment.producer) {
+            logger_->log(LogLevel::DEBUG, info_, "Queued streaming producer.");
+            output_queue_.push_back(segment);
+            continue;
+        }
+        if (segment.size() == 0) {
+            continue;
+        }
+
+        output_queue_.push_back({.data = std::format("{:x}\r\n", segment.size())});
+        output_queue_.push_back(segment);
+        output_queue_.push_back({.data = "\r\n"});
+    }
+    output_queue_.push_back({.data = "0\r\n\r\n"});
+
+    close_after_write_ = !keep_alive;
 }
 
 void Connection::handleWrite() const {
@@ -142,45 +745,211 @@ void Connection::handleWrite() const {
         logger_->log(LogLevel::WARNING, info_, "Connection already closed.");
         return;
     }
+    deadline_ = std::chrono::steady_clock::time_point::max();
+    idle_ = false;
+
+    while (true) {
+        if (!flushOutput()) {
+            return;
+        }
+
+        if (closeAfterWrite()) {
+            return;
+        }
+
+        // 长连接：缓冲区中可能还有未处理的完整请求
+        const bool parsed = tryParse();
+        if (cancel_token_.cancelled()) {
+            requestCloseConnection();
+            return;
+        }
+        if (!parsed) {
+            break;
+        }
+    }
+
+    if (draining_ && !http2_ && request_buffer_.empty()) {
+        // 优雅关闭期间响应已发送完毕，不再等待长连接上的下一个请求
+        requestCloseConnection();
+        return;
+    }
+
+    rearm(EPOLLIN | EPOLLET | EPOLLONESHOT);
+}
+
+bool Connection::closeAfterWrite() const {
+    if (!close_after_write_) {
+        return false;
+    }
 
-    while (!pending_buffer_.empty()) {
-        const ssize_t bytes_sent = send(client_fd_, pending_buffer_.data(), pending_buffer_.size(), 0);
+    if (linger_close_ && !lingering_) {
+        startLingeringClose();
+    } else {
+        requestCloseConnection();
+    }
+    return true;
+}
+
+bool Connection::flushOutput() const {
+    while (!output_queue_.empty()) {
+        if (output_queue_.front().producer) {
+            // 之前的数据已全部写入 socket，再生成下一块，内存占用与响应总长度无关
+            if (!pullProducer()) {
+                requestCloseConnection();
+                return false;
+            }
+            continue;
+        }
+
+        const ssize_t bytes_sent = output_queue_.front().file ? sendFileSegment() : sendMemorySegments();
 
         if (bytes_sent < 0) {
             if (errno == EAGAIN || errno == EWOULDBLOCK) {
-                epoll_manager_->modFd(client_fd_, EPOLLOUT | EPOLLET | EPOLLONESHOT);
-                return;
+                rearm(EPOLLOUT | EPOLLET | EPOLLONESHOT);
+                return false;
             }
-            if (errno == ECONNRESET) {
+            if (errno == ECONNRESET || errno == EPIPE) {
                 logger_->log(LogLevel::INFO, info_, "Connection reset by peer.");
             } else {
                 logger_->log(LogLevel::ERROR, info_, std::format("Failed to send response: {}", strerror(errno)));
             }
 
             requestCloseConnection();
-            return;
+            return false;
         }
 
-        pending_buffer_.remove_prefix(bytes_sent);
+        if (bytes_sent == 0 && output_queue_.front().file) {
+            // 文件在发送过程中被截断，无法满足已声明的 Content-Length
+            logger_->log(LogLevel::WARNING, info_, "File truncated while sending.");
+            requestCloseConnection();
+            return false;
+        }
     }
 
-    // 发送完毕
-    logger_->log(LogLevel::DEBUG, info_, std::format("Sent {} to client.", formatSize(write_buffer_.size())));
-    requestCloseConnection();
+    return true;
+}
+
+ssize_t Connection::sendMemorySegments() const {
+    std::array<iovec, MAX_IOV_COUNT> iov{};
+
+    // 将队首连续的内存片段合并为一次发送
+    size_t iov_count = 0;
+    for (auto iter = output_queue_.begin();
+         iter != output_queue_.end() && iter->isData() && iov_count < iov.size(); ++iter) {
+        const size_t skip = iov_count == 0 ? output_offset_ : 0;
+        const std::string_view data = iter->view();
+        // 发送不会修改数据，共享的缓存内容也可以直接引用
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+        iov.at(iov_count).iov_base = const_cast<char*>(data.data() + skip);
+        iov.at(iov_count).iov_len = data.size() - skip;
+        ++iov_count;
+    }
+
+    // 异步发送期间由后端持有连接，保证队列中被引用的数据有效
+    const ssize_t bytes_sent =
+        event_backend_->send(client_fd_, std::span<const iovec>(iov.data(), iov_count), shared_from_this());
+    if (bytes_sent <= 0) {
+        return bytes_sent;
+    }
+
+    // 弹出已完整发送的片段
+    auto remaining = static_cast<size_t>(bytes_sent);
+    while (remaining > 0) {
+        const size_t left = output_queue_.front().size() - output_offset_;
+        if (remaining < left) {
+            output_offset_ += remaining;
+            break;
+        }
+
+        remaining -= left;
+        logger_->log(LogLevel::DEBUG, info_,
+                     std::format("Sent {} to client.", formatSize(output_queue_.front().size())));
+        output_queue_.pop_front();
+        output_offset_ = 0;
+    }
+
+    return bytes_sent;
+}
+
+bool Connection::pullProducer() const {
+    std::string chunk;
+    bool more = false;
+
+    try {
+        more = output_queue_.front().producer(chunk);
+    } catch (const OperationCancelled&) {
+        logger_->log(LogLevel::INFO, info_, "Client disconnected, stopped producing response.");
+        return false;
+    } catch (const std::exception& e) {
+        // 响应头已发出，无法再返回错误页面，只能中断连接让客户端感知响应不完整
+        logger_->log(LogLevel::ERROR, info_, std::format("Exception while producing response: {}", e.what()));
+        return false;
+    }
+
+    if (!more) {
+        output_queue_.pop_front();
+    }
+    if (!chunk.empty()) {
+        const size_t chunk_size = chunk.size();
+        output_queue_.push_front({.data = std::format("{:x}\r\n{}\r\n", chunk_size, chunk)});
+        logger_->log(LogLevel::DEBUG, info_, std::format("Produced chunk of {}", formatSize(chunk_size)));
+    }
+
+    return true;
+}
+
+ssize_t Connection::sendFileSegment() const {
+    BodySegment& segment = output_queue_.front();
+
+    // 由内核直接从文件复制到 socket，每个下载的内存占用与文件大小无关
+    const ssize_t bytes_sent = sendfile(client_fd_, segment.file->get(), &segment.offset, segment.length);
+    if (bytes_sent <= 0) {
+        return bytes_sent;
+    }
+
+    segment.length -= static_cast<size_t>(bytes_sent);
+    if (segment.length == 0) {
+        logger_->log(LogLevel::DEBUG, info_, "Sent file segment to client.");
+        output_queue_.pop_front();
+    }
+
+    return bytes_sent;
 }
 
 HttpResponse Connection::handleRequest(const HttpRequest& request) const {
-    const std::string& method = request.method();
-    const std::string& path = request.path();
+    const std::string_view method = request.method();
+    const std::string_view path = request.path();
 
     logger_->log(LogLevel::DEBUG, info_, std::format("Handling {} for path: {}", method, path));
 
-    if (method == "GET") {
-        return handleGetRequest(request);
+    if (shedding_) {
+        // HTTP/2 连接上的新流在过载时同样直接拒绝
+        logger_->log(LogLevel::INFO, info_, "Server overloaded, rejecting request.");
+        constexpr int error_code = 503;
+        return HttpResponse::responseError(error_code);
     }
 
-    if (method == "POST") {
-        return handlePostRequest(request);
+    if (!watching_) {
+        // 目录列表、上传等处理可能耗时较长，期间客户端断开时尽早放弃
+        watchDisconnect();
+    }
+
+    try {
+        // Cookie 与会话在本次请求中只解析一次
+        const RequestContext context = user_manager_->createContext(request);
+
+        if (method == "GET") {
+            return handleGetRequest(context);
+        }
+
+        if (method == "POST") {
+            return handlePostRequest(context);
+        }
+    } catch (const OperationCancelled&) {
+        // 连接随后直接关闭，该响应不会被发送
+        logger_->log(LogLevel::INFO, info_, std::format("Client disconnected, abandoned {} {}.", method, path));
+        constexpr int error_code = 503;
+        return HttpResponse::responseError(error_code);
     }
 
     logger_->log(LogLevel::DEBUG, info_, std::format("Unsupported method: {} on path: {}", method, path));
@@ -188,10 +957,10 @@ HttpResponse Connection::handleRequest(const HttpRequest& request) const {
     return HttpResponse::responseError(error_code);
 }
 
-HttpResponse Connection::handleGetRequest(const HttpRequest& request) const {
-    const std::string& path = Url::decode(request.path());
+HttpResponse Connection::handleGetRequest(const RequestContext& context) const {
+    const std::string& path = Url::decode(context.request().path());
 
-    if (user_manager_->isLoggedIn(request)) {
+    if (context.isLoggedIn()) {
         static const std::string drive_url = '/' + static_file_->getDriveUrl() + '/';
         static const std::unordered_map<std::string, std::string> redirect_map = {
             {"/login", drive_url},    {"/login.htm", drive_url},    {"/login.html", drive_url},
@@ -213,40 +982,29 @@ HttpResponse Connection::handleGetRequest(const HttpRequest& request) const {
         }
     }
 
-    return static_file_->serve(request, info_);
+    return static_file_->serve(context, info_, cancel_token_);
 }
 
-HttpResponse Connection::handlePostRequest(const HttpRequest& request) const {
-    const std::string& path = request.path();
+HttpResponse Connection::handlePostRequest(const RequestContext& context) const {
+    const std::string_view path = context.request().path();
 
     if (path == "/login") {
-        return user_manager_->loginUser(request);
+        return user_manager_->loginUser(context);
     }
 
     if (path == "/register") {
-        return user_manager_->registerUser(request);
+        return user_manager_->registerUser(context);
     }
 
     if (path == "/reset-password") {
-        return user_manager_->changePassword(request);
+        return user_manager_->changePassword(context);
     }
 
     if (path == "/logout") {
-        return user_manager_->logoutUser(request);
-    }
-
-    if (path.ends_with("/upload")) {
-        if (!user_manager_->isLoggedIn(request)) {
-            // 如果用户未登录，则返回 401 错误
-            logger_->log(LogLevel::DEBUG, info_, "Unauthorized upload attempt.");
-            constexpr int error_code = 401;
-            return HttpResponse::responseError(error_code, "You must be logged in to upload files.");
-        }
-
-        const UploadFile upload(request, logger_, static_file_, info_);
-        return upload.process();
+        return user_manager_->logoutUser(context);
     }
 
+    // 上传请求在接收请求体时已由 UploadFile 处理（HTTP/1 见 parseRequest，HTTP/2 见 Http2Session），不会到达这里
     constexpr int error_code = 405;
     return HttpResponse::responseError(error_code);
 }
@@ -264,8 +1022,8 @@ void Connection::closeConnection() {
         return;
     }
 
-    // 从 epoll 中删除客户端 socket
-    epoll_manager_->delFd(client_fd_);
+    // 从事件后端中删除客户端 socket
+    event_backend_->delFd(client_fd_);
     close(client_fd_);
 
     logger_->log(LogLevel::INFO, info_, "Client disconnected.");
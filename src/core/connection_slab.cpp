@@ -0,0 +1,130 @@
+#include "core/connection_slab.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include <sys/resource.h>
+
+#include "core/connection.h"
+#include "core/event_backend.h"
+
+namespace {
+    const std::shared_ptr<Connection> no_connection;
+}  // namespace
+
+ConnectionSlab::ConnectionSlab(const size_t capacity) : capacity_(std::min(capacity, MAX_CAPACITY)) {}
+
+ConnectionSlab::Slot* ConnectionSlab::slotAt(const int fd) const {  // NOLINT(readability-identifier-length)
+    if (fd < 0 || static_cast<size_t>(fd) >= capacity_) {
+        return nullptr;
+    }
+
+    const auto index = static_cast<size_t>(fd);
+    const auto& chunk = chunks_.at(index >> CHUNK_SHIFT);
+    return chunk ? &chunk[index & (CHUNK_SIZE - 1)] : nullptr;
+}
+
+uint32_t ConnectionSlab::assign(const int fd) {  // NOLINT(readability-identifier-length)
+    if (fd < 0 || static_cast<size_t>(fd) >= capacity_) {
+        return 0;
+    }
+
+    auto& chunk = chunks_.at(static_cast<size_t>(fd) >> CHUNK_SHIFT);
+    if (!chunk) {
+        chunk = std::make_unique<Slot[]>(CHUNK_SIZE);  // NOLINT(cppcoreguidelines-avoid-c-arrays)
+    }
+
+    Slot& slot = *slotAt(fd);
+    uint32_t generation = slot.generation.load(std::memory_order_relaxed) + 1;
+    if (generation == 0) {
+        generation = 1;
+    }
+
+    // fd 能被再次 accept 说明旧连接已析构（析构时才 close），槽位必然已回收
+    slot.generation.store(generation, std::memory_order_relaxed);
+    slot.retired.store(false, std::memory_order_release);
+    return generation;
+}
+
+void ConnectionSlab::put(const int fd, std::shared_ptr<Connection> conn) {  // NOLINT(readability-identifier-length)
+    Slot& slot = *slotAt(fd);
+    if (!slot.conn) {
+        ++size_;
+    }
+    slot.conn = std::move(conn);
+}
+
+const std::shared_ptr<Connection>& ConnectionSlab::find(const uint64_t event_data) const {
+    const Slot* slot = slotAt(EventBackend::eventFd(event_data));
+    if (slot == nullptr ||
+        slot->generation.load(std::memory_order_relaxed) != EventBackend::eventGeneration(event_data) ||
+        slot->retired.load(std::memory_order_acquire)) {
+        return no_connection;
+    }
+    return slot->conn;
+}
+
+bool ConnectionSlab::retire(const int fd, const uint32_t generation) {  // NOLINT(readability-identifier-length)
+    Slot* slot = slotAt(fd);
+    if (slot == nullptr || slot->generation.load(std::memory_order_relaxed) != generation ||
+        slot->retired.exchange(true)) {
+        return false;
+    }
+
+    int head = retired_head_.load(std::memory_order_relaxed);
+    do {
+        slot->next_retired = head;
+    } while (!retired_head_.compare_exchange_weak(head, fd, std::memory_order_acq_rel, std::memory_order_relaxed));
+    return head == NO_FD;
+}
+
+size_t ConnectionSlab::reclaim() {
+    size_t reclaimed = 0;
+    for (int fd = retired_head_.exchange(NO_FD, std::memory_order_acq_rel); fd != NO_FD;) {  // NOLINT
+        Slot& slot = *slotAt(fd);
+        fd = slot.next_retired;
+        if (slot.conn) {
+            // 工作线程可能仍持有连接，最后一个引用释放时关闭 fd
+            slot.conn.reset();
+            --size_;
+            ++reclaimed;
+        }
+    }
+    return reclaimed;
+}
+
+void ConnectionSlab::clear() {
+    for (auto& chunk : chunks_) {
+        if (!chunk) {
+            continue;
+        }
+        for (size_t index = 0; index < CHUNK_SIZE && size_ > 0; ++index) {
+            if (chunk[index].conn) {
+                chunk[index].conn.reset();
+                --size_;
+            }
+        }
+        if (size_ == 0) {
+            return;
+        }
+    }
+}
+
+size_t ConnectionSlab::size() const {
+    return size_;
+}
+
+size_t ConnectionSlab::capacity() const {
+    return capacity_;
+}
+
+size_t ConnectionSlab::defaultCapacity() {
+    rlimit limit{};
+    if (getrlimit(RLIMIT_NOFILE, &limit) == -1 || limit.rlim_cur == RLIM_INFINITY) {
+        return MAX_CAPACITY;
+    }
+    return static_cast<size_t>(limit.rlim_cur);
+}
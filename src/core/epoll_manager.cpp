@@ -2,13 +2,19 @@
 
 #include <cstring>
 #include <format>
+#include <memory>
+#include <span>
 #include <stdexcept>
+#include <string>
 
 #include <sys/epoll.h>
 #include <sys/eventfd.h>
+#include <sys/socket.h>
 #include <unistd.h>
 
-EpollManager::EpollManager() : epoll_fd_(epoll_create1(0)) {
+#include "core/listener.h"
+
+EpollManager::EpollManager() : epoll_fd_(epoll_create1(EPOLL_CLOEXEC)) {
     if (epoll_fd_ == -1) {
         throw std::runtime_error("Failed to create epoll instance.");
     }
@@ -18,20 +24,22 @@ EpollManager::~EpollManager() {
     close(epoll_fd_);
 }
 
-void EpollManager::addFd(const int fd, const uint32_t events) const {  // NOLINT(readability-identifier-length)
+void EpollManager::addFd(const int fd, const uint32_t events,  // NOLINT(readability-identifier-length)
+                         const uint64_t data) const {
     epoll_event event{};
     event.events = events;
-    event.data.fd = fd;
+    event.data.u64 = data;
 
     if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event) == -1) {
         throw std::runtime_error(std::format("epoll_ctl ADD failed: {}", strerror(errno)));
     }
 }
 
-void EpollManager::modFd(const int fd, const uint32_t events) const {  // NOLINT(readability-identifier-length)
+void EpollManager::modFd(const int fd, const uint32_t events,  // NOLINT(readability-identifier-length)
+                         const uint64_t data) const {
     epoll_event event{};
     event.events = events;
-    event.data.fd = fd;
+    event.data.u64 = data;
 
     if (epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, fd, &event) == -1) {
         throw std::runtime_error(std::format("epoll_ctl MOD failed: {}", strerror(errno)));
@@ -44,10 +52,35 @@ void EpollManager::delFd(const int fd) const {  // NOLINT(readability-identifier
     }
 }
 
+void EpollManager::addListener(const Listener& listener, const uint64_t data) const {
+    addFd(listener.fd(), EPOLLIN | EPOLLET, data);
+}
+
+int EpollManager::accept(const Listener& listener, Address& peer) const {
+    return listener.accept(peer);
+}
+
+ssize_t EpollManager::receive(const int fd, const std::span<char> buffer) const {  // NOLINT
+    return recv(fd, buffer.data(), buffer.size(), 0);
+}
+
+ssize_t EpollManager::send(const int fd, const std::span<const iovec> iov,  // NOLINT(readability-identifier-length)
+                           const std::shared_ptr<const void>& /*owner*/) const {
+    msghdr message{};
+    // sendmsg 不会修改数据
+    message.msg_iov = const_cast<iovec*>(iov.data());  // NOLINT(cppcoreguidelines-pro-type-const-cast)
+    message.msg_iovlen = iov.size();
+    return sendmsg(fd, &message, MSG_NOSIGNAL);
+}
+
 int EpollManager::wait(std::span<epoll_event> events, const int timeout) const {
     return epoll_wait(epoll_fd_, events.data(), static_cast<int>(events.size()), timeout);
 }
 
+std::string EpollManager::name() const {
+    return "epoll";
+}
+
 int EpollManager::getEpollFd() const {
     return epoll_fd_;
 }
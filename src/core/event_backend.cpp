@@ -0,0 +1,23 @@
+#include "core/event_backend.h"
+
+#include <format>
+#include <memory>
+#include <string>
+
+#include "core/epoll_manager.h"
+#include "core/uring_manager.h"
+#include "utils/logger.h"
+
+std::unique_ptr<EventBackend> EventBackend::create(const std::string& name, Logger* logger) {
+    if (name == "io_uring") {
+        try {
+            return std::make_unique<UringManager>();
+        } catch (const std::exception& e) {
+            logger->log(LogLevel::WARNING, std::format("io_uring unavailable, falling back to epoll: {}", e.what()));
+        }
+    } else if (name != "epoll") {
+        logger->log(LogLevel::WARNING, std::format("Unknown event backend '{}', using epoll", name));
+    }
+
+    return std::make_unique<EpollManager>();
+}
@@ -0,0 +1,209 @@
+#include "core/hot_restart.h"
+
+#include <array>
+#include <cerrno>
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+#include <format>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "core/listener.h"
+#include "utils/logger.h"
+
+extern char** environ;  // NOLINT(readability-redundant-declaration)
+
+namespace {
+    // 每行一个继承的监听 socket："<fd> <监听地址>"
+    constexpr std::string_view LISTEN_FDS_ENV = "SKYDRIVE_LISTEN_FDS";
+    constexpr std::string_view READY_FD_ENV = "SKYDRIVE_READY_FD";
+
+    int parseFd(const std::string_view text) {
+        int fd = -1;  // NOLINT(readability-identifier-length)
+        const auto [ptr, errc] = std::from_chars(text.data(), text.data() + text.size(), fd);
+        if (errc != std::errc{} || ptr != text.data() + text.size() || fd < 0) {
+            return -1;
+        }
+        return fd;
+    }
+
+    // 读取并清除环境变量，避免再次重启时传给下一个进程
+    std::string takeEnv(const std::string_view name) {
+        const std::string key(name);
+        const char* value = getenv(key.c_str());  // NOLINT(concurrency-mt-unsafe)
+        if (value == nullptr) {
+            return "";
+        }
+
+        std::string result = value;
+        unsetenv(key.c_str());  // NOLINT(concurrency-mt-unsafe)
+        return result;
+    }
+}  // namespace
+
+HotRestart::HotRestart(Logger* logger) : logger_(logger) {
+    std::error_code error;
+    executable_ = std::filesystem::read_symlink("/proc/self/exe", error);
+    if (error) {
+        logger_->log(LogLevel::WARNING, std::format("Hot restart unavailable: {}", error.message()));
+    }
+
+    const std::string listen_fds = takeEnv(LISTEN_FDS_ENV);
+    for (size_t start = 0; start < listen_fds.size();) {
+        size_t end = listen_fds.find('\n', start);
+        if (end == std::string::npos) {
+            end = listen_fds.size();
+        }
+
+        const std::string_view line = std::string_view(listen_fds).substr(start, end - start);
+        start = end + 1;
+
+        const size_t space = line.find(' ');
+        const int fd = space == std::string_view::npos ? -1 : parseFd(line.substr(0, space));  // NOLINT
+        if (fd == -1) {
+            logger_->log(LogLevel::WARNING, std::format("Ignoring malformed inherited socket: {}", line));
+            continue;
+        }
+        inherited_.emplace(std::string(line.substr(space + 1)), fd);
+    }
+
+    if (const std::string ready = takeEnv(READY_FD_ENV); !ready.empty()) {
+        ready_fd_ = parseFd(ready);
+        if (ready_fd_ != -1) {
+            fcntl(ready_fd_, F_SETFD, FD_CLOEXEC);
+        }
+    }
+
+    if (!inherited_.empty()) {
+        logger_->log(LogLevel::INFO,
+                     std::format("Hot restart: inherited {} listening socket(s)", inherited_.size()));
+    }
+}
+
+HotRestart::~HotRestart() {
+    for (const auto& [address, fd] : inherited_) {
+        close(fd);
+    }
+    if (ready_fd_ != -1) {
+        close(ready_fd_);
+    }
+}
+
+int HotRestart::takeInherited(const ListenAddress& address) {
+    const auto iter = inherited_.find(address.toString());
+    if (iter == inherited_.end()) {
+        return -1;
+    }
+
+    const int fd = iter->second;  // NOLINT(readability-identifier-length)
+    inherited_.erase(iter);
+    return fd;
+}
+
+void HotRestart::notifyReady() {
+    // 配置中已删除的地址（或 Reactor 数量减少）多出的 socket 不再使用，旧进程退出后随之关闭
+    for (const auto& [address, fd] : inherited_) {
+        logger_->log(LogLevel::INFO, std::format("Closing unused inherited socket for {}", address));
+        close(fd);
+    }
+    inherited_.clear();
+
+    if (ready_fd_ == -1) {
+        return;
+    }
+
+    constexpr char ready = 1;
+    if (write(ready_fd_, &ready, sizeof(ready)) != sizeof(ready)) {
+        logger_->log(LogLevel::ERROR, std::format("Failed to notify old process: {}", strerror(errno)));
+    }
+    close(ready_fd_);
+    ready_fd_ = -1;
+}
+
+FileDescriptor HotRestart::spawn(const std::vector<std::shared_ptr<Listener>>& listeners) {
+    if (executable_.empty()) {
+        throw std::runtime_error("Executable path is unknown.");
+    }
+
+    std::array<int, 2> pipe_fds{};
+    if (pipe2(pipe_fds.data(), O_CLOEXEC) == -1) {
+        throw std::runtime_error(std::format("Failed to create pipe: {}", strerror(errno)));
+    }
+    FileDescriptor read_end(pipe_fds[0]);
+    const FileDescriptor write_end(pipe_fds[1]);
+
+    // fork 之后子进程中只能调用异步信号安全的函数，参数与环境变量需提前准备好
+    std::string listen_fds;
+    for (const auto& listener : listeners) {
+        listen_fds += std::format("{} {}\n", listener->fd(), listener->address().toString());
+    }
+
+    std::vector<std::string> env;
+    for (char** entry = environ; *entry != nullptr; ++entry) {  // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        const std::string_view variable = *entry;
+        if (!variable.starts_with(std::format("{}=", LISTEN_FDS_ENV)) &&
+            !variable.starts_with(std::format("{}=", READY_FD_ENV))) {
+            env.emplace_back(variable);
+        }
+    }
+    env.push_back(std::format("{}={}", LISTEN_FDS_ENV, listen_fds));
+    env.push_back(std::format("{}={}", READY_FD_ENV, write_end.get()));
+
+    std::vector<char*> envp;
+    envp.reserve(env.size() + 1);
+    for (auto& variable : env) {
+        envp.push_back(variable.data());
+    }
+    envp.push_back(nullptr);
+
+    std::string path = executable_.string();
+    std::array<char*, 2> argv{path.data(), nullptr};
+
+    const pid_t pid = fork();
+    if (pid == -1) {
+        throw std::runtime_error(std::format("Failed to fork: {}", strerror(errno)));
+    }
+
+    if (pid == 0) {
+        // 子进程：只为需要交接的 fd 清除 FD_CLOEXEC，其余 fd 在 exec 时关闭
+        for (const auto& listener : listeners) {
+            fcntl(listener->fd(), F_SETFD, 0);
+        }
+        fcntl(write_end.get(), F_SETFD, 0);
+
+        execve(path.c_str(), argv.data(), envp.data());
+        _exit(127);  // NOLINT(readability-magic-numbers, cppcoreguidelines-avoid-magic-numbers)
+    }
+
+    child_ = pid;
+    logger_->log(LogLevel::INFO, std::format("Hot restart: started {} (pid {})", path, pid));
+
+    // 写端在本进程中关闭，新进程退出时读端即可读到 EOF
+    return read_end;
+}
+
+bool HotRestart::checkReady(const int ready_fd) {
+    char ready = 0;
+    if (read(ready_fd, &ready, sizeof(ready)) == sizeof(ready)) {
+        logger_->log(LogLevel::INFO, std::format("Hot restart: new process (pid {}) is accepting connections", child_));
+        child_ = -1;
+        return true;
+    }
+
+    // 新进程在就绪前退出（配置错误、绑定失败等），本进程继续提供服务
+    int status = 0;
+    waitpid(child_, &status, 0);
+    logger_->log(LogLevel::ERROR,
+                 std::format("Hot restart failed: new process (pid {}) exited with status {}", child_,
+                             WIFEXITED(status) ? WEXITSTATUS(status) : -1));
+    child_ = -1;
+    return false;
+}
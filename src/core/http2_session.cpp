@@ -0,0 +1,1037 @@
+#include "core/http2_session.h"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "utils/base64.h"
+#include "utils/cancellation_token.h"
+#include "utils/logger.h"
+#include "utils/read_buffer.h"
+#include "utils/upload_file.h"
+
+// NOLINTBEGIN(readability-magic-numbers, cppcoreguidelines-avoid-magic-numbers)
+
+namespace {
+    // 帧类型
+    enum FrameType : uint8_t {
+        DATA = 0x0,
+        HEADERS = 0x1,
+        PRIORITY = 0x2,
+        RST_STREAM = 0x3,
+        SETTINGS = 0x4,
+        PUSH_PROMISE = 0x5,
+        PING = 0x6,
+        GOAWAY = 0x7,
+        WINDOW_UPDATE = 0x8,
+        CONTINUATION = 0x9,
+    };
+
+    // 帧标志
+    enum FrameFlag : uint8_t {
+        FLAG_END_STREAM = 0x1,
+        FLAG_ACK = 0x1,
+        FLAG_END_HEADERS = 0x4,
+        FLAG_PADDED = 0x8,
+        FLAG_PRIORITY = 0x20,
+    };
+
+    // SETTINGS 参数
+    enum SettingId : uint16_t {
+        SETTINGS_HEADER_TABLE_SIZE = 0x1,
+        SETTINGS_ENABLE_PUSH = 0x2,
+        SETTINGS_MAX_CONCURRENT_STREAMS = 0x3,
+        SETTINGS_INITIAL_WINDOW_SIZE = 0x4,
+        SETTINGS_MAX_FRAME_SIZE = 0x5,
+        SETTINGS_MAX_HEADER_LIST_SIZE = 0x6,
+    };
+
+    // 错误码
+    enum ErrorCode : uint32_t {
+        NO_ERROR = 0x0,
+        PROTOCOL_ERROR = 0x1,
+        INTERNAL_ERROR = 0x2,
+        FLOW_CONTROL_ERROR = 0x3,
+        STREAM_CLOSED = 0x5,
+        FRAME_SIZE_ERROR = 0x6,
+        REFUSED_STREAM = 0x7,
+        CANCEL = 0x8,
+        COMPRESSION_ERROR = 0x9,
+    };
+
+    constexpr size_t FRAME_HEADER_SIZE = 9;
+    constexpr size_t MAX_FRAME_SIZE_LIMIT = 16777215;
+
+    // 连接错误：以 GOAWAY 关闭整个连接
+    class ConnectionError : public std::runtime_error {
+    public:
+        ConnectionError(const uint32_t code, const std::string& message) : std::runtime_error(message), code_(code) {}
+
+        [[nodiscard]] uint32_t code() const { return code_; }
+
+    private:
+        uint32_t code_;
+    };
+
+    uint32_t readUint32(const std::string_view data, const size_t pos) {
+        return static_cast<uint32_t>(static_cast<uint8_t>(data[pos])) << 24 |
+               static_cast<uint32_t>(static_cast<uint8_t>(data[pos + 1])) << 16 |
+               static_cast<uint32_t>(static_cast<uint8_t>(data[pos + 2])) << 8 |
+               static_cast<uint32_t>(static_cast<uint8_t>(data[pos + 3]));
+    }
+
+    void appendUint32(std::string& out, const uint32_t value) {
+        out.push_back(static_cast<char>(value >> 24));
+        out.push_back(static_cast<char>(value >> 16));
+        out.push_back(static_cast<char>(value >> 8));
+        out.push_back(static_cast<char>(value));
+    }
+
+    void appendSetting(std::string& out, const uint16_t id, const uint32_t value) {
+        out.push_back(static_cast<char>(id >> 8));
+        out.push_back(static_cast<char>(id));
+        appendUint32(out, value);
+    }
+
+    std::string frameHeader(const size_t length, const uint8_t type, const uint8_t flags, const uint32_t stream_id) {
+        std::string header;
+        header.reserve(FRAME_HEADER_SIZE);
+        header.push_back(static_cast<char>(length >> 16));
+        header.push_back(static_cast<char>(length >> 8));
+        header.push_back(static_cast<char>(length));
+        header.push_back(static_cast<char>(type));
+        header.push_back(static_cast<char>(flags));
+        appendUint32(header, stream_id & 0x7fffffff);
+        return header;
+    }
+
+    // 去掉 PADDED 标志对应的填充，返回真正的负载
+    std::string_view stripPadding(const uint8_t flags, std::string_view payload) {
+        if ((flags & FLAG_PADDED) == 0) {
+            return payload;
+        }
+        if (payload.empty()) {
+            throw ConnectionError(FRAME_SIZE_ERROR, "Padded frame without pad length");
+        }
+
+        const auto pad_length = static_cast<uint8_t>(payload[0]);
+        if (pad_length >= payload.size()) {
+            throw ConnectionError(PROTOCOL_ERROR, "Padding exceeds frame payload");
+        }
+        return payload.substr(1, payload.size() - 1 - pad_length);
+    }
+
+    // "content-type" -> "Content-Type"，与 HTTP/1.1 解析得到的头部名称保持一致
+    std::string canonicalHeaderName(const std::string_view name) {
+        std::string canonical(name);
+        bool upper = true;
+        for (char& chr : canonical) {
+            if (upper) {
+                chr = static_cast<char>(std::toupper(static_cast<unsigned char>(chr)));
+            }
+            upper = chr == '-';
+        }
+        return canonical;
+    }
+
+    std::string toLower(std::string_view str) {
+        std::string lower(str);
+        std::ranges::transform(lower, lower.begin(), [](const unsigned char chr) { return std::tolower(chr); });
+        return lower;
+    }
+
+    // HTTP/2 中禁止出现的逐跳头部
+    bool isConnectionSpecific(const std::string_view name) {
+        constexpr std::array<std::string_view, 5> names = {"connection", "keep-alive", "proxy-connection",
+                                                           "transfer-encoding", "upgrade"};
+        return std::ranges::find(names, name) != names.end();
+    }
+
+    bool isDecimal(const std::string_view str) {
+        return !str.empty() && std::ranges::all_of(str, [](const unsigned char chr) { return std::isdigit(chr); });
+    }
+
+    // HTTP2-Settings 使用不带填充的 base64url 编码
+    std::string decodeBase64Url(std::string input) {
+        std::ranges::replace(input, '-', '+');
+        std::ranges::replace(input, '_', '/');
+        while (input.size() % 4 != 0) {
+            input.push_back('=');
+        }
+        return Base64::decode(input);
+    }
+}  // namespace
+
+Http2Session::Http2Session(std::deque<BodySegment>& output, RequestHandler handler, RequestFilter filter,
+                           BodyLimit body_limit, UploadFactory upload_factory, Logger* logger, const Address& info)
+    : output_(output),
+      handler_(std::move(handler)),
+      filter_(std::move(filter)),
+      body_limit_(std::move(body_limit)),
+      upload_factory_(std::move(upload_factory)),
+      logger_(logger),
+      info_(info) {}
+
+Http2Session::~Http2Session() = default;
+
+void Http2Session::upgrade(const HttpRequest& request, const std::string_view settings) {
+    const std::string payload = decodeBase64Url(std::string(settings));
+    if (payload.size() % 6 != 0) {
+        throw std::invalid_argument("Invalid HTTP2-Settings");
+    }
+
+    applySettings(payload);
+    output_.push_back({.data = "HTTP/1.1 101 Switching Protocols\r\nConnection: Upgrade\r\nUpgrade: h2c\r\n\r\n"});
+    sendPreface();
+
+    logger_->log(LogLevel::INFO, info_, "Upgraded to HTTP/2 (h2c).");
+
+    // 升级前的请求作为已半关闭的流 1 处理
+    last_stream_id_ = 1;
+    Stream& stream = streams_[1];
+    stream.headers_done = true;
+    stream.remote_closed = true;
+    stream.send_window = peer_initial_window_;
+    stream.recv_window = STREAM_WINDOW_SIZE;
+
+    HttpResponse response;
+    try {
+        response = handler_(request);
+    } catch (const std::exception& e) {
+        logger_->log(LogLevel::ERROR, info_, std::format("Exception while handling HTTP/2 stream 1: {}", e.what()));
+        constexpr int error_code = 500;
+        response = HttpResponse::responseError(error_code);
+    }
+    respond(1, stream, std::move(response));
+}
+
+bool Http2Session::process(ReadBuffer& buffer) {
+    if (goaway_sent_) {
+        buffer.clear();
+        return false;
+    }
+
+    sendPreface();
+
+    const std::string_view input = buffer.view();
+    size_t pos = 0;
+    try {
+        if (!preface_received_) {
+            if (input.size() < PREFACE.size()) {
+                if (!PREFACE.starts_with(input)) {
+                    throw ConnectionError(PROTOCOL_ERROR, "Invalid connection preface");
+                }
+                return true;
+            }
+            if (!input.starts_with(PREFACE)) {
+                throw ConnectionError(PROTOCOL_ERROR, "Invalid connection preface");
+            }
+
+            pos = PREFACE.size();
+            preface_received_ = true;
+        }
+
+        while (input.size() - pos >= FRAME_HEADER_SIZE) {
+            const std::string_view header = input.substr(pos, FRAME_HEADER_SIZE);
+            const size_t length = readUint32(header, 0) >> 8;
+            const auto type = static_cast<uint8_t>(header[3]);
+            const auto flags = static_cast<uint8_t>(header[4]);
+            const uint32_t stream_id = readUint32(header, 5) & 0x7fffffff;
+
+            if (length > DEFAULT_MAX_FRAME_SIZE) {
+                // 本端未修改 SETTINGS_MAX_FRAME_SIZE，超出默认值即为错误
+                throw ConnectionError(FRAME_SIZE_ERROR, std::format("Frame of {} bytes exceeds limit", length));
+            }
+            if (input.size() - pos - FRAME_HEADER_SIZE < length) {
+                break;  // 帧不完整
+            }
+
+            handleFrame(type, flags, stream_id, input.substr(pos + FRAME_HEADER_SIZE, length));
+            pos += FRAME_HEADER_SIZE + length;
+
+            if (goaway_sent_) {
+                break;
+            }
+        }
+    } catch (const ConnectionError& e) {
+        goAway(e.code(), e.what());
+    } catch (const std::invalid_argument& e) {
+        // HPACK 解码失败后双方的动态表已不同步，只能关闭连接
+        goAway(COMPRESSION_ERROR, e.what());
+    }
+
+    if (goaway_sent_) {
+        buffer.clear();
+        return false;
+    }
+
+    buffer.consume(pos);
+    std::erase_if(streams_, [](const auto& item) { return item.second.done; });
+    return !((goaway_received_ || draining_) && streams_.empty());
+}
+
+void Http2Session::shutdown() {
+    if (draining_ || goaway_sent_) {
+        return;
+    }
+    draining_ = true;
+
+    // 编号大于 last_stream_id_ 的流不会被处理，客户端可以在新连接上重试
+    sendPreface();
+    std::string payload;
+    appendUint32(payload, last_stream_id_);
+    appendUint32(payload, NO_ERROR);
+    queueFrame(GOAWAY, 0, 0, payload);
+
+    logger_->log(LogLevel::INFO, info_, "Sent GOAWAY for shutdown.");
+}
+
+bool Http2Session::idle() const {
+    return streams_.empty();
+}
+
+bool Http2Session::fillOutput() {
+    if (!preface_received_) {
+        // h2c 升级后等客户端的连接前言与 SETTINGS 到达后再发送流 1 的响应体
+        return false;
+    }
+
+    bool queued = false;
+    size_t bytes = 0;
+
+    // 每轮为每个流最多生成一个 DATA 帧，使并发的响应交错发送
+    bool progress = true;
+    while (progress && bytes < MAX_FILL_BYTES) {
+        progress = false;
+        for (auto& [stream_id, stream] : streams_) {
+            if (stream.done || stream.pending.empty()) {
+                continue;
+            }
+            if (sendData(stream_id, stream, bytes)) {
+                progress = true;
+                queued = true;
+            }
+        }
+    }
+
+    std::erase_if(streams_, [](const auto& item) { return item.second.done; });
+    return queued;
+}
+
+void Http2Session::handleFrame(const uint8_t type, const uint8_t flags, const uint32_t stream_id,
+                               const std::string_view payload) {
+    if (continuation_stream_ != 0 && (type != CONTINUATION || stream_id != continuation_stream_)) {
+        throw ConnectionError(PROTOCOL_ERROR, "Expected CONTINUATION frame");
+    }
+    if (!settings_received_ && type != SETTINGS) {
+        throw ConnectionError(PROTOCOL_ERROR, "First frame must be SETTINGS");
+    }
+
+    switch (type) {
+        case DATA:
+            handleData(flags, stream_id, payload);
+            break;
+        case HEADERS:
+            handleHeaders(flags, stream_id, payload);
+            break;
+        case PRIORITY:
+            // 不实现优先级调度，仅校验格式
+            if (stream_id == 0) {
+                throw ConnectionError(PROTOCOL_ERROR, "PRIORITY on stream 0");
+            }
+            if (payload.size() != 5) {
+                throw ConnectionError(FRAME_SIZE_ERROR, "Invalid PRIORITY frame size");
+            }
+            break;
+        case RST_STREAM:
+            handleRstStream(stream_id, payload);
+            break;
+        case SETTINGS:
+            handleSettings(flags, stream_id, payload);
+            break;
+        case PUSH_PROMISE:
+            throw ConnectionError(PROTOCOL_ERROR, "Client must not send PUSH_PROMISE");
+        case PING:
+            if (stream_id != 0) {
+                throw ConnectionError(PROTOCOL_ERROR, "PING on non-zero stream");
+            }
+            if (payload.size() != 8) {
+                throw ConnectionError(FRAME_SIZE_ERROR, "Invalid PING frame size");
+            }
+            if ((flags & FLAG_ACK) == 0) {
+                queueFrame(PING, FLAG_ACK, 0, payload);
+            }
+            break;
+        case GOAWAY:
+            if (stream_id != 0) {
+                throw ConnectionError(PROTOCOL_ERROR, "GOAWAY on non-zero stream");
+            }
+            handleGoAway(payload);
+            break;
+        case WINDOW_UPDATE:
+            handleWindowUpdate(stream_id, payload);
+            break;
+        case CONTINUATION:
+            handleContinuation(flags, stream_id, payload);
+            break;
+        default:
+            // 未知类型的帧必须忽略
+            break;
+    }
+}
+
+void Http2Session::handleData(const uint8_t flags, const uint32_t stream_id, const std::string_view payload) {
+    if (stream_id == 0) {
+        throw ConnectionError(PROTOCOL_ERROR, "DATA on stream 0");
+    }
+
+    // 流量控制按包含填充的完整负载计算
+    recv_window_ -= static_cast<int64_t>(payload.size());
+    if (recv_window_ < 0) {
+        throw ConnectionError(FLOW_CONTROL_ERROR, "Connection receive window exceeded");
+    }
+    if (recv_window_ < CONNECTION_WINDOW_SIZE / 2) {
+        queueWindowUpdate(0, static_cast<uint32_t>(CONNECTION_WINDOW_SIZE - recv_window_));
+        recv_window_ = CONNECTION_WINDOW_SIZE;
+    }
+
+    const std::string_view data = stripPadding(flags, payload);
+
+    const auto iter = streams_.find(stream_id);
+    if (iter == streams_.end() || !iter->second.headers_done || iter->second.remote_closed) {
+        if (stream_id > last_stream_id_) {
+            throw ConnectionError(PROTOCOL_ERROR, "DATA on idle stream");
+        }
+        resetStream(stream_id, STREAM_CLOSED);
+        return;
+    }
+
+    Stream& stream = iter->second;
+    stream.recv_window -= static_cast<int64_t>(payload.size());
+    if (stream.recv_window < 0) {
+        resetStream(stream_id, FLOW_CONTROL_ERROR);
+        streams_.erase(iter);
+        return;
+    }
+
+    if (stream.done) {
+        // 流已被本端重置，等待移除期间到达的数据直接丢弃
+        return;
+    }
+
+    if (stream.rejected) {
+        // 请求体已不需要：丢弃数据且不再补充流级窗口，对端最多再发送一个窗口的数据
+        stream.remote_closed = (flags & FLAG_END_STREAM) != 0;
+        stream.done = stream.remote_closed && stream.responded;
+        return;
+    }
+
+    if (stream.content_length && stream.body_received + data.size() > *stream.content_length) {
+        // DATA 帧的总长度超过声明的 content-length，请求格式错误（RFC 9113 §8.1.1）
+        logger_->log(LogLevel::INFO, info_, std::format("HTTP/2 stream {} body exceeds content-length.", stream_id));
+        resetStream(stream_id, PROTOCOL_ERROR);
+        streams_.erase(iter);
+        return;
+    }
+
+    if (stream.body_limit != 0 && stream.body_received + data.size() > stream.body_limit) {
+        logger_->log(LogLevel::INFO, info_, std::format("HTTP/2 stream {} body exceeds limit.", stream_id));
+        stream.remote_closed = (flags & FLAG_END_STREAM) != 0;
+        constexpr int error_code = 413;
+        reject(stream_id, stream, HttpResponse::responseError(error_code));
+        return;
+    }
+    stream.body_received += data.size();
+
+    if (stream.upload) {
+        // 与 HTTP/1 一样边接收边写入磁盘，内存占用与上传大小无关
+        try {
+            stream.upload->write(data);
+        } catch (const std::invalid_argument& e) {
+            logger_->log(LogLevel::INFO, info_,
+                         std::format("Invalid upload on HTTP/2 stream {}: {}", stream_id, e.what()));
+            stream.remote_closed = (flags & FLAG_END_STREAM) != 0;
+            constexpr int error_code = 400;
+            reject(stream_id, stream, HttpResponse::responseError(error_code));
+            return;
+        } catch (const OperationCancelled&) {
+            // 客户端已断开，未写完的文件已删除，连接随后关闭
+            logger_->log(LogLevel::INFO, info_,
+                         std::format("Client disconnected during upload on HTTP/2 stream {}.", stream_id));
+            resetStream(stream_id, CANCEL);
+            streams_.erase(iter);
+            return;
+        }
+    } else {
+        stream.body.append(data);
+    }
+
+    if ((flags & FLAG_END_STREAM) != 0) {
+        stream.remote_closed = true;
+        dispatch(stream_id, stream);
+        return;
+    }
+
+    if (stream.recv_window < STREAM_WINDOW_SIZE / 2) {
+        queueWindowUpdate(stream_id, static_cast<uint32_t>(STREAM_WINDOW_SIZE - stream.recv_window));
+        stream.recv_window = STREAM_WINDOW_SIZE;
+    }
+}
+
+void Http2Session::handleHeaders(const uint8_t flags, const uint32_t stream_id, const std::string_view payload) {
+    if (stream_id == 0 || stream_id % 2 == 0) {
+        throw ConnectionError(PROTOCOL_ERROR, std::format("HEADERS on invalid stream {}", stream_id));
+    }
+
+    std::string_view block = stripPadding(flags, payload);
+    if ((flags & FLAG_PRIORITY) != 0) {
+        if (block.size() < 5) {
+            throw ConnectionError(FRAME_SIZE_ERROR, "HEADERS priority field truncated");
+        }
+        block.remove_prefix(5);
+    }
+
+    Stream* stream = nullptr;
+    if (const auto iter = streams_.find(stream_id); iter != streams_.end()) {
+        // 已打开的流上再次收到 HEADERS，只能是携带 END_STREAM 的尾部字段
+        if (iter->second.remote_closed) {
+            throw ConnectionError(STREAM_CLOSED, std::format("HEADERS on closed stream {}", stream_id));
+        }
+        if ((flags & FLAG_END_STREAM) == 0) {
+            throw ConnectionError(PROTOCOL_ERROR, "Trailers without END_STREAM");
+        }
+        stream = &iter->second;
+    } else {
+        if (stream_id <= last_stream_id_) {
+            throw ConnectionError(STREAM_CLOSED, std::format("HEADERS on closed stream {}", stream_id));
+        }
+
+        const bool refused = streams_.size() >= MAX_CONCURRENT_STREAMS || goaway_received_ || draining_;
+        last_stream_id_ = stream_id;
+        stream = &streams_[stream_id];
+        stream->send_window = peer_initial_window_;
+        stream->recv_window = STREAM_WINDOW_SIZE;
+        stream->refused = refused;
+    }
+
+    stream->remote_closed = (flags & FLAG_END_STREAM) != 0;
+    stream->header_block.append(block);
+
+    if ((flags & FLAG_END_HEADERS) != 0) {
+        finishHeaders(stream_id, *stream);
+    } else {
+        continuation_stream_ = stream_id;
+    }
+}
+
+void Http2Session::handleContinuation(const uint8_t flags, const uint32_t stream_id,
+                                      const std::string_view payload) {
+    if (continuation_stream_ == 0) {
+        throw ConnectionError(PROTOCOL_ERROR, "Unexpected CONTINUATION frame");
+    }
+
+    Stream& stream = streams_.at(stream_id);
+    stream.header_block.append(payload);
+    if (stream.header_block.size() > HpackDecoder::DEFAULT_MAX_HEADER_LIST_SIZE) {
+        throw ConnectionError(PROTOCOL_ERROR, "Header block too large");
+    }
+
+    if ((flags & FLAG_END_HEADERS) != 0) {
+        continuation_stream_ = 0;
+        finishHeaders(stream_id, stream);
+    }
+}
+
+void Http2Session::finishHeaders(const uint32_t stream_id, Stream& stream) {
+    // 无论流是否被拒绝都必须解码头部块，保持动态表与对端同步
+    HeaderList headers = decoder_.decode(stream.header_block);
+    stream.header_block.clear();
+
+    if (stream.refused) {
+        logger_->log(LogLevel::WARNING, info_, std::format("Refused HTTP/2 stream {}.", stream_id));
+        resetStream(stream_id, REFUSED_STREAM);
+        streams_.erase(stream_id);
+        return;
+    }
+
+    if (!stream.headers_done) {
+        stream.headers = std::move(headers);
+        stream.headers_done = true;
+        if (!precheck(stream_id, stream)) {
+            return;
+        }
+    }
+
+    if (stream.rejected) {
+        // 被拒绝的流收到尾部字段，请求至此结束
+        stream.done = stream.remote_closed && stream.responded;
+        return;
+    }
+    if (stream.remote_closed) {
+        dispatch(stream_id, stream);
+    }
+}
+
+void Http2Session::handleSettings(const uint8_t flags, const uint32_t stream_id, const std::string_view payload) {
+    if (stream_id != 0) {
+        throw ConnectionError(PROTOCOL_ERROR, "SETTINGS on non-zero stream");
+    }
+
+    if ((flags & FLAG_ACK) != 0) {
+        if (!payload.empty()) {
+            throw ConnectionError(FRAME_SIZE_ERROR, "SETTINGS ACK with payload");
+        }
+        return;
+    }
+
+    if (payload.size() % 6 != 0) {
+        throw ConnectionError(FRAME_SIZE_ERROR, "Invalid SETTINGS frame size");
+    }
+
+    applySettings(payload);
+    settings_received_ = true;
+    queueFrame(SETTINGS, FLAG_ACK, 0);
+}
+
+void Http2Session::applySettings(const std::string_view payload) {
+    for (size_t pos = 0; pos + 6 <= payload.size(); pos += 6) {
+        const auto id = static_cast<uint16_t>(static_cast<uint8_t>(payload[pos]) << 8 |
+                                              static_cast<uint8_t>(payload[pos + 1]));
+        const uint32_t value = readUint32(payload, pos + 2);
+
+        switch (id) {
+            case SETTINGS_ENABLE_PUSH:
+                if (value > 1) {
+                    throw ConnectionError(PROTOCOL_ERROR, "Invalid SETTINGS_ENABLE_PUSH");
+                }
+                break;
+            case SETTINGS_INITIAL_WINDOW_SIZE: {
+                if (value > MAX_WINDOW_SIZE) {
+                    throw ConnectionError(FLOW_CONTROL_ERROR, "Invalid SETTINGS_INITIAL_WINDOW_SIZE");
+                }
+
+                // 初始窗口变化同时作用于所有已打开的流
+                const int64_t delta = static_cast<int64_t>(value) - peer_initial_window_;
+                for (auto& [_, stream] : streams_) {
+                    stream.send_window += delta;
+                    if (stream.send_window > MAX_WINDOW_SIZE) {
+                        throw ConnectionError(FLOW_CONTROL_ERROR, "Stream window overflow");
+                    }
+                }
+                peer_initial_window_ = value;
+                break;
+            }
+            case SETTINGS_MAX_FRAME_SIZE:
+                if (value < DEFAULT_MAX_FRAME_SIZE || value > MAX_FRAME_SIZE_LIMIT) {
+                    throw ConnectionError(PROTOCOL_ERROR, "Invalid SETTINGS_MAX_FRAME_SIZE");
+                }
+                peer_max_frame_size_ = value;
+                break;
+            default:
+                // 编码器不使用动态表，其余参数无需处理；未知参数必须忽略
+                break;
+        }
+    }
+}
+
+void Http2Session::handleWindowUpdate(const uint32_t stream_id, const std::string_view payload) {
+    if (payload.size() != 4) {
+        throw ConnectionError(FRAME_SIZE_ERROR, "Invalid WINDOW_UPDATE frame size");
+    }
+
+    const uint32_t increment = readUint32(payload, 0) & 0x7fffffff;
+    if (stream_id == 0) {
+        if (increment == 0) {
+            throw ConnectionError(PROTOCOL_ERROR, "WINDOW_UPDATE with zero increment");
+        }
+        send_window_ += increment;
+        if (send_window_ > MAX_WINDOW_SIZE) {
+            throw ConnectionError(FLOW_CONTROL_ERROR, "Connection window overflow");
+        }
+        return;
+    }
+
+    const auto iter = streams_.find(stream_id);
+    if (iter == streams_.end()) {
+        // 已关闭的流仍可能收到 WINDOW_UPDATE
+        return;
+    }
+
+    iter->second.send_window += increment;
+    if (increment == 0 || iter->second.send_window > MAX_WINDOW_SIZE) {
+        resetStream(stream_id, increment == 0 ? PROTOCOL_ERROR : FLOW_CONTROL_ERROR);
+        streams_.erase(iter);
+    }
+}
+
+void Http2Session::handleRstStream(const uint32_t stream_id, const std::string_view payload) {
+    if (stream_id == 0 || stream_id > last_stream_id_) {
+        throw ConnectionError(PROTOCOL_ERROR, "RST_STREAM on idle stream");
+    }
+    if (payload.size() != 4) {
+        throw ConnectionError(FRAME_SIZE_ERROR, "Invalid RST_STREAM frame size");
+    }
+
+    logger_->log(LogLevel::DEBUG, info_,
+                 std::format("HTTP/2 stream {} reset by peer (error {}).", stream_id, readUint32(payload, 0)));
+    streams_.erase(stream_id);
+}
+
+void Http2Session::handleGoAway(const std::string_view payload) {
+    if (payload.size() < 8) {
+        throw ConnectionError(FRAME_SIZE_ERROR, "Invalid GOAWAY frame size");
+    }
+
+    // 对端不再发起新的流，已接受的流仍然正常完成
+    goaway_received_ = true;
+    logger_->log(LogLevel::INFO, info_, std::format("Received GOAWAY (error {}).", readUint32(payload, 4)));
+}
+
+bool Http2Session::precheck(const uint32_t stream_id, Stream& stream) {
+    std::optional<HttpResponse> rejection;
+    try {
+        const HttpRequest request = buildRequest(stream, {});
+        if (request.getHeader(HttpHeader::CONTENT_LENGTH)) {
+            stream.content_length = request.contentLength();
+        }
+        if (body_limit_) {
+            stream.body_limit = body_limit_(request);
+        }
+        if (filter_) {
+            rejection = filter_(request);
+        }
+        if (!rejection && upload_factory_) {
+            stream.upload = upload_factory_(request);
+            if (stream.upload && stream.upload->rejection()) {
+                rejection = *stream.upload->rejection();
+            }
+        }
+    } catch (const std::invalid_argument& e) {
+        logger_->log(LogLevel::INFO, info_, std::format("Malformed HTTP/2 request: {}", e.what()));
+        resetStream(stream_id, PROTOCOL_ERROR);
+        stream.done = true;
+        return false;
+    }
+
+    if (rejection) {
+        reject(stream_id, stream, std::move(*rejection));
+        return false;
+    }
+    return true;
+}
+
+void Http2Session::reject(const uint32_t stream_id, Stream& stream, HttpResponse response) {
+    // 不等请求体收完即响应。不发送 RST_STREAM(NO_ERROR)：部分客户端（如 curl 7.x）会因此丢弃已收到的响应，
+    // 收到完整响应的客户端通常会自行停止上传
+    stream.rejected = true;
+    stream.body.clear();
+    stream.upload.reset();
+    respond(stream_id, stream, std::move(response));
+}
+
+void Http2Session::dispatch(const uint32_t stream_id, Stream& stream) {
+    if (stream.content_length && stream.body_received != *stream.content_length) {
+        // 请求体在声明的长度之前结束，请求格式错误；未写完的上传文件随 UploadFile 一起删除
+        logger_->log(LogLevel::INFO, info_,
+                     std::format("HTTP/2 stream {} body shorter than content-length.", stream_id));
+        stream.upload.reset();
+        resetStream(stream_id, PROTOCOL_ERROR);
+        stream.done = true;
+        return;
+    }
+
+    if (stream.upload) {
+        // 上传的请求体已在到达时写入磁盘，只需生成结果
+        logger_->log(LogLevel::DEBUG, info_,
+                     std::format("Received upload of {} bytes on HTTP/2 stream {}.", stream.body_received, stream_id));
+        HttpResponse response;
+        try {
+            response = stream.upload->finish();
+        } catch (const std::exception& e) {
+            logger_->log(LogLevel::ERROR, info_,
+                         std::format("Exception while finishing upload on HTTP/2 stream {}: {}", stream_id, e.what()));
+            constexpr int error_code = 500;
+            response = HttpResponse::responseError(error_code);
+        }
+        stream.upload.reset();
+        respond(stream_id, stream, std::move(response));
+        return;
+    }
+
+    HttpRequest request;
+    try {
+        request = buildRequest(stream, std::move(stream.body));
+    } catch (const std::invalid_argument& e) {
+        logger_->log(LogLevel::INFO, info_, std::format("Malformed HTTP/2 request: {}", e.what()));
+        resetStream(stream_id, PROTOCOL_ERROR);
+        stream.done = true;
+        return;
+    }
+
+    logger_->log(LogLevel::DEBUG, info_,
+                 std::format("HTTP/2 stream {}: {} {}", stream_id, request.method(), request.path()));
+
+    HttpResponse response;
+    try {
+        response = handler_(request);
+    } catch (const std::exception& e) {
+        logger_->log(LogLevel::ERROR, info_,
+                     std::format("Exception while handling HTTP/2 stream {}: {}", stream_id, e.what()));
+        constexpr int error_code = 500;
+        response = HttpResponse::responseError(error_code);
+    }
+
+    respond(stream_id, stream, std::move(response));
+}
+
+HttpRequest Http2Session::buildRequest(const Stream& stream, std::string body) const {
+    std::string method;
+    std::string path;
+    std::string authority;
+    std::unordered_map<std::string, std::string> headers;
+
+    for (const auto& [name, value] : stream.headers) {
+        if (name.starts_with(':')) {
+            if (name == ":method") {
+                method = value;
+            } else if (name == ":path") {
+                path = value;
+            } else if (name == ":authority") {
+                authority = value;
+            } else if (name != ":scheme") {
+                throw std::invalid_argument("Unknown pseudo-header " + name);
+            }
+            continue;
+        }
+
+        if (std::ranges::any_of(name, [](const unsigned char chr) { return std::isupper(chr); })) {
+            throw std::invalid_argument("Uppercase header name " + name);
+        }
+        // HTTP/2 不使用逐跳头部，TE 只允许 trailers（RFC 9113 §8.2.2）
+        if (isConnectionSpecific(name) || (name == "te" && value != "trailers")) {
+            throw std::invalid_argument("Connection-specific header " + name);
+        }
+
+        // 同名头部合并，Cookie 可被拆分为多个字段发送
+        std::string key = canonicalHeaderName(name);
+        if (const auto iter = headers.find(key); iter != headers.end()) {
+            if (name == "content-length") {
+                // 多个取值不同的 content-length 无法与 DATA 帧的总长度对照
+                if (iter->second != value) {
+                    throw std::invalid_argument("Conflicting content-length");
+                }
+                continue;
+            }
+            iter->second += (key == "Cookie" ? "; " : ", ") + value;
+        } else {
+            headers.emplace(std::move(key), value);
+        }
+    }
+
+    if (method.empty() || path.empty()) {
+        throw std::invalid_argument("Missing :method or :path");
+    }
+    if (const auto iter = headers.find("Content-Length"); iter != headers.end() && !isDecimal(iter->second)) {
+        throw std::invalid_argument("Invalid content-length " + iter->second);
+    }
+    if (!authority.empty() && !headers.contains("Host")) {
+        headers.emplace("Host", std::move(authority));
+    }
+
+    return HttpRequest::fromParts(method, path, "HTTP/2.0", headers, std::move(body));
+}
+
+void Http2Session::respond(const uint32_t stream_id, Stream& stream, HttpResponse response) {
+    std::vector<BodySegment> body = response.takeBody();
+    std::erase_if(body, [](const BodySegment& segment) { return segment.isData() && segment.size() == 0; });
+
+    const bool streaming =
+        std::ranges::any_of(body, [](const BodySegment& segment) { return static_cast<bool>(segment.producer); });
+
+    HeaderList headers;
+    headers.emplace_back(":status", response.status().substr(0, 3));
+    response.forEachHeader([&headers](const std::string_view key, const std::string_view value) {
+        std::string name = toLower(key);
+        if (isConnectionSpecific(name) || name == "content-length") {
+            return;
+        }
+        headers.emplace_back(std::move(name), value);
+    });
+    if (!streaming) {
+        size_t content_length = 0;
+        for (const auto& segment : body) {
+            content_length += segment.size();
+        }
+        headers.emplace_back("content-length", std::to_string(content_length));
+    }
+
+    queueHeaders(stream_id, HpackEncoder::encode(headers), body.empty());
+    if (body.empty()) {
+        finishStream(stream);
+        return;
+    }
+
+    // 响应体由 fillOutput() 按流量控制窗口分帧发送
+    std::ranges::move(body, std::back_inserter(stream.pending));
+}
+
+bool Http2Session::sendData(const uint32_t stream_id, Stream& stream, size_t& bytes) {
+    while (!stream.pending.empty()) {
+        BodySegment& front = stream.pending.front();
+
+        if (front.producer) {
+            std::string chunk;
+            bool more = false;
+            try {
+                more = front.producer(chunk);
+            } catch (const std::exception& e) {
+                logger_->log(LogLevel::ERROR, info_,
+                             std::format("Exception while producing HTTP/2 stream {}: {}", stream_id, e.what()));
+                resetStream(stream_id, INTERNAL_ERROR);
+                stream.pending.clear();
+                stream.done = true;
+                return true;
+            }
+
+            if (!more) {
+                stream.pending.pop_front();
+            }
+            if (!chunk.empty()) {
+                stream.pending.push_front({.data = std::move(chunk)});
+            }
+            continue;
+        }
+
+        const size_t remaining = front.file ? front.length : front.size() - stream.pending_offset;
+        if (remaining == 0) {
+            stream.pending.pop_front();
+            stream.pending_offset = 0;
+            continue;
+        }
+
+        const int64_t window = std::min(stream.send_window, send_window_);
+        if (window <= 0) {
+            return false;  // 等待对端 WINDOW_UPDATE
+        }
+
+        const size_t length = std::min({remaining, static_cast<size_t>(window), peer_max_frame_size_});
+        const bool last = length == remaining && stream.pending.size() == 1;
+        const uint8_t flags = last ? FLAG_END_STREAM : 0;
+
+        if (front.file) {
+            // 帧头走内存，帧负载仍由 sendfile 直接从文件发送
+            output_.push_back({.data = frameHeader(length, DATA, flags, stream_id)});
+            output_.push_back({.file = front.file, .offset = front.offset, .length = length});
+            front.offset += static_cast<off_t>(length);
+            front.length -= length;
+            if (front.length == 0) {
+                stream.pending.pop_front();
+            }
+        } else {
+            std::string frame = frameHeader(length, DATA, flags, stream_id);
+            frame.append(front.view().substr(stream.pending_offset, length));
+            output_.push_back({.data = std::move(frame)});
+            stream.pending_offset += length;
+            if (stream.pending_offset == front.size()) {
+                stream.pending.pop_front();
+                stream.pending_offset = 0;
+            }
+        }
+
+        stream.send_window -= static_cast<int64_t>(length);
+        send_window_ -= static_cast<int64_t>(length);
+        bytes += length;
+        if (last) {
+            finishStream(stream);
+        }
+        return true;
+    }
+
+    // 生成器结束后没有剩余数据，以空 DATA 帧结束流
+    queueFrame(DATA, FLAG_END_STREAM, stream_id);
+    finishStream(stream);
+    return true;
+}
+
+void Http2Session::finishStream(Stream& stream) {
+    // 提前响应的流在对端结束发送前保留，其后续的 DATA 帧直接丢弃
+    stream.responded = true;
+    stream.done = stream.remote_closed;
+}
+
+void Http2Session::sendPreface() {
+    if (preface_sent_) {
+        return;
+    }
+    preface_sent_ = true;
+
+    std::string settings;
+    appendSetting(settings, SETTINGS_MAX_CONCURRENT_STREAMS, MAX_CONCURRENT_STREAMS);
+    appendSetting(settings, SETTINGS_INITIAL_WINDOW_SIZE, STREAM_WINDOW_SIZE);
+    appendSetting(settings, SETTINGS_MAX_HEADER_LIST_SIZE, HpackDecoder::DEFAULT_MAX_HEADER_LIST_SIZE);
+    queueFrame(SETTINGS, 0, 0, settings);
+
+    // 放大连接级接收窗口，避免上传被默认的 64KB 窗口限速
+    queueWindowUpdate(0, static_cast<uint32_t>(CONNECTION_WINDOW_SIZE - DEFAULT_WINDOW_SIZE));
+}
+
+void Http2Session::queueFrame(const uint8_t type, const uint8_t flags, const uint32_t stream_id,
+                              const std::string_view payload) {
+    std::string frame = frameHeader(payload.size(), type, flags, stream_id);
+    frame.append(payload);
+    output_.push_back({.data = std::move(frame)});
+}
+
+void Http2Session::queueHeaders(const uint32_t stream_id, const std::string& block, const bool end_stream) {
+    // 超过对端最大帧长度的头部块拆分为 HEADERS + CONTINUATION
+    size_t offset = 0;
+    bool first = true;
+    do {
+        const size_t length = std::min(block.size() - offset, peer_max_frame_size_);
+        const bool last = offset + length == block.size();
+
+        uint8_t flags = last ? FLAG_END_HEADERS : 0;
+        if (first && end_stream) {
+            flags |= FLAG_END_STREAM;
+        }
+        queueFrame(first ? HEADERS : CONTINUATION, flags, stream_id, std::string_view(block).substr(offset, length));
+
+        offset += length;
+        first = false;
+    } while (offset < block.size());
+}
+
+void Http2Session::queueWindowUpdate(const uint32_t stream_id, const uint32_t increment) {
+    std::string payload;
+    appendUint32(payload, increment);
+    queueFrame(WINDOW_UPDATE, 0, stream_id, payload);
+}
+
+void Http2Session::resetStream(const uint32_t stream_id, const uint32_t error_code) {
+    std::string payload;
+    appendUint32(payload, error_code);
+    queueFrame(RST_STREAM, 0, stream_id, payload);
+}
+
+void Http2Session::goAway(const uint32_t error_code, const std::string& reason) {
+    std::string payload;
+    appendUint32(payload, last_stream_id_);
+    appendUint32(payload, error_code);
+    payload += reason;
+    queueFrame(GOAWAY, 0, 0, payload);
+    goaway_sent_ = true;
+
+    logger_->log(LogLevel::WARNING, info_, std::format("HTTP/2 connection error {}: {}", error_code, reason));
+}
+
+// NOLINTEND(readability-magic-numbers, cppcoreguidelines-avoid-magic-numbers)
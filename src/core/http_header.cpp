@@ -0,0 +1,58 @@
+#include "core/http_header.h"
+
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <string_view>
+
+#include "utils/perfect_hash.h"
+
+namespace {
+    constexpr std::array<std::string_view, HTTP_HEADER_COUNT> HEADER_NAMES = {
+        "Accept",
+        "Accept-Encoding",
+        "Accept-Ranges",
+        "Authorization",
+        "Cache-Control",
+        "Connection",
+        "Content-Disposition",
+        "Content-Length",
+        "Content-Range",
+        "Content-Type",
+        "Cookie",
+        "Date",
+        "ETag",
+        "Expect",
+        "Host",
+        "HTTP2-Settings",
+        "If-Modified-Since",
+        "If-None-Match",
+        "If-Range",
+        "Last-Modified",
+        "Location",
+        "Range",
+        "Referer",
+        "Retry-After",
+        "Set-Cookie",
+        "Transfer-Encoding",
+        "Upgrade",
+        "User-Agent",
+    };
+
+    constexpr PerfectHash<HTTP_HEADER_COUNT> HEADER_TABLE(HEADER_NAMES);
+
+    static_assert(HEADER_TABLE.find("content-length") == HttpHeaders::index(HttpHeader::CONTENT_LENGTH));
+    static_assert(HEADER_TABLE.find("USER-AGENT") == HttpHeaders::index(HttpHeader::USER_AGENT));
+    static_assert(!HEADER_TABLE.find("X-Forwarded-For"));
+}  // namespace
+
+std::optional<HttpHeader> HttpHeaders::find(const std::string_view name) {
+    if (const auto index = HEADER_TABLE.find(name)) {
+        return static_cast<HttpHeader>(*index);
+    }
+    return std::nullopt;
+}
+
+std::string_view HttpHeaders::name(const HttpHeader header) {
+    return HEADER_NAMES[index(header)];
+}
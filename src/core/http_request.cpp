@@ -1,104 +1,301 @@
 #include "core/http_request.h"
 
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <charconv>
 #include <cstddef>
-#include <sstream>
+#include <memory_resource>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <utility>
 
-bool HttpRequest::parseHeader(const std::string& raw) {
+#include "utils/byte_scanner.h"
+#include "utils/request_arena.h"
+
+namespace {
+    bool equalsIgnoreCase(const std::string_view lhs, const std::string_view rhs) {
+        return std::ranges::equal(lhs, rhs, [](const unsigned char lhs_chr, const unsigned char rhs_chr) {
+            return std::tolower(lhs_chr) == std::tolower(rhs_chr);
+        });
+    }
+
+    constexpr std::string_view CRLF = "\r\n";
+    constexpr std::string_view HEADER_END = "\r\n\r\n";
+}  // namespace
+
+HttpRequest::HttpRequest() : HttpRequest(RequestArena::resource()) {}
+
+HttpRequest::HttpRequest(std::pmr::memory_resource* resource) : storage_(resource), headers_(resource) {}
+
+HttpRequest HttpRequest::fromParts(const std::string_view method, const std::string_view path,
+                                   const std::string_view version,
+                                   const std::unordered_map<std::string, std::string>& headers, std::string body) {
+    HttpRequest request;
+    std::pmr::string& storage = request.storage_;
+
+    size_t total = method.size() + path.size() + version.size();
+    for (const auto& [key, value] : headers) {
+        total += key.size() + value.size();
+    }
+    storage.reserve(total);
+
+    const auto append = [&storage](const std::string_view part) {
+        const Field field{.offset = storage.size(), .length = part.size()};
+        storage.append(part);
+        return field;
+    };
+
+    request.method_ = append(method);
+    request.path_ = append(path);
+    request.version_ = append(version);
+    request.headers_.reserve(headers.size());
+    for (const auto& [key, value] : headers) {
+        const Field name = append(key);
+        request.addHeader(name, append(value));
+    }
+    request.body_ = std::move(body);
+    request.header_parsed_ = true;
+
+    // 用于在请求体到达前检查声明的长度，格式错误时按未声明处理
+    if (const auto value = request.getHeader(HttpHeader::CONTENT_LENGTH)) {
+        std::from_chars(value->data(), value->data() + value->size(), request.content_length_);
+    }
+    return request;
+}
+
+bool HttpRequest::parseHeader(const std::string_view raw) {
+    raw_ = raw;
     if (header_parsed_) {
         return true;
     }
 
-    header_end_pos_ = raw.find("\r\n\r\n");
+    // 结尾标记可能跨越两次接收，回退 3 个字节后继续查找，已扫描过的数据不再重复扫描
+    const size_t scan_from = header_scan_pos_ > HEADER_END.size() - 1 ? header_scan_pos_ - (HEADER_END.size() - 1) : 0;
+    header_end_pos_ = ByteScanner::findHeaderEnd(raw, scan_from);
     if (header_end_pos_ == std::string::npos) {
+        header_scan_pos_ = raw.size();
         return false;  // 请求头不完整
     }
 
     // 提取请求行
-    const size_t request_line_end = raw.find("\r\n");
-    {
-        std::istringstream iss(raw.substr(0, request_line_end));
-        iss >> method_ >> path_ >> version_;
-        if (method_.empty() || path_.empty() || version_.empty()) {
-            throw std::invalid_argument("Invalid HTTP request line");
-        }
+    const size_t request_line_end = ByteScanner::findCrlf(raw);
+    parseRequestLine(raw.substr(0, request_line_end));
+
+    // 提取请求头，每行只扫描一次，名称与值只记录位置
+    headers_.clear();
+    known_headers_.fill(0);
+    for (size_t line_start = request_line_end + CRLF.size(); line_start < header_end_pos_;) {
+        const size_t line_end = ByteScanner::findCrlf(raw, line_start);
+        parseHeaderLine(raw.substr(line_start, line_end - line_start), line_start);
+        line_start = line_end + CRLF.size();
     }
 
-    // 提取请求头
-    const size_t headers_start = request_line_end + 2;
-    const size_t headers_end = header_end_pos_;
-    std::istringstream iss(raw.substr(headers_start, headers_end - headers_start));
+    parseFraming();
+    header_parsed_ = true;
+    return true;
+}
 
-    std::string line;
-    while (std::getline(iss, line) && !line.empty()) {
-        if (line.back() == '\r') {
-            line.pop_back();
-        }
+void HttpRequest::parseBody(const std::string_view raw) {
+    if (!header_parsed_) {
+        throw std::logic_error("Cannot parse body before parsing headers");
+    }
+    raw_ = raw;
 
-        if (const size_t colon_pos = line.find(':'); colon_pos != std::string::npos) {
-            std::string key = line.substr(0, colon_pos);
-            std::string value = line.substr(colon_pos + 1);
-            trim(key);
-            trim(value);
-            headers_[key] = value;
-        }
+    if (chunked_) {
+        // chunked 请求体已在 parseChunkedBody() 中解码
+        return;
     }
 
-    if (const auto iter = headers_.find("Content-Length"); iter != headers_.end()) {
-        content_length_ = std::stoul(iter->second);
+    // 请求体同样只记录位置
+    const size_t body_start = header_end_pos_ + HEADER_END.size();
+    body_field_ = {.offset = body_start,
+                   .length = body_start < raw.size() ? std::min(raw.size() - body_start, content_length_) : 0};
+}
+
+bool HttpRequest::parseChunkedBody(const std::string_view raw) {
+    if (!header_parsed_ || !chunked_) {
+        throw std::logic_error("Request body is not chunked");
     }
+    raw_ = raw;
 
-    header_parsed_ = true;
-    return true;
+    const bool done = decodeChunks(raw, chunk_pos_, [this](const std::string_view data) { body_.append(data); });
+    if (done) {
+        body_end_pos_ = chunk_pos_;
+    }
+    return done;
 }
 
-void HttpRequest::parseBody(const std::string& raw) {
+void HttpRequest::retainHeader() {
+    if (!header_parsed_ || !storage_.empty()) {
+        return;
+    }
+    // 请求头位于原始数据开头，复制后各字段的位置不变
+    storage_.assign(raw_.substr(0, headerLength()));
+}
+
+size_t HttpRequest::streamBody(const std::string_view raw, const BodySink& sink) {
     if (!header_parsed_) {
-        throw std::logic_error("Cannot parse body before parsing headers");
+        throw std::logic_error("Cannot stream body before parsing headers");
+    }
+
+    if (chunked_) {
+        size_t pos = 0;
+        decodeChunks(raw, pos, sink);
+        return pos;
     }
 
-    // 提取请求体
-    if (const size_t body_start = header_end_pos_ + 4; body_start < raw.size()) {
-        body_ = raw.substr(body_start, content_length_);
-    } else {
-        body_.clear();
+    const size_t length = std::min(raw.size(), content_length_ - body_received_);
+    if (length > 0) {
+        sink(raw.substr(0, length));
+        body_received_ += length;
     }
+    return length;
+}
+
+bool HttpRequest::isBodyComplete() const {
+    return chunked_ ? chunk_state_ == ChunkState::DONE : body_received_ == content_length_;
+}
+
+size_t HttpRequest::bodyReceived() const {
+    return body_received_;
+}
+
+bool HttpRequest::decodeChunks(const std::string_view raw, size_t& pos, const BodySink& sink) {
+    // 从上次停下的位置继续，已解码的数据不会重复扫描
+    while (chunk_state_ != ChunkState::DONE) {
+        switch (chunk_state_) {
+            case ChunkState::SIZE: {
+                const size_t line_end = ByteScanner::findCrlf(raw, pos);
+                if (line_end == std::string::npos) {
+                    if (raw.size() - pos > MAX_CHUNK_LINE_LENGTH) {
+                        throw std::invalid_argument("Chunk size line too long");
+                    }
+                    return false;
+                }
+
+                // 分块大小为十六进制，其后可能带有 ";ext" 扩展，直接忽略
+                const char* begin = raw.data() + pos;
+                const char* end = raw.data() + line_end;
+                constexpr int hex_base = 16;
+                size_t chunk_size = 0;
+                const auto [ptr, errc] = std::from_chars(begin, end, chunk_size, hex_base);
+                if (errc != std::errc{} || (ptr != end && *ptr != ';' && *ptr != ' ' && *ptr != '\t')) {
+                    throw std::invalid_argument("Invalid chunk size");
+                }
+
+                pos = line_end + 2;
+                chunk_remaining_ = chunk_size;
+                chunk_state_ = chunk_size == 0 ? ChunkState::TRAILER : ChunkState::DATA;
+                break;
+            }
+            case ChunkState::DATA: {
+                const size_t available = std::min(raw.size() - pos, chunk_remaining_);
+                if (available > 0) {
+                    sink(raw.substr(pos, available));
+                    body_received_ += available;
+                }
+                pos += available;
+                chunk_remaining_ -= available;
+                if (chunk_remaining_ > 0) {
+                    return false;
+                }
+                chunk_state_ = ChunkState::DATA_END;
+                break;
+            }
+            case ChunkState::DATA_END:
+                if (raw.size() - pos < 2) {
+                    return false;
+                }
+                if (raw.compare(pos, 2, "\r\n") != 0) {
+                    throw std::invalid_argument("Missing CRLF after chunk data");
+                }
+                pos += 2;
+                chunk_state_ = ChunkState::SIZE;
+                break;
+            case ChunkState::TRAILER: {
+                const size_t line_end = ByteScanner::findCrlf(raw, pos);
+                if (line_end == std::string::npos) {
+                    if (raw.size() - pos > MAX_CHUNK_LINE_LENGTH) {
+                        throw std::invalid_argument("Trailer field too long");
+                    }
+                    return false;
+                }
+
+                // 尾部字段不参与处理，遇到空行即请求结束
+                if (line_end == pos) {
+                    chunk_state_ = ChunkState::DONE;
+                }
+                pos = line_end + 2;
+                break;
+            }
+            case ChunkState::DONE:
+                break;
+        }
+    }
+
+    return true;
 }
 
 size_t HttpRequest::totalExpectedLength() const {
-    return header_end_pos_ != std::string::npos ? header_end_pos_ + 4 + content_length_ : std::string::npos;
+    if (chunked_) {
+        return body_end_pos_;
+    }
+    return header_end_pos_ != std::string::npos ? header_end_pos_ + HEADER_END.size() + content_length_ : std::string::npos;
+}
+
+size_t HttpRequest::headerLength() const {
+    return header_end_pos_ != std::string::npos ? header_end_pos_ + HEADER_END.size() : 0;
 }
 
-const std::string& HttpRequest::method() const {
-    return method_;
+size_t HttpRequest::contentLength() const {
+    return content_length_;
 }
 
-const std::string& HttpRequest::path() const {
-    return path_;
+std::string_view HttpRequest::method() const {
+    return view(method_);
 }
 
-const std::string& HttpRequest::version() const {
-    return version_;
+std::string_view HttpRequest::path() const {
+    return view(path_);
 }
 
-const std::unordered_map<std::string, std::string>& HttpRequest::headers() const {
-    return headers_;
+std::string_view HttpRequest::version() const {
+    return view(version_);
 }
 
-const std::string& HttpRequest::body() const {
+std::string_view HttpRequest::body() const {
+    if (body_field_.length > 0) {
+        return raw_.substr(body_field_.offset, body_field_.length);
+    }
     return body_;
 }
 
-std::optional<std::string> HttpRequest::getHeader(const std::string& key) const {
-    if (const auto iter = headers_.find(key); iter != headers_.end()) {
-        return iter->second;
+std::optional<std::string_view> HttpRequest::getHeader(const HttpHeader header) const {
+    if (const uint32_t slot = known_headers_[HttpHeaders::index(header)]; slot != 0) {
+        return view(headers_[slot - 1].value);
     }
     return std::nullopt;
 }
 
-std::optional<std::string> HttpRequest::getBoundary() const {
-    if (auto content_type = getHeader("Content-Type")) {
-        const std::string boundary_prefix = "boundary=";
-        if (const size_t pos = content_type->find(boundary_prefix); pos != std::string::npos) {
+std::optional<std::string_view> HttpRequest::getHeader(const std::string_view key) const {
+    if (const auto header = HttpHeaders::find(key)) {
+        return getHeader(*header);
+    }
+
+    for (const auto& header : std::ranges::reverse_view(headers_)) {
+        if (header.name.length == key.size() && equalsIgnoreCase(view(header.name), key)) {
+            return view(header.value);
+        }
+    }
+    return std::nullopt;
+}
+
+std::optional<std::string_view> HttpRequest::getBoundary() const {
+    if (const auto content_type = getHeader(HttpHeader::CONTENT_TYPE)) {
+        constexpr std::string_view boundary_prefix = "boundary=";
+        if (const size_t pos = content_type->find(boundary_prefix); pos != std::string_view::npos) {
             const size_t start = pos + boundary_prefix.length();
             const size_t end = content_type->find(';', start);
             return content_type->substr(start, end - start);
@@ -108,22 +305,138 @@ std::optional<std::string> HttpRequest::getBoundary() const {
     return std::nullopt;
 }
 
+bool HttpRequest::keepAlive() const {
+    const auto connection = getHeader(HttpHeader::CONNECTION);
+
+    // HTTP/1.1 默认长连接，HTTP/1.0 需要显式声明 keep-alive
+    if (version() == "HTTP/1.1") {
+        return !connection || !equalsIgnoreCase(*connection, "close");
+    }
+    return connection && equalsIgnoreCase(*connection, "keep-alive");
+}
+
+bool HttpRequest::expectsContinue() const {
+    const auto expect = getHeader(HttpHeader::EXPECT);
+    return expect && equalsIgnoreCase(*expect, "100-continue");
+}
+
 bool HttpRequest::isHeaderParsed() const {
     return header_parsed_;
 }
 
+bool HttpRequest::isChunked() const {
+    return chunked_;
+}
+
 void HttpRequest::reset() {
-    method_.clear();
-    path_.clear();
-    version_.clear();
+    raw_ = {};
+    storage_.clear();
+    method_ = {};
+    path_ = {};
+    version_ = {};
     headers_.clear();
+    known_headers_.fill(0);
+    body_field_ = {};
     body_.clear();
     header_parsed_ = false;
+    header_scan_pos_ = 0;
     header_end_pos_ = std::string::npos;
     content_length_ = 0;
+    chunked_ = false;
+    chunk_state_ = ChunkState::SIZE;
+    chunk_pos_ = 0;
+    chunk_remaining_ = 0;
+    body_received_ = 0;
+    body_end_pos_ = std::string::npos;
+}
+
+std::string_view HttpRequest::source() const {
+    return storage_.empty() ? raw_ : std::string_view(storage_);
+}
+
+std::string_view HttpRequest::view(const Field field) const {
+    return source().substr(field.offset, field.length);
+}
+
+void HttpRequest::parseRequestLine(const std::string_view line) {
+    // 请求行：方法、路径、版本以空白分隔
+    std::array<Field, 3> parts{};
+    size_t pos = 0;
+    for (Field& part : parts) {
+        pos = line.find_first_not_of(" \t", pos);
+        if (pos == std::string_view::npos) {
+            throw std::invalid_argument("Invalid HTTP request line");
+        }
+        const size_t end = std::min(line.find_first_of(" \t", pos), line.size());
+        part = {.offset = pos, .length = end - pos};
+        pos = end;
+    }
+
+    // 请求行位于原始数据开头，行内位置即原始数据中的位置
+    method_ = parts[0];
+    path_ = parts[1];
+    version_ = parts[2];
 }
 
-void HttpRequest::trim(std::string& str) {
-    str.erase(0, str.find_first_not_of(" \t"));
-    str.erase(str.find_last_not_of(" \t") + 1);
+void HttpRequest::parseHeaderLine(const std::string_view line, const size_t offset) {
+    const size_t colon_pos = line.find(':');
+    if (colon_pos == std::string_view::npos) {
+        return;
+    }
+
+    const std::string_view name = trim(line.substr(0, colon_pos));
+    const std::string_view value = trim(line.substr(colon_pos + 1));
+    addHeader({.offset = offset + static_cast<size_t>(name.data() - line.data()), .length = name.size()},
+              {.offset = offset + static_cast<size_t>(value.data() - line.data()), .length = value.size()});
+}
+
+void HttpRequest::addHeader(const Field name, const Field value) {
+    const auto header = HttpHeaders::find(view(name));
+    if (header == HttpHeader::CONTENT_LENGTH) {
+        // 多个取值不同的 Content-Length 无法确定消息边界，可被用于请求走私
+        if (const auto previous = getHeader(HttpHeader::CONTENT_LENGTH); previous && *previous != view(value)) {
+            throw std::invalid_argument("Conflicting Content-Length headers");
+        }
+    }
+
+    headers_.push_back({.name = name, .value = value});
+    if (header) {
+        known_headers_[HttpHeaders::index(*header)] = static_cast<uint32_t>(headers_.size());
+    }
+}
+
+void HttpRequest::parseFraming() {
+    if (const auto encoding = getHeader(HttpHeader::TRANSFER_ENCODING)) {
+        // 同时带有 Transfer-Encoding 与 Content-Length 时前后端可能对消息边界理解不一致，直接拒绝
+        if (getHeader(HttpHeader::CONTENT_LENGTH)) {
+            throw std::invalid_argument("Both Transfer-Encoding and Content-Length present");
+        }
+
+        // 仅支持 chunked 作为最后一层编码
+        std::string_view coding = *encoding;
+        if (const size_t comma_pos = coding.rfind(','); comma_pos != std::string_view::npos) {
+            coding.remove_prefix(comma_pos + 1);
+        }
+        if (!equalsIgnoreCase(trim(coding), "chunked")) {
+            throw std::invalid_argument("Unsupported Transfer-Encoding: " + std::string(*encoding));
+        }
+
+        chunked_ = true;
+        chunk_pos_ = header_end_pos_ + HEADER_END.size();
+    } else if (const auto length = getHeader(HttpHeader::CONTENT_LENGTH)) {
+        const char* end = length->data() + length->size();
+        const auto [ptr, errc] = std::from_chars(length->data(), end, content_length_);
+        if (errc != std::errc{} || ptr != end) {
+            throw std::invalid_argument("Invalid Content-Length: " + std::string(*length));
+        }
+    }
+}
+
+std::string_view HttpRequest::trim(std::string_view str) {
+    const size_t begin = str.find_first_not_of(" \t");
+    if (begin == std::string_view::npos) {
+        return str.substr(str.size());
+    }
+    str.remove_prefix(begin);
+    return str.substr(0, str.find_last_not_of(" \t") + 1);
 }
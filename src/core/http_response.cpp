@@ -1,11 +1,38 @@
 #include "core/http_response.h"
 
+#include <algorithm>
+#include <cctype>
 #include <format>
-#include <map>
-#include <sstream>
+#include <iterator>
+#include <memory_resource>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <utility>
+
+#include "utils/request_arena.h"
 
 namespace {
+    bool equalsIgnoreCase(const std::string_view lhs, const std::string_view rhs) {
+        return std::ranges::equal(lhs, rhs, [](const unsigned char lhs_chr, const unsigned char rhs_chr) {
+            return std::tolower(lhs_chr) == std::tolower(rhs_chr);
+        });
+    }
+
+    using HeaderSlots = std::array<std::pmr::string, HTTP_HEADER_COUNT>;
+
+    // std::array 的元素无法在构造后更换分配器，只能逐个以指定的 resource 就地构造
+    template <size_t... Index>
+    HeaderSlots makeHeaderSlots(std::pmr::memory_resource* resource, std::index_sequence<Index...> /*unused*/) {
+        return {((void)Index, std::pmr::string(resource))...};
+    }
+
+    template <size_t... Index>
+    HeaderSlots copyHeaderSlots(const HeaderSlots& other, std::pmr::memory_resource* resource,
+                                std::index_sequence<Index...> /*unused*/) {
+        return {std::pmr::string(other[Index], resource)...};  // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+    }
+
     constexpr auto ERROR_HTML_TEMPLATE = R"(
 <!DOCTYPE html>
 <html lang="en">
@@ -28,14 +55,32 @@ namespace {
 )";
 }  // namespace
 
-HttpResponse& HttpResponse::setStatus(const std::string& status) {
+HttpResponse::HttpResponse() : HttpResponse(RequestArena::resource()) {}
+
+HttpResponse::HttpResponse(std::pmr::memory_resource* resource)
+    : status_("200 OK", resource),
+      known_headers_(makeHeaderSlots(resource, std::make_index_sequence<HTTP_HEADER_COUNT>{})),
+      other_headers_(resource) {
+    addHeader(HttpHeader::CONTENT_TYPE, "application/octet-stream");
+}
+
+HttpResponse::HttpResponse(const HttpResponse& other, std::pmr::memory_resource* resource)
+    : status_(other.status_, resource),
+      body_(other.body_),
+      segments_(other.segments_),
+      stream_key_(other.stream_key_),
+      stream_producer_(other.stream_producer_),
+      known_headers_(copyHeaderSlots(other.known_headers_, resource, std::make_index_sequence<HTTP_HEADER_COUNT>{})),
+      known_set_(other.known_set_),
+      other_headers_(other.other_headers_, resource) {}
+
+HttpResponse& HttpResponse::setStatus(const std::string_view status) {
     status_ = status;
     return *this;
 }
 
-HttpResponse& HttpResponse::setContentType(const std::string& type) {
-    headers_["Content-Type"] = type;
-    return *this;
+HttpResponse& HttpResponse::setContentType(const std::string_view type) {
+    return addHeader(HttpHeader::CONTENT_TYPE, std::string(type));
 }
 
 HttpResponse& HttpResponse::setBody(const std::string& body) {
@@ -43,8 +88,64 @@ HttpResponse& HttpResponse::setBody(const std::string& body) {
     return *this;
 }
 
-HttpResponse& HttpResponse::addHeader(const std::string& key, const std::string& value) {
-    headers_[key] = value;
+HttpResponse& HttpResponse::setFile(std::shared_ptr<FileDescriptor> file, const off_t offset, const size_t length) {
+    body_.clear();
+    segments_.clear();
+    return appendFile(std::move(file), offset, length);
+}
+
+HttpResponse& HttpResponse::appendData(std::string data) {
+    segments_.push_back({.data = std::move(data)});
+    return *this;
+}
+
+HttpResponse& HttpResponse::shareBody() {
+    if (!body_.empty()) {
+        segments_.insert(segments_.begin(), {.shared = std::make_shared<const std::string>(std::move(body_))});
+        body_.clear();
+    }
+    return *this;
+}
+
+HttpResponse& HttpResponse::appendFile(std::shared_ptr<FileDescriptor> file, const off_t offset,
+                                       const size_t length) {
+    segments_.push_back({.file = std::move(file), .offset = offset, .length = length});
+    return *this;
+}
+
+HttpResponse& HttpResponse::setProducer(BodyProducer producer) {
+    body_.clear();
+    segments_.clear();
+    segments_.push_back({.producer = std::move(producer)});
+    return *this;
+}
+
+HttpResponse& HttpResponse::streamTemplate(std::string key, BodyProducer producer) {
+    stream_key_ = "{{" + key + "}}";
+    stream_producer_ = std::move(producer);
+    return *this;
+}
+
+HttpResponse& HttpResponse::addHeader(const HttpHeader header, const std::string_view value) {
+    const size_t index = HttpHeaders::index(header);
+    known_headers_[index] = value;  // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+    known_set_.set(index);
+    return *this;
+}
+
+HttpResponse& HttpResponse::addHeader(const std::string_view key, const std::string_view value) {
+    if (const auto header = HttpHeaders::find(key)) {
+        return addHeader(*header, value);
+    }
+
+    const auto iter = std::ranges::find_if(other_headers_, [key](const auto& entry) {
+        return equalsIgnoreCase(entry.first, key);
+    });
+    if (iter != other_headers_.end()) {
+        iter->second = value;
+    } else {
+        other_headers_.emplace_back(key, value);
+    }
     return *this;
 }
 
@@ -58,25 +159,134 @@ HttpResponse& HttpResponse::renderTemplate(std::string key, const std::string& v
     return *this;
 }
 
-std::string HttpResponse::getContentType() const {
-    if (const auto iter = headers_.find("Content-Type"); iter != headers_.end()) {
-        return iter->second;
+std::optional<std::string_view> HttpResponse::getHeader(const HttpHeader header) const {
+    const size_t index = HttpHeaders::index(header);
+    if (!known_set_.test(index)) {
+        return std::nullopt;
     }
-    return "";
+    return std::string_view(known_headers_[index]);  // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
 }
 
-std::string HttpResponse::build() {
-    std::ostringstream oss;
-    oss << "HTTP/1.1 " << status_ << "\r\n";
-    headers_["Content-Length"] = std::to_string(body_.size());
-    headers_["Connection"] = "close";
+std::string_view HttpResponse::getContentType() const {
+    return getHeader(HttpHeader::CONTENT_TYPE).value_or("");
+}
+
+const std::vector<BodySegment>& HttpResponse::segments() const {
+    return segments_;
+}
+
+bool HttpResponse::hasFileBody() const {
+    return !segments_.empty();
+}
 
-    for (const auto& [key, value] : headers_) {
-        oss << key << ": " << value << "\r\n";
+bool HttpResponse::isStreaming() const {
+    if (stream_producer_) {
+        return true;
     }
+    return std::ranges::any_of(segments_, [](const BodySegment& segment) { return static_cast<bool>(segment.producer); });
+}
 
-    oss << "\r\n" << body_;
-    return oss.str();
+std::string_view HttpResponse::status() const {
+    return status_;
+}
+
+std::vector<BodySegment> HttpResponse::takeBody() {
+    applyStreamTemplate();
+
+    std::vector<BodySegment> body;
+    body.reserve(segments_.size() + 1);
+    if (!body_.empty()) {
+        body.push_back({.data = std::move(body_)});
+    }
+    std::ranges::move(segments_, std::back_inserter(body));
+
+    body_.clear();
+    segments_.clear();
+    return body;
+}
+
+void HttpResponse::applyStreamTemplate() {
+    if (!stream_producer_) {
+        return;
+    }
+
+    // 占位符之前的内容作为第一个数据块，生成器输出完毕后再发送占位符之后的内容
+    std::string prefix = std::move(body_);
+    std::string suffix;
+    if (const size_t pos = prefix.find(stream_key_); pos != std::string::npos) {
+        suffix = prefix.substr(pos + stream_key_.size());
+        prefix.erase(pos);
+    }
+
+    body_.clear();
+    segments_.clear();
+    segments_.push_back({.data = std::move(prefix)});
+    segments_.push_back({.producer = std::move(stream_producer_)});
+    segments_.push_back({.data = std::move(suffix)});
+    stream_producer_ = nullptr;
+}
+
+void HttpResponse::collectProducers() {
+    std::vector<BodySegment> collected;
+    for (auto& segment : segments_) {
+        if (!segment.producer) {
+            collected.push_back(std::move(segment));
+            continue;
+        }
+
+        std::string data;
+        std::string chunk;
+        bool more = true;
+        while (more) {
+            chunk.clear();
+            more = segment.producer(chunk);
+            data += chunk;
+        }
+        collected.push_back({.data = std::move(data)});
+    }
+    segments_ = std::move(collected);
+}
+
+std::string HttpResponse::build(const bool keep_alive, const bool chunked) {
+    applyStreamTemplate();
+    if (!chunked) {
+        collectProducers();
+    }
+
+    if (isStreaming()) {
+        // 长度未知，响应头之后的所有内容均以 chunked 编码发送
+        segments_.insert(segments_.begin(), {.data = std::move(body_)});
+        body_.clear();
+        removeHeader(HttpHeader::CONTENT_LENGTH);
+        addHeader(HttpHeader::TRANSFER_ENCODING, "chunked");
+    } else {
+        size_t content_length = body_.size();
+        for (const auto& segment : segments_) {
+            content_length += segment.size();
+        }
+        removeHeader(HttpHeader::TRANSFER_ENCODING);
+        addHeader(HttpHeader::CONTENT_LENGTH, std::to_string(content_length));
+    }
+    addHeader(HttpHeader::CONNECTION, keep_alive ? "keep-alive" : "close");
+
+    // 状态行与响应头先在请求内存池中拼接，再连同内存响应体一次性复制到按实际长度分配的结果中
+    std::pmr::string head(RequestArena::resource());
+    head.append("HTTP/1.1 ").append(status_).append("\r\n");
+    forEachHeader([&head](const std::string_view key, const std::string_view value) {
+        head.append(key).append(": ").append(value).append("\r\n");
+    });
+    head.append("\r\n");
+
+    std::string result;
+    result.reserve(head.size() + body_.size());
+    result.append(head).append(body_);
+    return result;
+}
+
+void HttpResponse::removeHeader(const HttpHeader header) {
+    const size_t index = HttpHeaders::index(header);
+    known_headers_[index].clear();  // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+    known_set_.reset(index);
 }
 
 HttpResponse HttpResponse::responseError(const int code, const std::string& tips) {
@@ -109,6 +319,22 @@ HttpResponse HttpResponse::responseError(const int code, const std::string& tips
             status = "Conflict";
             message = "The request could not be completed due to a conflict with the current state of the resource.";
             break;
+        case 413:
+            status = "Content Too Large";
+            message = "The request body is larger than the server is willing to accept.";
+            break;
+        case 416:
+            status = "Range Not Satisfiable";
+            message = "The requested range cannot be satisfied.";
+            break;
+        case 417:
+            status = "Expectation Failed";
+            message = "The expectation given in the Expect header cannot be met.";
+            break;
+        case 431:
+            status = "Request Header Fields Too Large";
+            message = "The request header is larger than the server is willing to accept.";
+            break;
         case 500:
             status = "Internal Server Error";
             message = "Something went wrong on the server.";
@@ -117,6 +343,10 @@ HttpResponse HttpResponse::responseError(const int code, const std::string& tips
             status = "Bad Gateway";
             message = "The server received an invalid response from an upstream server.";
             break;
+        case 503:
+            status = "Service Unavailable";
+            message = "The server is temporarily busy, please try again later.";
+            break;
         default:
             status = "Unknown Error";
             message = std::to_string(code) + " Unknown Error";
@@ -128,10 +358,16 @@ HttpResponse HttpResponse::responseError(const int code, const std::string& tips
         message += " " + tips;
     }
 
-    return HttpResponse{}
-        .setStatus(std::format("{} {}", code, status))
+    HttpResponse response;
+    response.setStatus(std::format("{} {}", code, status))
         .setContentType("text/html; charset=UTF-8")
         .setBody(std::format(ERROR_HTML_TEMPLATE, code, status, message));
+
+    if (constexpr int service_unavailable = 503; code == service_unavailable) {
+        // 服务器暂时过载，建议客户端稍后重试
+        response.addHeader(HttpHeader::RETRY_AFTER, "1");
+    }
+    return response;
 }
 
 HttpResponse HttpResponse::responseAlert(const std::string& message) {
@@ -141,7 +377,9 @@ HttpResponse HttpResponse::responseAlert(const std::string& message) {
         "</head><body></body></html>",
         message);
 
-    return HttpResponse{}.setStatus("200 OK").setContentType("text/html; charset=UTF-8").setBody(html);
+    HttpResponse response;
+    response.setStatus("200 OK").setContentType("text/html; charset=UTF-8").setBody(html);
+    return response;
 }
 
 HttpResponse HttpResponse::responseAlert(const std::string& message, const std::string& location) {
@@ -151,7 +389,9 @@ HttpResponse HttpResponse::responseAlert(const std::string& message, const std::
         "</head><body></body></html>",
         message, location);
 
-    return HttpResponse{}.setStatus("200 OK").setContentType("text/html; charset=UTF-8").setBody(html);
+    HttpResponse response;
+    response.setStatus("200 OK").setContentType("text/html; charset=UTF-8").setBody(html);
+    return response;
 }
 
 HttpResponse HttpResponse::responseRedirect(const int code, const std::string& location) {
@@ -171,9 +411,10 @@ HttpResponse HttpResponse::responseRedirect(const int code, const std::string& l
     }
     // NOLINTEND(readability-magic-numbers, cppcoreguidelines-avoid-magic-numbers)
 
-    return HttpResponse{}
-        .setStatus(status)
-        .addHeader("Location", location)
+    HttpResponse response;
+    response.setStatus(status)
+        .addHeader(HttpHeader::LOCATION, location)
         .setContentType("text/plain; charset=UTF-8")
         .setBody("Redirecting to " + location);
+    return response;
 }
@@ -0,0 +1,239 @@
+#include "core/listener.h"
+
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "core/address.h"
+#include "utils/logger.h"
+
+namespace {
+    uint16_t parsePort(const std::string_view spec, const std::string_view port) {
+        uint16_t value = 0;
+        const auto [ptr, errc] = std::from_chars(port.data(), port.data() + port.size(), value);
+        if (errc != std::errc{} || ptr != port.data() + port.size()) {
+            throw std::invalid_argument(std::format("Invalid port in listen address: {}", spec));
+        }
+        return value;
+    }
+
+    std::string trim(const std::string& str) {
+        const size_t begin = str.find_first_not_of(" \t");
+        if (begin == std::string::npos) {
+            return "";
+        }
+        return str.substr(begin, str.find_last_not_of(" \t") - begin + 1);
+    }
+}  // namespace
+
+std::string ListenAddress::toString() const {
+    if (family == AF_UNIX) {
+        return "unix:" + path;
+    }
+    if (family == AF_INET6) {
+        return std::format("[{}]:{}", host, port);
+    }
+    return std::format("{}:{}", host, port);
+}
+
+ListenAddress ListenAddress::parse(const std::string& spec) {
+    ListenAddress address;
+    const std::string_view view = spec;
+
+    if (view.starts_with("unix:")) {
+        address.family = AF_UNIX;
+        address.path = spec.substr(std::string_view("unix:").size());
+        if (address.path.empty() || address.path.size() >= sizeof(sockaddr_un::sun_path)) {
+            throw std::invalid_argument(std::format("Invalid unix socket path: {}", spec));
+        }
+        return address;
+    }
+
+    if (view.starts_with('[')) {
+        // [IPv6 地址]:端口
+        const size_t bracket = view.find("]:");
+        if (bracket == std::string_view::npos) {
+            throw std::invalid_argument(std::format("Invalid IPv6 listen address: {}", spec));
+        }
+        address.family = AF_INET6;
+        address.host = spec.substr(1, bracket - 1);
+        address.port = parsePort(view, view.substr(bracket + 2));
+
+        in6_addr addr{};
+        if (inet_pton(AF_INET6, address.host.c_str(), &addr) != 1) {
+            throw std::invalid_argument(std::format("Invalid IPv6 address: {}", spec));
+        }
+        return address;
+    }
+
+    if (const size_t colon = view.rfind(':'); colon != std::string_view::npos) {
+        // IPv4 地址:端口，"*" 表示所有地址
+        address.host = spec.substr(0, colon);
+        if (address.host == "*") {
+            address.host = "0.0.0.0";
+        }
+        address.port = parsePort(view, view.substr(colon + 1));
+
+        in_addr addr{};
+        if (inet_pton(AF_INET, address.host.c_str(), &addr) != 1) {
+            throw std::invalid_argument(std::format("Invalid IPv4 address: {}", spec));
+        }
+        return address;
+    }
+
+    // 只有端口时监听所有 IPv4 地址
+    address.port = parsePort(view, view);
+    return address;
+}
+
+std::vector<ListenAddress> ListenAddress::parseList(const std::string& specs) {
+    std::vector<ListenAddress> addresses;
+    size_t start = 0;
+    while (start <= specs.size()) {
+        size_t end = specs.find(',', start);
+        if (end == std::string::npos) {
+            end = specs.size();
+        }
+
+        if (const std::string spec = trim(specs.substr(start, end - start)); !spec.empty()) {
+            addresses.push_back(parse(spec));
+        }
+        start = end + 1;
+    }
+
+    if (addresses.empty()) {
+        throw std::invalid_argument("No listen address configured");
+    }
+    return addresses;
+}
+
+// NOLINTBEGIN(cppcoreguidelines-pro-type-reinterpret-cast)
+Listener::Listener(ListenAddress address, const bool reuse_port, Logger* logger, const int inherited_fd)
+    : address_(std::move(address)), logger_(logger) {
+    const std::string name = address_.toString();
+
+    if (inherited_fd != -1) {
+        // 与旧进程共享同一个 socket，两个进程交接期间连接都在同一个监听队列中，不会被拒绝
+        int accepting = 0;
+        socklen_t option_length = sizeof(accepting);
+        if (getsockopt(inherited_fd, SOL_SOCKET, SO_ACCEPTCONN, &accepting, &option_length) == -1 || accepting == 0) {
+            logger_->log(LogLevel::ERROR, std::format("Inherited fd {} for {} is not a listening socket.",
+                                                      inherited_fd, name));
+            close(inherited_fd);
+            throw std::runtime_error("Inherited fd is not a listening socket.");
+        }
+
+        fcntl(inherited_fd, F_SETFD, FD_CLOEXEC);
+        listen_fd_ = inherited_fd;
+        logger_->log(LogLevel::INFO, std::format("Inherited listening socket for {} (fd {})", name, listen_fd_));
+        return;
+    }
+
+    listen_fd_ = socket(address_.family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listen_fd_ == -1) {
+        logger_->log(LogLevel::ERROR, std::format("Failed to create socket for {}.", name));
+        throw std::runtime_error("Failed to create socket.");
+    }
+
+    sockaddr_storage storage{};
+    socklen_t length = 0;
+    constexpr int opt = 1;
+
+    if (address_.isUnix()) {
+        // 删除上次运行遗留的 socket 文件；同名的普通文件不会被覆盖
+        if (std::filesystem::is_socket(address_.path)) {
+            std::filesystem::remove(address_.path);
+        }
+
+        auto* addr = reinterpret_cast<sockaddr_un*>(&storage);
+        addr->sun_family = AF_UNIX;
+        address_.path.copy(addr->sun_path, sizeof(addr->sun_path) - 1);
+        length = sizeof(sockaddr_un);
+    } else {
+        // 设置 socket 选项：快速重用地址
+        setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+
+        // 多 Reactor 模式下每个 Reactor 绑定同一端口，由内核在各监听 socket 间分配新连接
+        if (reuse_port && setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt)) == -1) {
+            logger_->log(LogLevel::ERROR, "Failed to enable SO_REUSEPORT.");
+            close(listen_fd_);
+            throw std::runtime_error("Failed to enable SO_REUSEPORT.");
+        }
+
+        if (address_.family == AF_INET6) {
+            // 只接受 IPv6 连接，IPv4 需要单独配置监听地址
+            setsockopt(listen_fd_, IPPROTO_IPV6, IPV6_V6ONLY, &opt, sizeof(opt));
+
+            auto* addr = reinterpret_cast<sockaddr_in6*>(&storage);
+            addr->sin6_family = AF_INET6;
+            addr->sin6_port = htons(address_.port);
+            inet_pton(AF_INET6, address_.host.c_str(), &addr->sin6_addr);
+            length = sizeof(sockaddr_in6);
+        } else {
+            auto* addr = reinterpret_cast<sockaddr_in*>(&storage);
+            addr->sin_family = AF_INET;
+            addr->sin_port = htons(address_.port);
+            inet_pton(AF_INET, address_.host.c_str(), &addr->sin_addr);
+            length = sizeof(sockaddr_in);
+        }
+    }
+
+    // 绑定 socket 到地址
+    if (bind(listen_fd_, reinterpret_cast<sockaddr*>(&storage), length) == -1) {
+        logger_->log(LogLevel::ERROR, std::format("Failed to bind {}: {}", name, strerror(errno)));
+        close(listen_fd_);
+        throw std::runtime_error("Failed to bind socket.");
+    }
+
+    // 开始监听连接请求
+    if (listen(listen_fd_, SOMAXCONN) == -1) {
+        logger_->log(LogLevel::ERROR, std::format("Failed to listen on {}: {}", name, strerror(errno)));
+        close(listen_fd_);
+        throw std::runtime_error("Failed to listen on socket.");
+    }
+}
+
+Listener::~Listener() {
+    close(listen_fd_);
+    if (address_.isUnix() && !handed_off_) {
+        std::error_code error;
+        std::filesystem::remove(address_.path, error);
+    }
+}
+
+void Listener::handOff() {
+    handed_off_ = true;
+}
+
+int Listener::fd() const {
+    return listen_fd_;
+}
+
+const ListenAddress& Listener::address() const {
+    return address_;
+}
+
+int Listener::accept(Address& peer) const {
+    sockaddr_storage storage{};
+    socklen_t length = sizeof(storage);
+    const int client_fd =
+        accept4(listen_fd_, reinterpret_cast<sockaddr*>(&storage), &length, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (client_fd != -1) {
+        peer = Address(storage, length, client_fd);
+    }
+    return client_fd;
+}
+// NOLINTEND(cppcoreguidelines-pro-type-reinterpret-cast)
@@ -0,0 +1,372 @@
+#include "core/reactor.h"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <format>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "core/address.h"
+#include "core/connection.h"
+#include "core/http_response.h"
+#include "core/threadpool.h"
+#include "utils/logger.h"
+
+namespace {
+    constexpr int MAX_EVENTS = 1024;  // 单次等待返回的最大事件数
+
+    // 连接正在被工作线程处理或当前阶段不限时，隔一段时间再检查
+    constexpr std::chrono::seconds TIMEOUT_RECHECK_INTERVAL{1};
+
+    // 资源耗尽时暂停 accept 的时长，连续暂停时逐次翻倍
+    constexpr std::chrono::milliseconds MIN_ACCEPT_BACKOFF{100};
+    constexpr std::chrono::milliseconds MAX_ACCEPT_BACKOFF{2000};
+
+    constexpr size_t MAX_SHED_PER_PAUSE = 256;  // 每次暂停前最多拒绝的积压连接数
+
+    // 拒绝连接时直接写入的响应，只生成一次
+    const std::string& rejectResponse() {
+        static const std::string response = [] {
+            constexpr int error_code = 503;
+            return HttpResponse::responseError(error_code).build();
+        }();
+        return response;
+    }
+}  // namespace
+
+Reactor::Reactor(const size_t reactor_id, std::vector<std::shared_ptr<Listener>> listeners,
+                 const std::string& event_backend, const ConnectionOptions& options, std::atomic<bool>& running,
+                 AdmissionControl* admission, Logger* logger, ThreadPool* thread_pool, StaticFile* static_file,
+                 UserManager* user_manager)
+    : id_(reactor_id),
+      listeners_(std::move(listeners)),
+      options_(options),
+      event_backend_(EventBackend::create(event_backend, logger)),
+      running_(running),
+      admission_(admission),
+      accept_backoff_(MIN_ACCEPT_BACKOFF),
+      logger_(logger),
+      thread_pool_(thread_pool),
+      static_file_(static_file),
+      user_manager_(user_manager) {
+    setupEpoll();
+}
+
+Reactor::~Reactor() {
+    connections_.clear();
+    listeners_.clear();
+    close(wakeup_fd_);
+    logger_->log(LogLevel::DEBUG, std::format("-- Reactor {} closed", id_));
+}
+
+void Reactor::setupEpoll() {
+    wakeup_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wakeup_fd_ == -1) {
+        logger_->log(LogLevel::ERROR, "Failed to create eventfd.");
+        throw std::runtime_error("Failed to create eventfd.");
+    }
+
+    try {
+        for (const auto& listener : listeners_) {
+            event_backend_->addListener(*listener, EventBackend::eventData(listener->fd()));
+            logger_->log(LogLevel::INFO,
+                         std::format("Reactor {} listening on {}", id_, listener->address().toString()));
+        }
+        event_backend_->addFd(wakeup_fd_, EPOLLIN | EPOLLET, EventBackend::eventData(wakeup_fd_));
+        logger_->log(LogLevel::DEBUG, std::format("Reactor {} using {} event backend", id_, event_backend_->name()));
+    } catch (const std::exception& e) {
+        logger_->log(LogLevel::ERROR, std::format("Epoll setup failed: {}", e.what()));
+        throw;
+    }
+}
+
+void Reactor::run() {
+    std::array<epoll_event, MAX_EVENTS> events{};
+    while (running_) {
+        const int event_count = event_backend_->wait(events, timer_wheel_.timeoutMs(TimerWheel::Clock::now()));
+        for (int i = 0; i < event_count; ++i) {
+            // 客户端连接的代数从 1 开始，代数为 0 的是监听 socket 与唤醒 eventfd
+            const uint64_t data = events.at(i).data.u64;
+            if (EventBackend::eventGeneration(data) != 0) {
+                dispatchClient(data, events.at(i).events);
+                continue;
+            }
+
+            const int ready_fd = EventBackend::eventFd(data);
+            const auto listener = std::ranges::find_if(
+                listeners_, [ready_fd](const auto& candidate) { return candidate->fd() == ready_fd; });
+            if (listener != listeners_.end()) {
+                handleNewConnection(**listener);
+            } else if (ready_fd == wakeup_fd_) {
+                uint64_t value = 0;
+                [[maybe_unused]] const ssize_t bytes = read(wakeup_fd_, &value, sizeof(value));
+            }
+        }
+
+        reclaimConnections();
+        timer_wheel_.advance(TimerWheel::Clock::now());
+
+        if (drain_requested_) {
+            if (!draining_) {
+                beginDrain();
+            }
+            if (drained()) {
+                break;
+            }
+        }
+    }
+
+    // 退出时仍未关闭的连接上的请求已无法完成，通知工作线程尽早放弃
+    connections_.forEach([](const auto& conn) { conn->cancel(); });
+}
+
+void Reactor::wakeup() const {
+    constexpr uint64_t value = 1;
+    [[maybe_unused]] const ssize_t bytes = write(wakeup_fd_, &value, sizeof(value));
+}
+
+void Reactor::drain(const TimerWheel::Clock::time_point deadline) {
+    drain_deadline_ = deadline;
+    drain_requested_ = true;
+    wakeup();
+}
+
+void Reactor::beginDrain() {
+    draining_ = true;
+
+    // 关闭监听 socket 后新连接由内核直接拒绝（Unix 域 socket 在所有 Reactor 都释放后关闭）
+    for (const auto& listener : listeners_) {
+        event_backend_->delFd(listener->fd());
+    }
+    listeners_.clear();
+
+    reclaimConnections();
+    logger_->log(LogLevel::INFO, std::format("Reactor {} draining {} connection(s)", id_, connections_.size()));
+    connections_.forEach([](const auto& conn) { conn->drain(); });
+
+    // 保证在截止时间醒来，连接全部关闭时由关闭回调唤醒
+    timer_wheel_.add(drain_deadline_.load(), [] {});
+}
+
+bool Reactor::drained() {
+    const size_t remaining = connections_.size();
+
+    if (remaining == 0) {
+        logger_->log(LogLevel::INFO, std::format("Reactor {} drained", id_));
+        return true;
+    }
+    if (TimerWheel::Clock::now() >= drain_deadline_.load()) {
+        logger_->log(LogLevel::WARNING,
+                     std::format("Reactor {} shutdown timeout, closing {} connection(s)", id_, remaining));
+        return true;
+    }
+    return false;
+}
+
+void Reactor::handleNewConnection(const Listener& listener) {
+    if (accept_paused_) {
+        return;  // 退避结束后统一重试
+    }
+
+    while (true) {
+        // Unix 域 socket 由多个 Reactor 共享，其他 Reactor 先取走连接时这里得到 EAGAIN
+        Address client_addr;
+        const int client_fd = event_backend_->accept(listener, client_addr);
+        if (client_fd == -1) {
+            const int error = errno;
+            if (error == EAGAIN || error == EWOULDBLOCK) {
+                break;  // 无更多连接
+            }
+            if (error == EINTR || error == ECONNABORTED || error == EPROTO || error == EPERM) {
+                continue;  // 只影响这一个连接，继续接受后续连接
+            }
+            if (error == EMFILE || error == ENFILE) {
+                shedWithReserveFd(listener);
+            }
+            pauseAccept(strerror(error));
+            return;
+        }
+
+        if (!admission_->tryAcquire()) {
+            rejectConnection(client_fd, client_addr, AdmissionControl::Rejection::OVER_LIMIT);
+            continue;
+        }
+        accept_backoff_ = MIN_ACCEPT_BACKOFF;
+
+        const uint32_t generation = connections_.assign(client_fd);
+        if (generation == 0) {
+            logger_->log(LogLevel::ERROR, client_addr,
+                         std::format("fd {} exceeds connection table capacity {}", client_fd, connections_.capacity()));
+            admission_->release();
+            close(client_fd);
+            continue;
+        }
+
+        std::shared_ptr<Connection> conn;
+        try {
+            conn = std::make_shared<Connection>(client_fd, generation, client_addr, event_backend_.get(), logger_,
+                                                static_file_, user_manager_, options_);
+        } catch (const std::exception& e) {
+            logger_->log(LogLevel::ERROR, client_addr, std::format("Failed to create connection: {}", e.what()));
+            admission_->release();
+            close(client_fd);
+            continue;
+        }
+
+        // 可能在工作线程中调用：只标记待回收，由事件循环在本轮事件处理完后统一释放
+        conn->setCloseRequestCallback([this, generation](const int close_fd) {
+            if (connections_.retire(close_fd, generation)) {
+                wakeup();
+            }
+        });
+        connections_.put(client_fd, conn);
+
+        if (options_.hasTimeouts()) {
+            armTimeout(conn);
+        }
+    }
+}
+
+void Reactor::rejectConnection(const int client_fd, const Address& client_addr,
+                               const AdmissionControl::Rejection reason) const {
+    admission_->countRejection(reason);
+
+    // 连接未注册到事件后端，只尝试一次非阻塞写入，写不完也不等待
+    const std::string& response = rejectResponse();
+    [[maybe_unused]] const ssize_t bytes = send(client_fd, response.data(), response.size(), MSG_NOSIGNAL | MSG_DONTWAIT);
+    close(client_fd);
+
+    logger_->log(LogLevel::DEBUG, client_addr,
+                 reason == AdmissionControl::Rejection::OVER_LIMIT ? "Rejected: connection limit reached."
+                                                                    : "Rejected: out of file descriptors.");
+}
+
+void Reactor::shedWithReserveFd(const Listener& listener) const {
+    // 让积压的客户端尽快收到 503，而不是在监听队列中等到超时
+    for (size_t i = 0; i < MAX_SHED_PER_PAUSE; ++i) {
+        bool drained = true;
+        const bool reserved = admission_->withReserveFd([&] {
+            Address client_addr;
+            if (const int client_fd = listener.accept(client_addr); client_fd != -1) {
+                rejectConnection(client_fd, client_addr, AdmissionControl::Rejection::NO_FD);
+                drained = false;
+            }
+        });
+        if (!reserved || drained) {
+            return;
+        }
+    }
+}
+
+void Reactor::pauseAccept(const std::string& reason) {
+    logger_->log(LogLevel::WARNING,
+                 std::format("Reactor {} pausing accept for {} ms: {} ({} active, {} rejected over limit, "
+                             "{} rejected out of fds)",
+                             id_, accept_backoff_.count(), reason, admission_->active(),
+                             admission_->rejected(AdmissionControl::Rejection::OVER_LIMIT),
+                             admission_->rejected(AdmissionControl::Rejection::NO_FD)));
+
+    accept_paused_ = true;
+    timer_wheel_.add(TimerWheel::Clock::now() + accept_backoff_, [this] { resumeAccept(); });
+    accept_backoff_ = std::min(accept_backoff_ * 2, MAX_ACCEPT_BACKOFF);
+}
+
+void Reactor::resumeAccept() {
+    accept_paused_ = false;
+
+    // 边缘触发下暂停期间到达的连接不会再产生事件，需要主动接受
+    for (const auto& listener : listeners_) {
+        handleNewConnection(*listener);
+        if (accept_paused_) {
+            return;
+        }
+    }
+}
+
+void Reactor::dispatchClient(const uint64_t event_data, const uint32_t events) {
+    // 连接已关闭，或 fd 已被新连接复用（过期事件）
+    const std::shared_ptr<Connection>& conn = connections_.find(event_data);
+    if (!conn) {
+        return;
+    }
+
+    if ((events & (EPOLLHUP | EPOLLERR)) != 0) {
+        // 连接已断开：取消正在处理的请求。工作线程处理期间只关注 EPOLLHUP / EPOLLERR，
+        // 此时连接仍由该线程持有，不再分发任务，由它在处理结束后关闭连接。
+        // 单独的 EPOLLRDHUP 只表示对端关闭了写方向（shutdown(SHUT_WR)），已发出的请求仍需响应
+        conn->cancel();
+        if ((events & (EPOLLIN | EPOLLOUT)) == 0) {
+            return;
+        }
+    }
+
+    try {
+        const bool overloaded = (events & EPOLLIN) != 0 && thread_pool_->overloaded();
+        if (overloaded && conn->atRequestBoundary()) {
+            // 线程池过载：在事件循环线程中读取请求头并直接以 503 拒绝，不再进入任务队列排队。
+            // 正在接收的请求体（可能需要写入磁盘）与 HTTP/2 连接仍交给工作线程，由其拒绝新的请求
+            conn->handleRead(true);
+            return;
+        }
+
+        if ((events & EPOLLIN) != 0 && conn->handleReadInline()) {
+            // 内存缓存中的静态资源已在事件循环线程中直接响应，省去线程池的排队与线程切换
+            return;
+        }
+
+        if (events == EPOLLOUT && conn->handleWriteInline()) {
+            // 内存中的响应在事件循环线程中继续发送（io_uring 后端的异步发送完成后在此收尾）
+            return;
+        }
+
+        thread_pool_->enqueue([conn, events, overloaded] {
+            if (events & EPOLLIN) {
+                conn->handleRead(overloaded);
+            }
+            if (events & EPOLLOUT) {
+                conn->handleWrite();
+            }
+        });
+    } catch (const std::exception& e) {
+        logger_->log(LogLevel::ERROR, conn->info(), std::format("Failed to dispatch task: {}", e.what()));
+    }
+}
+
+void Reactor::reclaimConnections() {
+    for (size_t count = connections_.reclaim(); count > 0; --count) {
+        admission_->release();
+    }
+}
+
+void Reactor::armTimeout(const std::shared_ptr<Connection>& conn) {
+    // 工作线程只更新连接的截止时间，定时器在到期时按最新的截止时间惰性地重新添加，时间轮无需加锁
+    const auto deadline = conn->deadline();
+    const auto when = deadline == TimerWheel::Clock::time_point::max()
+                          ? TimerWheel::Clock::now() + TIMEOUT_RECHECK_INTERVAL
+                          : deadline;
+    timer_wheel_.add(when, [this, weak_conn = std::weak_ptr(conn)] { checkTimeout(weak_conn); });
+}
+
+void Reactor::checkTimeout(const std::weak_ptr<Connection>& weak_conn) {
+    const auto conn = weak_conn.lock();
+    if (!conn) {
+        return;  // 连接已关闭
+    }
+
+    if (conn->deadline() <= TimerWheel::Clock::now()) {
+        conn->expire();
+        return;
+    }
+    armTimeout(conn);
+}
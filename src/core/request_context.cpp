@@ -0,0 +1,41 @@
+#include "core/request_context.h"
+
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "core/http_request.h"
+#include "user/session_manager.h"
+
+RequestContext::RequestContext(const HttpRequest& request, SessionManager* session_manager)
+    : request_(request), session_manager_(session_manager) {}
+
+const HttpRequest& RequestContext::request() const {
+    return request_;
+}
+
+std::optional<std::string_view> RequestContext::cookie(const std::string_view name) const {
+    if (!cookies_) {
+        const auto header = request_.getHeader(HttpHeader::COOKIE);
+        cookies_.emplace(CookieParser::parse(header.value_or("")));
+    }
+    return CookieParser::find(*cookies_, name);
+}
+
+std::optional<std::string_view> RequestContext::sessionId() const {
+    return cookie("session_id");
+}
+
+const std::optional<std::string>& RequestContext::username() const {
+    if (!session_resolved_) {
+        session_resolved_ = true;
+        if (const auto session_id = sessionId()) {
+            username_ = session_manager_->getUsername(std::string(*session_id));
+        }
+    }
+    return username_;
+}
+
+bool RequestContext::isLoggedIn() const {
+    return username().has_value();
+}
@@ -1,175 +1,231 @@
 #include "core/server.h"
 
+#include <algorithm>
 #include <array>
 #include <cerrno>
+#include <chrono>
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <format>
 #include <memory>
-#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
 
-#include <fcntl.h>
-#include <netinet/in.h>
 #include <sys/epoll.h>
-#include <sys/socket.h>
+#include <sys/eventfd.h>
 #include <unistd.h>
 
-#include "core/connection.h"
+#include "core/epoll_manager.h"
+#include "core/reactor.h"
 #include "core/threadpool.h"
+#include "utils/byte_scanner.h"
+#include "utils/file_descriptor.h"
 #include "utils/logger.h"
+#include "utils/signal_handler.h"
 
-constexpr int MAX_EVENTS = 1024;  // epoll 支持的最大事件数
-
-inline sockaddr* toSockaddr(sockaddr_in* addr) {
-    return reinterpret_cast<sockaddr*>(addr);  // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
-}
-
-Server::Server(const uint16_t port, const bool linger, std::atomic<bool>& running, Logger* logger,
-               ThreadPool* thread_pool, StaticFile* static_file, UserManager* user_manager)
-    : port_(port),
-      linger_(linger),
-      running_(running),
+Server::Server(const ServerOptions& server_options, const ConnectionOptions& options,
+               const SignalHandler* signal_handler, Logger* logger, ThreadPool* thread_pool, StaticFile* static_file,
+               UserManager* user_manager)
+    : server_options_(server_options),
+      signal_handler_(signal_handler),
       logger_(logger),
       thread_pool_(thread_pool),
-      static_file_(static_file),
-      user_manager_(user_manager) {
-    logger->log(LogLevel::INFO, std::format("Linger mode {}", linger_ ? "enabled" : "disabled"));
-    setupSocket();
-    setupEpoll();
+      admission_(server_options.max_connections),
+      hot_restart_(logger) {
+    logger->log(LogLevel::INFO, std::format("Linger mode {}", options.linger ? "enabled" : "disabled"));
+    logger->log(LogLevel::INFO, std::format("Keep-alive {} (max {} requests per connection)",
+                                            options.keep_alive ? "enabled" : "disabled", options.max_requests));
+    logger->log(LogLevel::INFO, std::format("HTTP/2 (h2c) {}", options.http2 ? "enabled" : "disabled"));
+    if (server_options_.max_connections == 0) {
+        logger->log(LogLevel::INFO, "Max connections: unlimited");
+    } else {
+        logger->log(LogLevel::INFO, std::format("Max connections: {}", server_options_.max_connections));
+    }
+    logger->log(LogLevel::INFO, std::format("Shutdown timeout: {} s", server_options_.shutdown_timeout.count()));
+    logger->log(LogLevel::INFO, std::format("Delimiter scanning: {}", ByteScanner::implementation()));
+
+    // TCP 地址在每个 Reactor 中各绑定一次，通过 SO_REUSEPORT 共享同一端口；
+    // Unix 域 socket 无法重复绑定同一路径，只创建一次并由所有 Reactor 共同监听。
+    // 热重启时优先使用从旧进程继承的同一地址的 socket
+    const size_t count = std::max<size_t>(server_options_.reactor_count, 1);
+    std::vector<std::vector<std::shared_ptr<Listener>>> listeners(count);
+    for (const auto& address : server_options_.listen) {
+        if (address.isUnix()) {
+            const auto shared =
+                std::make_shared<Listener>(address, false, logger_, hot_restart_.takeInherited(address));
+            listeners_.push_back(shared);
+            for (auto& reactor_listeners : listeners) {
+                reactor_listeners.push_back(shared);
+            }
+            continue;
+        }
+        for (auto& reactor_listeners : listeners) {
+            const auto listener =
+                std::make_shared<Listener>(address, count > 1, logger_, hot_restart_.takeInherited(address));
+            listeners_.push_back(listener);
+            reactor_listeners.push_back(listener);
+        }
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        reactors_.emplace_back(std::make_unique<Reactor>(i, std::move(listeners.at(i)), server_options_.event_backend,
+                                                         options, running_, &admission_, logger_, thread_pool,
+                                                         static_file, user_manager));
+    }
+
+    std::string addresses;
+    for (const auto& address : server_options_.listen) {
+        addresses += (addresses.empty() ? "" : ", ") + address.toString();
+    }
+    logger_->log(LogLevel::INFO, std::format("Server listening on {} with {} reactor(s)", addresses, count));
 }
 
 Server::~Server() {
-    close(listen_fd_);
     logger_->logDivider("Server close");
     logger_->log(LogLevel::INFO, "Cleaning up server resources");
-}
+    reactors_.clear();
 
-void Server::setupSocket() {
-    listen_fd_ = socket(AF_INET, SOCK_STREAM, 0);
-    if (listen_fd_ == -1) {
-        logger_->log(LogLevel::ERROR, "Failed to create socket.");
-        throw std::runtime_error("Failed to create socket.");
+    const uint64_t over_limit = admission_.rejected(AdmissionControl::Rejection::OVER_LIMIT);
+    const uint64_t no_fd = admission_.rejected(AdmissionControl::Rejection::NO_FD);
+    if (over_limit + no_fd > 0) {
+        logger_->log(LogLevel::INFO, std::format("Rejected {} connection(s): {} over limit, {} out of file descriptors",
+                                                 over_limit + no_fd, over_limit, no_fd));
     }
+}
 
-    // 配置服务器地址结构
-    sockaddr_in addr{};
-    addr.sin_family = AF_INET;
-    addr.sin_port = htons(port_);
-    addr.sin_addr.s_addr = INADDR_ANY;
-
-    // 设置 socket 选项：快速重用地址
-    constexpr int opt = 1;
-    setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+void Server::run() {
+    logger_->logDivider("Server start");
 
-    // 绑定 socket 到地址
-    if (bind(listen_fd_, toSockaddr(&addr), sizeof(addr)) == -1) {
-        logger_->log(LogLevel::ERROR, "Failed to bind socket.");
-        throw std::runtime_error("Failed to bind socket.");
+    // 信号已在创建任何线程之前屏蔽，只能经 signalfd 读取；所有 Reactor 在独立线程中运行，
+    // 当前线程等待信号与 Reactor 退出通知，收到信号时无需等待网络事件
+    const FileDescriptor exited(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC));
+    if (!exited.valid()) {
+        throw std::runtime_error(std::format("Failed to create eventfd: {}", strerror(errno)));
     }
 
-    // 开始监听连接请求
-    if (listen(listen_fd_, SOMAXCONN) == -1) {
-        logger_->log(LogLevel::ERROR, "Failed to listen on socket.");
-        throw std::runtime_error("Failed to listen on socket.");
-    }
+    control_.addFd(signal_handler_->fd(), EPOLLIN, EventBackend::eventData(signal_handler_->fd()));
+    control_.addFd(exited.get(), EPOLLIN, EventBackend::eventData(exited.get()));
 
-    // 设置监听 socket 为非阻塞
-    setNonBlocking(listen_fd_);
+    std::vector<std::thread> threads;
+    for (const auto& reactor : reactors_) {
+        threads.emplace_back([reactor = reactor.get(), exited_fd = exited.get()] {
+            reactor->run();
 
-    logger_->log(LogLevel::INFO, std::format("Server listening on port {}", port_));
-}
-
-void Server::setupEpoll() const {
-    try {
-        epoll_manager_.addFd(listen_fd_, EPOLLIN | EPOLLET);
-        logger_->log(LogLevel::INFO, "EpollManager initialized and listening socket registered");
-    } catch (const std::exception& e) {
-        logger_->log(LogLevel::ERROR, std::format("Epoll setup failed: {}", e.what()));
-        throw;
+            constexpr uint64_t value = 1;
+            [[maybe_unused]] const ssize_t bytes = write(exited_fd, &value, sizeof(value));
+        });
     }
-}
 
-void Server::run() {
-    logger_->logDivider("Server start");
+    // 热重启启动的新进程：此时已开始 accept，通知旧进程优雅关闭
+    hot_restart_.notifyReady();
+
+    uint64_t finished = 0;
+    std::array<epoll_event, 3> events{};
+    while (finished < threads.size()) {
+        const int event_count = control_.wait(events);
+        if (event_count == -1 && errno != EINTR) {
+            logger_->log(LogLevel::ERROR, std::format("Failed to wait for signals: {}", strerror(errno)));
+            running_ = false;
+            for (const auto& reactor : reactors_) {
+                reactor->wakeup();
+            }
+            break;
+        }
 
-    std::array<epoll_event, MAX_EVENTS> events{};
-    while (running_) {
-        const int event_count = epoll_manager_.wait(events, -1);
         for (int i = 0; i < event_count; ++i) {
-            if (const int client_fd = events.at(i).data.fd; client_fd == listen_fd_) {
-                handleNewConnection();
-            } else {
-                dispatchClient(client_fd, events.at(i).events);
+            const int ready_fd = EventBackend::eventFd(events.at(i).data.u64);
+            if (ready_fd == signal_handler_->fd()) {
+                handleSignals();
+                continue;
+            }
+            if (ready_fd == restart_pipe_.get()) {
+                finishHotRestart();
+                continue;
             }
-        }
-    }
-}
 
-void Server::handleNewConnection() {
-    while (true) {
-        sockaddr_in client_addr{};
-        socklen_t len = sizeof(client_addr);
-        const int client_fd = accept(listen_fd_, toSockaddr(&client_addr), &len);
-        if (client_fd == -1) {
-            if (errno == EAGAIN || errno == EWOULDBLOCK) {
-                break;  // 无更多连接
+            uint64_t value = 0;
+            if (read(exited.get(), &value, sizeof(value)) == sizeof(value)) {
+                finished += value;
             }
-            logger_->log(LogLevel::ERROR, "Failed to accept client connection.");
-            throw std::runtime_error("Failed to accept client connection.");
         }
+    }
 
-        // 设置客户端 socket 为非阻塞
-        setNonBlocking(client_fd);
+    for (auto& thread : threads) {
+        thread.join();
+    }
 
-        const auto conn = std::make_shared<Connection>(client_fd, client_addr, &epoll_manager_, logger_, static_file_,
-                                                       user_manager_, linger_);
+    // 工作线程中可能还有任务持有连接，必须在 Reactor（及其事件后端）销毁之前完成
+    thread_pool_->waitIdle();
+}
 
-        if (!conn) {
-            logger_->log(LogLevel::ERROR, "Failed to create connection object.");
-            close(client_fd);
+void Server::handleSignals() {
+    while (const int signal = signal_handler_->next()) {
+        if (signal == SIGHUP) {
+            startHotRestart();
             continue;
         }
 
-        conn->setCloseRequestCallback([this](const int close_fd) {
-            std::lock_guard lock(connections_mutex_);
-            connections_.erase(close_fd);
-        });
+        if (!shutting_down_) {
+            // 停止 accept，等待现有连接发送完当前响应
+            logger_->log(LogLevel::INFO, std::format("Received SIG{}, shutting down gracefully (timeout {} s)",
+                                                     sigabbrev_np(signal), server_options_.shutdown_timeout.count()));
+            beginShutdown();
+            continue;
+        }
 
-        std::lock_guard lock(connections_mutex_);
-        connections_[client_fd] = conn;
+        logger_->log(LogLevel::WARNING, std::format("Received SIG{} again, shutting down immediately",
+                                                    sigabbrev_np(signal)));
+        running_ = false;
+        for (const auto& reactor : reactors_) {
+            reactor->wakeup();
+        }
     }
 }
 
-void Server::dispatchClient(const int client_fd, const uint32_t events) {
-    std::shared_ptr<Connection> conn;
-    {
-        std::lock_guard lock(connections_mutex_);
-        const auto iter = connections_.find(client_fd);
-        if (iter == connections_.end()) {
-            return;
-        }
-        conn = iter->second;
+void Server::beginShutdown() {
+    shutting_down_ = true;
+
+    // 监听 socket 由各 Reactor 在停止 accept 时关闭
+    listeners_.clear();
+
+    const auto deadline = TimerWheel::Clock::now() + server_options_.shutdown_timeout;
+    for (const auto& reactor : reactors_) {
+        reactor->drain(deadline);
     }
+}
 
-    if (!conn) {
-        logger_->log(LogLevel::WARNING, "Connection is null, cannot dispatch.");
+void Server::startHotRestart() {
+    if (shutting_down_ || restart_pipe_.valid()) {
+        logger_->log(LogLevel::WARNING, "Received SIGHUP, but a restart or shutdown is already in progress");
         return;
     }
 
+    logger_->log(LogLevel::INFO, "Received SIGHUP, starting hot restart");
     try {
-        thread_pool_->enqueue([conn, events] {
-            if (events & EPOLLIN) {
-                conn->handleRead();
-            }
-            if (events & EPOLLOUT) {
-                conn->handleWrite();
-            }
-        });
+        restart_pipe_ = hot_restart_.spawn(listeners_);
+        control_.addFd(restart_pipe_.get(), EPOLLIN, EventBackend::eventData(restart_pipe_.get()));
     } catch (const std::exception& e) {
-        logger_->log(LogLevel::ERROR, conn->info(), std::format("Failed to enqueue task: {}", e.what()));
+        logger_->log(LogLevel::ERROR, std::format("Hot restart failed: {}", e.what()));
+        restart_pipe_ = FileDescriptor(-1);
     }
 }
 
-int Server::setNonBlocking(const int socket_fd) {
-    const int old_flags = fcntl(socket_fd, F_GETFL);           // NOLINT(cppcoreguidelines-pro-type-vararg)
-    return fcntl(socket_fd, F_SETFL, old_flags | O_NONBLOCK);  // NOLINT(cppcoreguidelines-pro-type-vararg)
+void Server::finishHotRestart() {
+    const bool ready = hot_restart_.checkReady(restart_pipe_.get());
+    control_.delFd(restart_pipe_.get());
+    restart_pipe_ = FileDescriptor(-1);
+
+    if (!ready || shutting_down_) {
+        return;
+    }
+
+    // 新进程持有同一组监听 socket，本进程关闭自己的 fd 后不再分得新连接，Unix 域 socket 文件保留给新进程
+    for (const auto& listener : listeners_) {
+        listener->handOff();
+    }
+    logger_->log(LogLevel::INFO, std::format("Handing over to the new process, shutting down gracefully (timeout {} s)",
+                                             server_options_.shutdown_timeout.count()));
+    beginShutdown();
 }
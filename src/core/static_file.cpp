@@ -3,24 +3,43 @@
 #include <algorithm>
 #include <array>
 #include <cstddef>
+#include <ctime>
 #include <filesystem>
 #include <format>
 #include <fstream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <shared_mutex>
 #include <sstream>
 #include <string>
+#include <system_error>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include <sys/stat.h>
+
 #include "core/http_request.h"
 #include "core/http_response.h"
-#include "user/session_manager.h"
-#include "utils/cookie_parser.h"
+#include "core/request_context.h"
+#include "utils/file_descriptor.h"
 #include "utils/logger.h"
 #include "utils/mime_type.h"
+#include "utils/range_parser.h"
+#include "utils/request_arena.h"
+#include "utils/upload_file.h"
 #include "utils/url.h"
 
 namespace {
+    constexpr std::uintmax_t MAX_CACHED_FILE_SIZE = 1024 * 1024;  // 超过该大小的静态文件不进入内存缓存
+    constexpr size_t DIRECTORY_CANCEL_CHECK_INTERVAL = 256;       // 遍历目录时每隔多少项检查一次取消
+
+    // 快速路径不检查文件是否修改，只使用在该时间内由工作线程确认过的缓存，文件修改后最多延迟这么久生效
+    constexpr std::chrono::seconds FAST_CACHE_REVALIDATE_INTERVAL{1};
+    constexpr size_t MAX_FAST_CACHE_ENTRIES = 1024;  // 快速路径索引的槽位数，超出时逐个淘汰
+
     std::string formatSize(const std::uintmax_t bytes) {
         constexpr std::array<const char*, 5> units = {"B", "KB", "MB", "GB", "TB"};
         constexpr int base = 1024;
@@ -82,16 +101,102 @@ namespace {
     std::string ensureTrailingSlash(const std::string& path) {
         return path.ends_with('/') ? path : path + '/';
     }
+
+    // 流式生成的目录列表，每次生成一批表格行
+    struct DirectoryListing {
+        static constexpr size_t ENTRIES_PER_CHUNK = 64;
+
+        std::vector<std::filesystem::directory_entry> entries;  // 目录在前，文件在后
+        size_t directory_count = 0;
+        std::string base_path;
+        bool parent_link = false;
+        size_t next = 0;
+
+        bool produce(std::string& chunk) {
+            if (next == 0 && parent_link) {
+                // 返回上级
+                chunk += R"(
+        <tr>
+            <td><a href="../">⬅️ ../</a></td>
+            <td>-</td>
+            <td>-</td>
+            <td>-</td>
+        </tr>)";
+            }
+
+            const size_t end = std::min(entries.size(), next + ENTRIES_PER_CHUNK);
+            for (; next < end; ++next) {
+                appendRow(chunk, entries[next], next < directory_count);
+            }
+            return next < entries.size();
+        }
+
+        void appendRow(std::string& chunk, const std::filesystem::directory_entry& entry,
+                       const bool is_directory) const {
+            // 目录项可能在列出之后被删除，此时跳过该行
+            std::error_code error;
+            const auto write_time = entry.last_write_time(error);
+            if (error) {
+                return;
+            }
+            const std::uintmax_t size = is_directory ? 0 : entry.file_size(error);
+            if (error) {
+                return;
+            }
+
+            const std::string name = htmlEscape(entry.path().filename().string());
+            const std::string time = formatTime(write_time);
+
+            if (is_directory) {
+                // 目录
+                const std::string href = (std::filesystem::path(base_path) / Url::encode(name)).string() + '/';
+                chunk += std::format(R"(
+        <tr>
+            <td><a href="{}">📁 {}/</a></td>
+            <td>-</td>
+            <td>{}</td>
+            <td>-</td>
+        </tr>)",
+                                     href, name, time);
+                return;
+            }
+
+            // 文件
+            const std::string href = (std::filesystem::path(base_path) / Url::encode(name)).string();
+            chunk += std::format(R"(
+        <tr>
+            <td><a href="{}">📄 {}</a></td>
+            <td>{}</td>
+            <td>{}</td>
+            <td><a href="{}" download>下载</a></td>
+        </tr>)",
+                                 href, name, formatSize(size), time, href);
+        }
+    };
+
+    std::string formatHttpDate(const std::time_t time) {
+        std::tm gmt{};
+        gmtime_r(&time, &gmt);
+
+        std::ostringstream oss;
+        oss << std::put_time(&gmt, "%a, %d %b %Y %H:%M:%S GMT");
+        return oss.str();
+    }
+
+    uint64_t randomBoundary() {
+        thread_local std::mt19937_64 gen(std::random_device{}());
+        return gen();
+    }
 }  // namespace
 
 StaticFile::StaticFile(const std::filesystem::path& root, const std::string& static_dir, std::string drive_dir,
-                       Logger* logger, SessionManager* session_manager)
+                       Logger* logger)
     : static_path_(weakly_canonical(root / static_dir)),
       templates_path_(weakly_canonical(root / "templates")),
       drive_url_(std::move(drive_dir)),
       drive_path_(weakly_canonical(root / "data/files")),
       logger_(logger),
-      session_manager_(session_manager) {
+      fast_cache_slots_(MAX_FAST_CACHE_ENTRIES) {
     logger_->log(LogLevel::INFO, "StaticFile initialized");
     logger_->log(LogLevel::INFO, std::format("-- staticfile_path: {}", static_path_.string()));
     logger_->log(LogLevel::INFO, std::format("-- templates_path: {}", templates_path_.string()));
@@ -107,22 +212,24 @@ std::filesystem::path StaticFile::getDrivePath() const {
     return drive_path_;
 }
 
-HttpResponse StaticFile::serve(const HttpRequest& request, const Address& info) const {
+HttpResponse StaticFile::serve(const RequestContext& context, const Address& info,
+                               const CancellationToken& cancel) const {
     auto page_type = PageType::NORMAL;
 
-    auto raw = serveRaw(request, info, page_type);
+    auto raw = serveRaw(context.request(), info, page_type, cancel);
 
-    if (raw.getContentType().starts_with("text/html")) {
+    if (!raw.hasFileBody() && raw.getContentType().starts_with("text/html")) {
         // 如果是 HTML 文件，则渲染模板
-        return render(std::move(raw), request, page_type);
+        return render(std::move(raw), context, page_type);
     }
 
     // 否则直接返回
     return raw;
 }
 
-HttpResponse StaticFile::serveRaw(const HttpRequest& request, const Address& info, PageType& page_type) const {
-    const std::string& path = request.path();
+HttpResponse StaticFile::serveRaw(const HttpRequest& request, const Address& info, PageType& page_type,
+                                  const CancellationToken& cancel) const {
+    const std::string_view path = Url::stripQuery(request.path());
     const std::string decoded_path = Url::decode(path);
     const auto [full_path, type] = getFileInfo(decoded_path);
     page_type = type;
@@ -139,7 +246,7 @@ HttpResponse StaticFile::serveRaw(const HttpRequest& request, const Address& inf
     if (isDriveUrl(decoded_path) && is_directory(full_path)) {
         // 如果请求的路径没有以斜杠结尾，则重定向到目录
         if (!path.ends_with('/')) {
-            std::string location = path + '/';
+            std::string location = std::string(path) + '/';
             logger_->log(LogLevel::INFO, info,
                          std::format("Redirecting to directory with trailing slash: {} -> {}", path, location));
 
@@ -150,12 +257,12 @@ HttpResponse StaticFile::serveRaw(const HttpRequest& request, const Address& inf
         // 如果请求的路径以斜杠结尾，则返回目录列表
         if (path.ends_with('/')) {
             // 获取相对于 files 的路径
-            std::string virtual_path = path.substr(std::string(drive_url_).length() + 1);
+            std::string virtual_path(path.substr(drive_url_.length() + 1));
             virtual_path = ensureTrailingSlash(virtual_path);
 
             // 生成网盘目录列表
             logger_->log(LogLevel::DEBUG, info, std::format("Serving directory listing for: {}", full_path.string()));
-            return generateDirectoryListing(full_path, virtual_path);
+            return generateDirectoryListing(full_path, virtual_path, cancel);
         }
     }
 
@@ -166,12 +273,21 @@ HttpResponse StaticFile::serveRaw(const HttpRequest& request, const Address& inf
         return HttpResponse::responseError(error_code);
     }
 
-    if (const auto cached = readFromCache(full_path, info)) {
+    if (isDriveUrl(decoded_path) || (exists(full_path) && file_size(full_path) > MAX_CACHED_FILE_SIZE)) {
+        // 网盘文件与大文件不读入内存，由连接通过 sendfile 直接发送
+        return serveFile(full_path, request, info);
+    }
+
+    if (auto cached = readFromCache(full_path, info)) {
         // 从缓存中取文件
         logger_->log(LogLevel::DEBUG, info, "Static file served from cache.");
-        return *cached;
+        updateFastCache(decoded_path, cached);
+        return {*cached, RequestArena::resource()};
     }
 
+    // 读取文件前确认客户端仍在等待
+    cancel.throwIfCancelled();
+
     std::ifstream file(full_path, std::ios::binary);
     if (!file.is_open()) {
         // 找不到文件，返回 404
@@ -186,37 +302,122 @@ HttpResponse StaticFile::serveRaw(const HttpRequest& request, const Address& inf
     HttpResponse builder;
     builder.setStatus("200 OK").setContentType(MimeType::get(full_path)).setBody(oss.str());
 
-    // 存入缓存
-    updateCache(full_path, builder);
+    // 存入缓存：复制时改用默认分配器，缓存内容不随请求内存池释放
+    if (auto cached = updateCache(full_path, builder)) {
+        updateFastCache(decoded_path, std::move(cached));
+    }
     logger_->log(LogLevel::DEBUG, info, "Static file loaded and cached.");
 
     return builder;
 }
 
-HttpResponse StaticFile::render(HttpResponse builder, const HttpRequest& request, const PageType page_type) const {
+HttpResponse StaticFile::serveFile(const std::filesystem::path& path, const HttpRequest& request,
+                                   const Address& info) const {
+    const auto file = FileDescriptor::openReadOnly(path);
+    if (!file) {
+        // 找不到文件，返回 404
+        logger_->log(LogLevel::DEBUG, info, "File not found, return 404.");
+        constexpr int error_code = 404;
+        return HttpResponse::responseError(error_code);
+    }
+
+    struct stat file_stat {};
+    if (fstat(file->get(), &file_stat) == -1) {
+        logger_->log(LogLevel::ERROR, info, std::format("Failed to stat file: {}", path.string()));
+        constexpr int error_code = 500;
+        return HttpResponse::responseError(error_code);
+    }
+
+    const auto size = static_cast<uint64_t>(file_stat.st_size);
+    const std::string_view content_type = MimeType::get(path);
+    const std::string last_modified = formatHttpDate(file_stat.st_mtim.tv_sec);
+    const std::string etag = std::format(R"("{:x}-{:x}{:09x}")", size, file_stat.st_mtim.tv_sec,
+                                         file_stat.st_mtim.tv_nsec);
+
+    HttpResponse builder;
+    builder.setContentType(content_type)
+        .addHeader(HttpHeader::ACCEPT_RANGES, "bytes")
+        .addHeader(HttpHeader::LAST_MODIFIED, last_modified)
+        .addHeader(HttpHeader::ETAG, etag);
+
+    // 解析 Range：If-Range 条件不满足或语法无效时忽略，返回完整内容
+    std::optional<std::vector<ByteRange>> ranges;
+    if (const auto range = request.getHeader(HttpHeader::RANGE)) {
+        const auto if_range = request.getHeader(HttpHeader::IF_RANGE);
+        if (!if_range || RangeParser::ifRangeMatches(*if_range, etag, last_modified)) {
+            ranges = RangeParser::parse(*range, size);
+        }
+    }
+
+    if (!ranges) {
+        logger_->log(LogLevel::DEBUG, info, std::format("Streaming file: {} ({})", path.string(), formatSize(size)));
+        builder.setStatus("200 OK").setFile(file, 0, size);
+        return builder;
+    }
+
+    if (ranges->empty()) {
+        // 所有范围均不可满足
+        logger_->log(LogLevel::DEBUG, info, "Range not satisfiable, return 416.");
+        constexpr int error_code = 416;
+        HttpResponse response = HttpResponse::responseError(error_code);
+        response.addHeader(HttpHeader::CONTENT_RANGE, std::format("bytes */{}", size));
+        return response;
+    }
+
+    builder.setStatus("206 Partial Content");
+
+    if (ranges->size() == 1) {
+        const ByteRange& range = ranges->front();
+        logger_->log(LogLevel::DEBUG, info,
+                     std::format("Streaming range {}-{} of file: {}", range.first, range.last, path.string()));
+        builder.addHeader(HttpHeader::CONTENT_RANGE, std::format("bytes {}-{}/{}", range.first, range.last, size))
+            .setFile(file, static_cast<off_t>(range.first), range.length());
+        return builder;
+    }
+
+    // 多个范围：以 multipart/byteranges 返回，各部分的文件内容仍通过 sendfile 发送
+    const std::string boundary = std::format("SKYDRIVE_BYTERANGES_{:016x}", randomBoundary());
+    builder.setContentType(std::format("multipart/byteranges; boundary={}", boundary));
+
+    for (const ByteRange& range : *ranges) {
+        builder.appendData(std::format("\r\n--{}\r\nContent-Type: {}\r\nContent-Range: bytes {}-{}/{}\r\n\r\n",
+                                       boundary, content_type, range.first, range.last, size));
+        builder.appendFile(file, static_cast<off_t>(range.first), range.length());
+    }
+    builder.appendData(std::format("\r\n--{}--\r\n", boundary));
+
+    logger_->log(LogLevel::DEBUG, info,
+                 std::format("Streaming {} ranges of file: {}", ranges->size(), path.string()));
+    return builder;
+}
+
+HttpResponse StaticFile::render(HttpResponse builder, const RequestContext& context, const PageType page_type) const {
     builder.renderTemplate("footer", getTemplate("footer.html").value_or(""));
 
     if (page_type == PageType::AUTH) {
         // 认证页面
-        return builder.renderTemplate("header-auth", getTemplate("header-auth.html").value_or(""));
+        builder.renderTemplate("header-auth", getTemplate("header-auth.html").value_or(""));
+        return builder;
     }
 
-    const auto session_id = CookieParser::get(request, "session_id");
-    if (!session_id) {
+    if (!context.sessionId()) {
         // 未登录
-        return builder.renderTemplate("header", getTemplate("header-guest.html").value_or(""));
+        builder.renderTemplate("header", getTemplate("header-guest.html").value_or(""));
+        return builder;
     }
 
-    const auto username = session_manager_->getUsername(*session_id);
+    const auto& username = context.username();
     if (!username) {
         // 会话过期
-        return builder.addHeader("Set-Cookie", "session_id=; Path=/; HttpOnly; Max-Age=0")
+        builder.addHeader(HttpHeader::SET_COOKIE, "session_id=; Path=/; HttpOnly; Max-Age=0")
             .renderTemplate("header", getTemplate("header-guest.html").value_or(""));
+        return builder;
     }
 
     // 已登录
-    return builder.renderTemplate("header", getTemplate("header-user.html").value_or(""))
+    builder.renderTemplate("header", getTemplate("header-user.html").value_or(""))
         .renderTemplate("username", *username);
+    return builder;
 }
 
 std::optional<std::string> StaticFile::getTemplate(const std::string& name) const {
@@ -234,13 +435,30 @@ std::optional<std::string> StaticFile::getTemplate(const std::string& name) cons
 }
 
 HttpResponse StaticFile::generateDirectoryListing(const std::filesystem::path& path,
-                                                  const std::string& request_path) const {
-    std::vector<std::filesystem::directory_entry> directories;
-    std::vector<std::filesystem::directory_entry> files;
+                                                  const std::string& request_path,
+                                                  const CancellationToken& cancel) const {
+    auto temp = getTemplate("directory-listing.html");
+    if (!temp) {
+        // 模板文件不存在，返回 500 错误
+        constexpr int error_code = 500;
+        return HttpResponse::responseError(error_code);
+    }
 
+    // 此处只读取目录项并排序，各行的 stat 与格式化推迟到发送时分批进行
+    auto listing = std::make_shared<DirectoryListing>();
+    std::vector<std::filesystem::directory_entry> files;
+    size_t scanned = 0;
     for (const auto& entry : std::filesystem::directory_iterator(path)) {
+        if (++scanned % DIRECTORY_CANCEL_CHECK_INTERVAL == 0) {
+            // 大目录的遍历可能很慢，客户端断开后不再继续
+            cancel.throwIfCancelled();
+        }
+        if (entry.path().filename().string().starts_with(UploadFile::TEMP_FILE_PREFIX)) {
+            // 正在接收的上传文件
+            continue;
+        }
         if (entry.is_directory()) {
-            directories.emplace_back(entry);
+            listing->entries.emplace_back(entry);
         } else {
             files.emplace_back(entry);
         }
@@ -249,73 +467,27 @@ HttpResponse StaticFile::generateDirectoryListing(const std::filesystem::path& p
     auto filename_less = [](const auto& lhs_entry, const auto& rhs_entry) {
         return lhs_entry.path().filename().string() < rhs_entry.path().filename().string();
     };
-    std::ranges::sort(directories, filename_less);
+    cancel.throwIfCancelled();
+    std::ranges::sort(listing->entries, filename_less);
     std::ranges::sort(files, filename_less);
 
-    std::ostringstream entries;
-
-    // 返回上级
-    if (request_path != "/") {
-        entries << R"(
-        <tr>
-            <td><a href="../">⬅️ ../</a></td>
-            <td>-</td>
-            <td>-</td>
-            <td>-</td>
-        </tr>)";
-    }
-
-    std::string base_path = '/' + drive_url_ + request_path;
-    base_path = ensureTrailingSlash(base_path);
-
-    // 目录
-    for (const auto& dir : directories) {
-        const std::string name = htmlEscape(dir.path().filename().string());
-        const std::string href = (std::filesystem::path(base_path) / Url::encode(name)).string() + '/';
-        const std::string time = formatTime(last_write_time(dir));
-
-        entries << std::format(R"(
-        <tr>
-            <td><a href="{}">📁 {}/</a></td>
-            <td>-</td>
-            <td>{}</td>
-            <td>-</td>
-        </tr>)",
-                               href, name, time);
-    }
-
-    // 文件
-    for (const auto& file : files) {
-        const std::string name = htmlEscape(file.path().filename().string());
-        const std::string href = (std::filesystem::path(base_path) / Url::encode(name)).string();
-        const std::string size = formatSize(file_size(file));
-        const std::string time = formatTime(last_write_time(file));
-
-        entries << std::format(R"(
-        <tr>
-            <td><a href="{}">📄 {}</a></td>
-            <td>{}</td>
-            <td>{}</td>
-            <td><a href="{}" download>下载</a></td>
-        </tr>)",
-                               href, name, size, time, href);
-    }
-
-    auto temp = getTemplate("directory-listing.html");
-    if (!temp) {
-        // 模板文件不存在，返回 500 错误
-        constexpr int error_code = 500;
-        return HttpResponse::responseError(error_code);
-    }
+    listing->directory_count = listing->entries.size();
+    std::ranges::move(files, std::back_inserter(listing->entries));
+    listing->base_path = ensureTrailingSlash('/' + drive_url_ + request_path);
+    listing->parent_link = request_path != "/";
 
     const std::string& html = *temp;
 
-    return HttpResponse{}
-        .setStatus("200 OK")
+    HttpResponse response;
+    response.setStatus("200 OK")
         .setContentType("text/html; charset=UTF-8")
         .setBody(html)
         .renderTemplate("path", Url::decode(request_path))
-        .renderTemplate("entries", entries.str());
+        .streamTemplate("entries", [listing, cancel](std::string& chunk) {
+            cancel.throwIfCancelled();
+            return listing->produce(chunk);
+        });
+    return response;
 }
 
 bool StaticFile::isPathSafe(const std::filesystem::path& path) const {
@@ -368,38 +540,125 @@ std::pair<std::filesystem::path, PageType> StaticFile::getFileInfo(const std::st
     return {weakly_canonical(static_path_ / clean_path), PageType::NORMAL};
 }
 
-std::optional<HttpResponse> StaticFile::readFromCache(const std::filesystem::path& path, const Address& info) const {
-    std::lock_guard lock(cache_mutex_);
-    const auto cache_iter = cache_.find(path);
+std::shared_ptr<const HttpResponse> StaticFile::findCached(const std::string_view url) const {
+    // 与 serveRaw 使用相同的键；多数路径无需解码，直接查找
+    const std::string_view path = Url::stripQuery(url);
+    std::string decoded;
+    if (path.find_first_of("%+") != std::string_view::npos) {
+        decoded = Url::decode(path);
+    }
+    const std::string_view key = decoded.empty() ? path : std::string_view(decoded);
+
+    std::shared_lock lock(cache_mutex_);
+    const auto iter = fast_cache_.find(key);
+    if (iter == fast_cache_.end()) {
+        return nullptr;
+    }
+    FastCacheEntry& entry = fast_cache_slots_[iter->second];
+    if (std::chrono::steady_clock::now() - entry.validated_at > FAST_CACHE_REVALIDATE_INTERVAL) {
+        return nullptr;
+    }
+    entry.referenced.store(true, std::memory_order_relaxed);
+    return entry.builder;
+}
 
-    if (cache_iter == cache_.end()) {
+std::shared_ptr<const HttpResponse> StaticFile::readFromCache(const std::filesystem::path& path,
+                                                              const Address& info) const {
+    CacheEntry entry;
+    {
+        // 查找只需共享锁，文件状态检查与日志都在锁外进行
+        std::shared_lock lock(cache_mutex_);
+        const auto cache_iter = cache_.find(path);
+        if (cache_iter != cache_.end()) {
+            entry = cache_iter->second;
+        }
+    }
+
+    if (!entry.builder) {
         logger_->log(LogLevel::DEBUG, info, std::format("Cache miss: {}", path.string()));
-        return std::nullopt;
+        return nullptr;
     }
 
-    if (!exists(path)) {
+    std::error_code error;
+    const auto last_modified = last_write_time(path, error);
+    if (error) {
         logger_->log(LogLevel::DEBUG, info, std::format("Cache erase (file missing): {}", path.string()));
-        cache_.erase(cache_iter);
-        return std::nullopt;
+        {
+            // 只有删除条目时才需要独占锁；期间条目可能已被其他线程更新，此时保留新条目
+            std::lock_guard lock(cache_mutex_);
+            if (const auto cache_iter = cache_.find(path);
+                cache_iter != cache_.end() && cache_iter->second.builder == entry.builder) {
+                cache_.erase(cache_iter);
+            }
+        }
+        return nullptr;
     }
 
-    if (cache_iter->second.last_modified != last_write_time(path)) {
+    if (entry.last_modified != last_modified) {
         logger_->log(LogLevel::DEBUG, info, std::format("Cache stale: {}", path.string()));
-        return std::nullopt;
+        return nullptr;
     }
 
     logger_->log(LogLevel::DEBUG, info, std::format("Cache hit: {}", path.string()));
-    return cache_iter->second.builder;
+    return entry.builder;
 }
 
-void StaticFile::updateCache(const std::filesystem::path& path, const HttpResponse& builder) const {
+std::shared_ptr<const HttpResponse> StaticFile::updateCache(const std::filesystem::path& path,
+                                                            HttpResponse builder) const {
+    // 非 HTML 内容不再渲染模板，响应体放入共享片段，命中缓存时只需复制响应头
+    if (!builder.getContentType().starts_with("text/html")) {
+        builder.shareBody();
+    }
+
     try {
-        CacheEntry entry = {.builder = builder, .last_modified = last_write_time(path)};
+        CacheEntry entry = {.builder = std::make_shared<const HttpResponse>(std::move(builder)),
+                            .last_modified = last_write_time(path)};
+        auto cached = entry.builder;
 
         std::lock_guard lock(cache_mutex_);
         cache_[path] = std::move(entry);
+        return cached;
     } catch (const std::filesystem::filesystem_error& e) {
         // 极端文件丢失情况
         logger_->log(LogLevel::ERROR, std::format("updateCache failed: {} ({})", e.what(), path.string()));
+        return nullptr;
+    }
+}
+
+void StaticFile::updateFastCache(const std::string_view path, std::shared_ptr<const HttpResponse> builder) const {
+    // HTML 需要按会话渲染模板，每次都交给工作线程
+    if (builder->getContentType().starts_with("text/html")) {
+        return;
+    }
+
+    std::lock_guard lock(cache_mutex_);
+    size_t slot = 0;
+    if (const auto iter = fast_cache_.find(path); iter != fast_cache_.end()) {
+        slot = iter->second;
+    } else {
+        slot = fast_cache_used_ < fast_cache_slots_.size() ? fast_cache_used_++ : evictFastCache();
+        fast_cache_slots_[slot].url = path;
+        fast_cache_.emplace(path, slot);
+    }
+
+    FastCacheEntry& entry = fast_cache_slots_[slot];
+    entry.builder = std::move(builder);
+    entry.validated_at = std::chrono::steady_clock::now();
+    entry.referenced.store(true, std::memory_order_relaxed);
+}
+
+size_t StaticFile::evictFastCache() const {
+    // 依次检查各槽位：最近被访问过的清除访问位后跳过，第一个未被访问的条目被淘汰
+    while (true) {
+        const size_t slot = fast_cache_hand_;
+        fast_cache_hand_ = (fast_cache_hand_ + 1) % fast_cache_slots_.size();
+
+        FastCacheEntry& entry = fast_cache_slots_[slot];
+        if (entry.referenced.exchange(false, std::memory_order_relaxed)) {
+            continue;
+        }
+        fast_cache_.erase(entry.url);
+        entry.builder.reset();
+        return slot;
     }
 }
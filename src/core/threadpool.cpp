@@ -1,10 +1,13 @@
 #include "core/threadpool.h"
 
+#include <chrono>
 #include <format>
 
 #include "utils/logger.h"
 
-ThreadPool::ThreadPool(const size_t thread_count, Logger* logger) : stop_(false), logger_(logger) {
+ThreadPool::ThreadPool(const size_t thread_count, Logger* logger, const std::chrono::milliseconds queue_target,
+                       const std::chrono::milliseconds queue_interval)
+    : stop_(false), queue_target_(queue_target), queue_interval_(queue_interval), logger_(logger) {
     // 创建并启动指定数量的线程
     for (size_t i = 0; i < thread_count; ++i) {
         workers_.emplace_back([this, i] { this->workerLoop(i); });
@@ -32,11 +35,56 @@ void ThreadPool::enqueue(std::function<void()> task) {
         if (stop_) {
             throw std::runtime_error("ThreadPool has been stopped. Cannot enqueue new tasks.");
         }
-        tasks_.emplace(std::move(task));
+        tasks_.push({.function = std::move(task), .enqueued = Clock::now()});
+        updateOverloadFromHead();
     }
     condition_.notify_one();
 }
 
+bool ThreadPool::overloaded() {
+    if (queue_target_ == std::chrono::milliseconds::zero()) {
+        return false;
+    }
+
+    // 队列为空时新任务无需排队，放行后由它出队时实测的排队时间更新状态，否则过载状态可能无法解除
+    std::lock_guard lock(tasks_mutex_);
+    updateOverloadFromHead();
+    return overloaded_.load(std::memory_order_relaxed) && !tasks_.empty();
+}
+
+void ThreadPool::updateOverloadFromHead() {
+    // 队列为空时没有积压，状态由最后一个任务出队时更新
+    if (!tasks_.empty()) {
+        updateOverload(Clock::now() - tasks_.front().enqueued);
+    }
+}
+
+void ThreadPool::updateOverload(const Clock::duration sojourn) {
+    if (queue_target_ == std::chrono::milliseconds::zero()) {
+        return;
+    }
+
+    // 只有实测的排队时间回落到目标值以下才说明积压已经消化，队列暂时为空不改变状态
+    if (sojourn < queue_target_) {
+        above_target_since_ = {};
+        if (overloaded_.exchange(false, std::memory_order_relaxed)) {
+            logger_->log(LogLevel::INFO, "ThreadPool recovered from overload");
+        }
+        return;
+    }
+
+    // 偶发的突发流量会很快消化，只有持续一个 interval 都超标才视为过载
+    const auto now = Clock::now();
+    if (above_target_since_ == Clock::time_point{}) {
+        above_target_since_ = now;
+    } else if (now - above_target_since_ >= queue_interval_ && !overloaded_.exchange(true, std::memory_order_relaxed)) {
+        logger_->log(LogLevel::WARNING,
+                     std::format("ThreadPool overloaded: queueing delay {} ms above target {} ms, shedding new requests",
+                                 std::chrono::duration_cast<std::chrono::milliseconds>(sojourn).count(),
+                                 queue_target_.count()));
+    }
+}
+
 void ThreadPool::workerLoop(size_t thread_id) {
     while (!stop_) {
         std::function<void()> task;
@@ -54,8 +102,11 @@ void ThreadPool::workerLoop(size_t thread_id) {
             }
 
             // 取出一个任务
-            task = std::move(tasks_.front());
+            task = std::move(tasks_.front().function);
+            const Clock::duration sojourn = Clock::now() - tasks_.front().enqueued;
             tasks_.pop();
+            updateOverload(sojourn);
+            ++active_;
         }
 
         // 执行任务
@@ -66,5 +117,19 @@ void ThreadPool::workerLoop(size_t thread_id) {
         } catch (...) {
             logger_->log(LogLevel::ERROR, std::format("Thread {} unknown exception.", thread_id));
         }
+
+        // 任务捕获的对象（如连接）也在此释放，之后才算完成
+        task = nullptr;
+        {
+            std::lock_guard lock(tasks_mutex_);
+            if (--active_ == 0 && tasks_.empty()) {
+                idle_condition_.notify_all();
+            }
+        }
     }
 }
+
+void ThreadPool::waitIdle() {
+    std::unique_lock lock(tasks_mutex_);
+    idle_condition_.wait(lock, [this] { return active_ == 0 && tasks_.empty(); });
+}
@@ -0,0 +1,91 @@
+#include "core/timer_wheel.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+
+TimerWheel::TimerWheel(const std::chrono::milliseconds tick, const Clock::time_point now)
+    : tick_(std::max(tick, std::chrono::milliseconds{1})), start_(now) {}
+
+void TimerWheel::add(const Clock::time_point when, Callback callback) {
+    const auto elapsed = std::chrono::ceil<std::chrono::milliseconds>(std::max(when - start_, Clock::duration::zero()));
+    const auto expire_tick = static_cast<uint64_t>((elapsed + tick_ - std::chrono::milliseconds{1}) / tick_);
+
+    // 至少延后一个 tick（当前 tick 的槽位已经处理过），最远不超过时间轮的范围
+    place({.expire_tick = std::clamp(expire_tick, current_tick_ + 1, current_tick_ + MAX_DELAY_TICKS),
+           .callback = std::move(callback)});
+    ++size_;
+}
+
+void TimerWheel::advance(const Clock::time_point now) {
+    if (now < start_) {
+        return;
+    }
+
+    const auto target = static_cast<uint64_t>((now - start_) / tick_);
+    while (current_tick_ < target) {
+        ++current_tick_;
+
+        // 低层转完一圈时，把高层对应槽位的定时器迁移下来
+        for (size_t level = 1;
+             level < LEVELS && ((current_tick_ >> (SLOT_BITS * (level - 1))) & SLOT_MASK) == 0; ++level) {
+            cascade(level);
+        }
+
+        Slot expired;
+        expired.swap(wheels_.at(0).at(current_tick_ & SLOT_MASK));
+        size_ -= expired.size();
+        for (auto& timer : expired) {
+            timer.callback();
+        }
+    }
+}
+
+int TimerWheel::timeoutMs(const Clock::time_point now) const {
+    if (size_ == 0) {
+        return -1;
+    }
+
+    // 找到最近的非空槽位；到达下一圈起点时可能有高层定时器迁移下来，也需要醒来
+    uint64_t ticks = 1;
+    while (ticks < SLOTS && ((current_tick_ + ticks) & SLOT_MASK) != 0 &&
+           wheels_.at(0).at((current_tick_ + ticks) & SLOT_MASK).empty()) {
+        ++ticks;
+    }
+
+    const auto deadline = start_ + tick_ * static_cast<int64_t>(current_tick_ + ticks);
+    if (deadline <= now) {
+        return 0;
+    }
+
+    // 向上取整，避免醒来时还差不到 1 毫秒而空转
+    const auto wait = std::chrono::ceil<std::chrono::milliseconds>(deadline - now).count();
+    return static_cast<int>(std::min<int64_t>(wait, std::numeric_limits<int>::max()));
+}
+
+size_t TimerWheel::size() const {
+    return size_;
+}
+
+void TimerWheel::place(Timer timer) {
+    const uint64_t delta = timer.expire_tick - current_tick_;
+
+    size_t level = 0;
+    while (level + 1 < LEVELS && delta >= (uint64_t{1} << (SLOT_BITS * (level + 1)))) {
+        ++level;
+    }
+
+    const uint64_t slot = (timer.expire_tick >> (SLOT_BITS * level)) & SLOT_MASK;
+    wheels_.at(level).at(slot).push_back(std::move(timer));
+}
+
+void TimerWheel::cascade(const size_t level) {
+    Slot timers;
+    timers.swap(wheels_.at(level).at((current_tick_ >> (SLOT_BITS * level)) & SLOT_MASK));
+    for (auto& timer : timers) {
+        place(std::move(timer));
+    }
+}
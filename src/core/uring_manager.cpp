@@ -0,0 +1,892 @@
+#include "core/uring_manager.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <format>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <linux/time_types.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "core/address.h"
+#include "core/listener.h"
+
+namespace {
+    constexpr int USER_DATA_OP_SHIFT = 56;
+    constexpr int USER_DATA_GENERATION_SHIFT = 32;
+    constexpr uint64_t USER_DATA_GENERATION_MASK = 0xFFFFFF;
+    constexpr uint32_t FD_MASK = 0xFFFFFFFF;
+    constexpr unsigned BUFFER_ID_SHIFT = IORING_CQE_BUFFER_SHIFT;
+    constexpr int64_t MS_PER_SEC = 1000;
+    constexpr int64_t NS_PER_MS = 1000000;
+    constexpr int PROBE_TIMEOUT_MS = 1000;
+
+    int ioUringSetup(const unsigned entries, io_uring_params* params) {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg)
+        return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+    }
+
+    int ioUringEnter(const int ring_fd, const unsigned to_submit, const unsigned min_complete, const unsigned flags,
+                     const void* arg, const size_t arg_size) {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg)
+        return static_cast<int>(syscall(__NR_io_uring_enter, ring_fd, to_submit, min_complete, flags, arg, arg_size));
+    }
+
+    int ioUringRegister(const int ring_fd, const unsigned opcode, const void* arg, const unsigned nr_args) {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg)
+        return static_cast<int>(syscall(__NR_io_uring_register, ring_fd, opcode, arg, nr_args));
+    }
+
+    template <typename T>
+    T* offsetPtr(void* base, const uint32_t offset) {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast, cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        return reinterpret_cast<T*>(static_cast<char*>(base) + offset);
+    }
+
+    uint32_t loadAcquire(uint32_t* value) {
+        return std::atomic_ref(*value).load(std::memory_order_acquire);
+    }
+
+    void storeRelease(uint32_t* value, const uint32_t new_value) {
+        std::atomic_ref(*value).store(new_value, std::memory_order_release);
+    }
+
+    // 缓冲区环的尾指针与第一个条目的 resv 字段重叠
+    uint16_t* bufferRingTail(void* ring) {
+        return &static_cast<io_uring_buf*>(ring)->resv;
+    }
+
+    // 等待超时参数，timeout 为负数时不限时
+    struct WaitArg {
+        __kernel_timespec timespec{};
+        io_uring_getevents_arg arg{};
+
+        explicit WaitArg(const int timeout) {
+            if (timeout >= 0) {
+                timespec.tv_sec = timeout / MS_PER_SEC;
+                timespec.tv_nsec = (timeout % MS_PER_SEC) * NS_PER_MS;
+                arg.ts = reinterpret_cast<uint64_t>(&timespec);  // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+            }
+        }
+    };
+}  // namespace
+
+UringManager::UringManager(const unsigned entries) {
+    try {
+        setupRing(entries);
+        setupBuffers();
+        probe();
+    } catch (...) {
+        release();
+        throw;
+    }
+}
+
+UringManager::~UringManager() {
+    // 异步发送中的数据由连接持有，连接析构时会调用 delFd，需在关闭 io_uring 之前释放
+    std::vector<std::shared_ptr<const void>> owners;
+    for (const auto& chunk : states_) {
+        if (!chunk) {
+            continue;
+        }
+        for (size_t index = 0; index < CHUNK_SIZE; ++index) {
+            FdState& state = chunk[index];
+            std::lock_guard lock(state.mutex);
+            if (state.send_owner) {
+                owners.push_back(std::move(state.send_owner));
+            }
+            for (const int client_fd : state.accepted) {
+                close(client_fd);
+            }
+            state.accepted.clear();
+        }
+    }
+    owners.clear();
+
+    release();
+}
+
+void UringManager::release() noexcept {
+    if (buffers_ != nullptr) {
+        munmap(buffers_, BUFFER_COUNT * BUFFER_SIZE);
+        buffers_ = nullptr;
+    }
+    if (buffer_ring_ptr_ != nullptr) {
+        munmap(buffer_ring_ptr_, BUFFER_COUNT * sizeof(io_uring_buf));
+        buffer_ring_ptr_ = nullptr;
+    }
+    if (sqes_ptr_ != nullptr) {
+        munmap(sqes_ptr_, sqes_size_);
+        sqes_ptr_ = nullptr;
+    }
+    if (ring_ptr_ != nullptr) {
+        munmap(ring_ptr_, ring_size_);
+        ring_ptr_ = nullptr;
+    }
+    if (ring_fd_ != -1) {
+        close(ring_fd_);
+        ring_fd_ = -1;
+    }
+}
+
+void UringManager::setupRing(const unsigned entries) {
+    io_uring_params params{};
+    params.flags = IORING_SETUP_CLAMP | IORING_SETUP_CQSIZE | IORING_SETUP_SUBMIT_ALL;
+    params.cq_entries = entries * CQ_ENTRIES_FACTOR;
+
+    ring_fd_ = ioUringSetup(entries, &params);
+    if (ring_fd_ == -1) {
+        throw std::runtime_error(std::format("io_uring_setup failed: {}", strerror(errno)));
+    }
+
+    // 需要单次映射、无丢失的完成队列以及带超时的等待
+    constexpr uint32_t required = IORING_FEAT_SINGLE_MMAP | IORING_FEAT_NODROP | IORING_FEAT_EXT_ARG;
+    if ((params.features & required) != required) {
+        throw std::runtime_error("io_uring lacks required features (kernel too old)");
+    }
+
+    const size_t sq_size = params.sq_off.array + (params.sq_entries * sizeof(uint32_t));
+    const size_t cq_size = params.cq_off.cqes + (params.cq_entries * sizeof(io_uring_cqe));
+    ring_size_ = std::max(sq_size, cq_size);
+
+    ring_ptr_ = mmap(nullptr, ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_,
+                     IORING_OFF_SQ_RING);
+    if (ring_ptr_ == MAP_FAILED) {
+        ring_ptr_ = nullptr;
+        throw std::runtime_error(std::format("io_uring ring mmap failed: {}", strerror(errno)));
+    }
+
+    sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+    sqes_ptr_ =
+        mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQES);
+    if (sqes_ptr_ == MAP_FAILED) {
+        sqes_ptr_ = nullptr;
+        throw std::runtime_error(std::format("io_uring sqes mmap failed: {}", strerror(errno)));
+    }
+
+    sq_entries_ = params.sq_entries;
+    sq_head_ = offsetPtr<uint32_t>(ring_ptr_, params.sq_off.head);
+    sq_tail_ = offsetPtr<uint32_t>(ring_ptr_, params.sq_off.tail);
+    sq_mask_ = *offsetPtr<uint32_t>(ring_ptr_, params.sq_off.ring_mask);
+    sqes_ = static_cast<io_uring_sqe*>(sqes_ptr_);
+
+    // SQ 数组固定为恒等映射，提交时只需写入 SQE 并移动尾指针
+    auto* sq_array = offsetPtr<uint32_t>(ring_ptr_, params.sq_off.array);
+    for (uint32_t index = 0; index < sq_entries_; ++index) {
+        sq_array[index] = index;  // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    }
+
+    cq_head_ = offsetPtr<uint32_t>(ring_ptr_, params.cq_off.head);
+    cq_tail_ = offsetPtr<uint32_t>(ring_ptr_, params.cq_off.tail);
+    cq_mask_ = *offsetPtr<uint32_t>(ring_ptr_, params.cq_off.ring_mask);
+    cqes_ = offsetPtr<io_uring_cqe>(ring_ptr_, params.cq_off.cqes);
+}
+
+void UringManager::setupBuffers() {
+    const size_t ring_size = BUFFER_COUNT * sizeof(io_uring_buf);
+    buffer_ring_ptr_ = mmap(nullptr, ring_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (buffer_ring_ptr_ == MAP_FAILED) {
+        buffer_ring_ptr_ = nullptr;
+        throw std::runtime_error(std::format("io_uring buffer ring mmap failed: {}", strerror(errno)));
+    }
+
+    void* buffers =
+        mmap(nullptr, BUFFER_COUNT * BUFFER_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (buffers == MAP_FAILED) {
+        throw std::runtime_error(std::format("io_uring buffer mmap failed: {}", strerror(errno)));
+    }
+    buffers_ = static_cast<char*>(buffers);
+
+    // 缓冲区环需要 Linux 5.19
+    io_uring_buf_reg reg{};
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    reg.ring_addr = reinterpret_cast<uint64_t>(buffer_ring_ptr_);
+    reg.ring_entries = BUFFER_COUNT;
+    reg.bgid = BUFFER_GROUP;
+    if (ioUringRegister(ring_fd_, IORING_REGISTER_PBUF_RING, &reg, 1) == -1) {
+        throw std::runtime_error(std::format("io_uring buffer ring registration failed: {}", strerror(errno)));
+    }
+
+    for (unsigned buffer_id = 0; buffer_id < BUFFER_COUNT; ++buffer_id) {
+        recycle(static_cast<uint16_t>(buffer_id));
+    }
+}
+
+void UringManager::probe() {
+    // 多次触发的 recv 需要 Linux 6.0，旧内核以 EINVAL 拒绝。用一对本地 socket 实际试一次：
+    // 先收到数据（带 IORING_CQE_F_MORE，请求仍然有效），关闭对端后以 EOF 终止
+    std::array<int, 2> fds{};
+    if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0, fds.data()) == -1) {
+        throw std::runtime_error(std::format("socketpair failed: {}", strerror(errno)));
+    }
+
+    io_uring_sqe sqe{};
+    sqe.opcode = IORING_OP_RECV;
+    sqe.fd = fds[0];
+    sqe.ioprio = IORING_RECV_MULTISHOT;
+    sqe.flags = IOSQE_BUFFER_SELECT;
+    sqe.buf_group = BUFFER_GROUP;
+    sqe.user_data = userData(Op::IGNORED, fds[0], 0);
+    submit(sqe, true);
+
+    constexpr char probe_byte = 'p';
+    [[maybe_unused]] const ssize_t written = write(fds[1], &probe_byte, 1);
+    close(fds[1]);
+
+    bool received = false;
+    bool finished = false;
+    while (!finished) {
+        const WaitArg wait_arg(PROBE_TIMEOUT_MS);
+        if (*cq_head_ == loadAcquire(cq_tail_) &&
+            ioUringEnter(ring_fd_, 0, 1, IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG, &wait_arg.arg,
+                         sizeof(wait_arg.arg)) == -1 &&
+            errno != EINTR) {
+            break;
+        }
+
+        uint32_t head = *cq_head_;
+        for (const uint32_t tail = loadAcquire(cq_tail_); head != tail; ++head) {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            const io_uring_cqe& cqe = cqes_[head & cq_mask_];
+            if ((cqe.flags & IORING_CQE_F_BUFFER) != 0) {
+                free_buffers_.fetch_sub(1, std::memory_order_relaxed);
+                recycle(static_cast<uint16_t>(cqe.flags >> BUFFER_ID_SHIFT));
+            }
+            received = received || (cqe.res == 1 && (cqe.flags & IORING_CQE_F_MORE) != 0);
+            finished = finished || (cqe.flags & IORING_CQE_F_MORE) == 0;
+        }
+        storeRelease(cq_head_, head);
+    }
+    close(fds[0]);
+
+    if (!finished || !received) {
+        throw std::runtime_error("io_uring lacks multishot recv with provided buffers (kernel too old)");
+    }
+}
+
+UringManager::FdState& UringManager::stateAt(const int fd, const bool allocate) const {  // NOLINT
+    if (fd < 0 || static_cast<size_t>(fd) >= MAX_FDS) {
+        throw std::runtime_error(std::format("io_uring: fd {} out of range", fd));
+    }
+
+    // 块只在注册时（事件循环线程或启动阶段）分配，其他线程只访问已注册 fd 所在的块
+    const auto index = static_cast<size_t>(fd);
+    auto& chunk = states_.at(index >> CHUNK_SHIFT);
+    if (!chunk) {
+        if (!allocate) {
+            throw std::runtime_error(std::format("io_uring: fd {} not registered", fd));
+        }
+        chunk = std::make_unique<FdState[]>(CHUNK_SIZE);  // NOLINT(cppcoreguidelines-avoid-c-arrays)
+    }
+    return chunk[index & (CHUNK_SIZE - 1)];
+}
+
+bool UringManager::onLoopThread() const {
+    return loop_thread_.load(std::memory_order_relaxed) == std::this_thread::get_id();
+}
+
+void UringManager::addFd(const int fd, const uint32_t events,  // NOLINT(readability-identifier-length)
+                         const uint64_t data) const {
+    FdState& state = stateAt(fd, true);
+    std::lock_guard lock(state.mutex);
+    if (state.kind != Kind::NONE) {
+        throw std::runtime_error(std::format("io_uring ADD failed: fd {} already registered", fd));
+    }
+
+    state.data = data;
+    state.events = events & (EPOLLIN | EPOLLOUT);
+    state.enabled = true;
+    state.eof = false;
+    state.error = 0;
+    state.send_done = false;
+
+    if ((events & EPOLLONESHOT) != 0) {
+        // 客户端 socket：立即开始接收，数据到达时按注册的事件上报
+        state.kind = Kind::SOCKET;
+        submitRecv(fd, state);
+        if ((events & EPOLLOUT) != 0) {
+            submitPoll(fd, state, POLLOUT, false);
+        }
+    } else {
+        // 其他 fd（唤醒用的 eventfd）使用多次触发的 poll
+        state.kind = Kind::POLL;
+        submitPoll(fd, state, events & (EPOLLIN | EPOLLOUT), true);
+    }
+}
+
+void UringManager::modFd(const int fd, const uint32_t events,  // NOLINT(readability-identifier-length)
+                         const uint64_t data) const {
+    FdState& state = stateAt(fd);
+    std::lock_guard lock(state.mutex);
+    if (state.kind != Kind::SOCKET) {
+        throw std::runtime_error(std::format("io_uring MOD failed: fd {} not registered", fd));
+    }
+
+    state.data = data;
+    state.events = events & (EPOLLIN | EPOLLOUT);
+    state.enabled = true;
+
+    // 与 epoll 相同：注册时条件已满足则立即上报，EPOLLERR / EPOLLHUP 总会上报
+    if (state.error != 0) {
+        state.enabled = false;
+        emit(state, EPOLLERR | EPOLLHUP | (state.events & EPOLLIN));
+    } else if ((state.events & EPOLLIN) != 0 && (!state.inbox.empty() || state.eof)) {
+        state.enabled = false;
+        emit(state, EPOLLIN);
+    } else if ((state.events & EPOLLOUT) != 0) {
+        if (state.send_done) {
+            state.enabled = false;
+            emit(state, EPOLLOUT);
+        } else if (!state.send_active && !state.poll_active) {
+            // sendfile 等直接写入的数据遇到 EAGAIN，等待 socket 可写
+            submitPoll(fd, state, POLLOUT, false);
+        }
+    }
+}
+
+void UringManager::delFd(const int fd) const {  // NOLINT(readability-identifier-length)
+    FdState& state = stateAt(fd);
+    std::deque<int> accepted;
+    std::shared_ptr<const void> owner;
+    {
+        std::lock_guard lock(state.mutex);
+        if (state.kind == Kind::NONE) {
+            throw std::runtime_error(std::format("io_uring DEL failed: fd {} not registered", fd));
+        }
+
+        state.kind = Kind::NONE;
+        state.enabled = false;
+        for (const HeldBuffer& held : state.inbox) {
+            recycle(held.id);
+        }
+        state.inbox.clear();
+        state.recv_active = false;
+        state.recv_paused = false;
+        state.send_active = false;
+        state.send_done = false;
+        state.poll_active = false;
+        state.accept_active = false;
+        state.accept_notified = false;
+        state.accept_error = 0;
+        accepted.swap(state.accepted);
+        owner = std::move(state.send_owner);
+
+        // 未完成的请求持有 fd 的引用，必须在调用方 close 之前取消，否则 socket 不会真正关闭。
+        // 取消后到达的完成事件因状态已清除而被忽略
+        io_uring_sqe sqe{};
+        sqe.opcode = IORING_OP_ASYNC_CANCEL;
+        sqe.fd = fd;
+        sqe.cancel_flags = IORING_ASYNC_CANCEL_FD | IORING_ASYNC_CANCEL_ALL;
+        sqe.user_data = userData(Op::IGNORED, fd, 0);
+        submit(sqe, true);
+    }
+
+    for (const int client_fd : accepted) {
+        close(client_fd);
+    }
+}
+
+void UringManager::addListener(const Listener& listener, const uint64_t data) const {
+    const int listen_fd = listener.fd();
+    FdState& state = stateAt(listen_fd, true);
+    std::lock_guard lock(state.mutex);
+    if (state.kind != Kind::NONE) {
+        throw std::runtime_error(std::format("io_uring ADD failed: fd {} already registered", listen_fd));
+    }
+
+    state.kind = Kind::LISTENER;
+    state.data = data;
+    state.events = EPOLLIN;
+    state.enabled = true;
+    submitAccept(listen_fd, state);
+}
+
+int UringManager::accept(const Listener& listener, Address& peer) const {
+    const int listen_fd = listener.fd();
+    FdState& state = stateAt(listen_fd);
+
+    int client_fd = -1;
+    {
+        std::lock_guard lock(state.mutex);
+        if (state.accepted.empty()) {
+            if (state.accept_error != 0) {
+                errno = std::exchange(state.accept_error, 0);
+                return -1;
+            }
+
+            // 队列已取空，下一个连接到达时重新上报；出错终止的 accept 在调用方退避结束后重新提交
+            state.accept_notified = false;
+            if (!state.accept_active && state.kind == Kind::LISTENER) {
+                submitAccept(listen_fd, state);
+            }
+            errno = EAGAIN;
+            return -1;
+        }
+
+        client_fd = state.accepted.front();
+        state.accepted.pop_front();
+    }
+
+    // 多次触发的 accept 不返回对端地址
+    sockaddr_storage storage{};
+    socklen_t length = sizeof(storage);
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    if (getpeername(client_fd, reinterpret_cast<sockaddr*>(&storage), &length) == -1) {
+        close(client_fd);
+        errno = ECONNABORTED;
+        return -1;
+    }
+    peer = Address(storage, length, client_fd);
+    return client_fd;
+}
+
+ssize_t UringManager::receive(const int fd, const std::span<char> buffer) const {  // NOLINT
+    FdState& state = stateAt(fd);
+    std::lock_guard lock(state.mutex);
+
+    size_t copied = 0;
+    while (copied < buffer.size() && !state.inbox.empty()) {
+        HeldBuffer& held = state.inbox.front();
+        const size_t count = std::min(buffer.size() - copied, static_cast<size_t>(held.length - held.offset));
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        std::memcpy(buffer.data() + copied, bufferAt(held.id) + held.offset, count);
+        copied += count;
+        held.offset += static_cast<uint32_t>(count);
+
+        if (held.offset == held.length) {
+            recycle(held.id);
+            state.inbox.pop_front();
+        }
+    }
+
+    if (state.recv_paused && state.inbox.size() <= MAX_HELD_BUFFERS / 2) {
+        state.recv_paused = false;
+        if (!state.recv_active && !state.eof && state.error == 0 && state.kind == Kind::SOCKET) {
+            submitRecv(fd, state);
+        }
+    }
+
+    if (copied > 0) {
+        return static_cast<ssize_t>(copied);
+    }
+    if (state.error != 0) {
+        errno = state.error;
+        return -1;
+    }
+    if (state.eof) {
+        return 0;
+    }
+    errno = EAGAIN;
+    return -1;
+}
+
+ssize_t UringManager::send(const int fd, const std::span<const iovec> iov,  // NOLINT(readability-identifier-length)
+                           const std::shared_ptr<const void>& owner) const {
+    FdState& state = stateAt(fd);
+    std::lock_guard lock(state.mutex);
+
+    if (state.send_done) {
+        // 上一次异步发送的结果
+        state.send_done = false;
+        if (state.send_result < 0) {
+            errno = -state.send_result;
+            return -1;
+        }
+        return state.send_result;
+    }
+    if (state.send_active) {
+        errno = EAGAIN;
+        return -1;
+    }
+
+    state.send_msg = {};
+    if (!onLoopThread()) {
+        // 工作线程直接发送，多数响应一次写完，不必等待完成事件再切换线程
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+        state.send_msg.msg_iov = const_cast<iovec*>(iov.data());
+        state.send_msg.msg_iovlen = iov.size();
+        const ssize_t bytes_sent = sendmsg(fd, &state.send_msg, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (bytes_sent >= 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) {
+            return bytes_sent;
+        }
+    }
+
+    // 交给内核在 socket 可写后发送；事件循环线程中与其他请求一起在下一次等待时批量提交
+    state.send_iov.assign(iov.begin(), iov.end());
+    state.send_msg.msg_iov = state.send_iov.data();
+    state.send_msg.msg_iovlen = state.send_iov.size();
+    state.send_owner = owner;
+    state.send_active = true;
+
+    io_uring_sqe sqe{};
+    sqe.opcode = IORING_OP_SENDMSG;
+    sqe.fd = fd;
+    sqe.addr = reinterpret_cast<uint64_t>(&state.send_msg);  // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+    sqe.len = 1;
+    sqe.msg_flags = MSG_NOSIGNAL;
+    sqe.user_data = userData(Op::SEND, fd, state.data);
+    submit(sqe);
+
+    errno = EAGAIN;
+    return -1;
+}
+
+int UringManager::wait(std::span<epoll_event> events, const int timeout) const {
+    loop_thread_.store(std::this_thread::get_id(), std::memory_order_relaxed);
+    rearmStarved();
+
+    bool block = timeout != 0 && *cq_head_ == loadAcquire(cq_tail_);
+    {
+        std::lock_guard lock(events_mutex_);
+        block = block && pending_events_.empty();
+        waiting_ = block;
+    }
+
+    // 提交事件循环线程积压的请求（批量发送、重新接收等），需要时同时等待完成事件，合并为一次系统调用
+    if (block) {
+        // 提交数量必须与已写入的 SQE 数量一致，内核提交得比要求的少时不会等待
+        uint32_t pending = 0;
+        {
+            std::lock_guard lock(sq_mutex_);
+            pending = *sq_tail_ - loadAcquire(sq_head_);
+        }
+        const WaitArg wait_arg(timeout);
+        ioUringEnter(ring_fd_, pending, 1, IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG, &wait_arg.arg,
+                     sizeof(wait_arg.arg));
+        std::lock_guard lock(events_mutex_);
+        waiting_ = false;
+    } else if (*sq_tail_ != loadAcquire(sq_head_)) {
+        enter();
+    }
+
+    reap();
+
+    std::lock_guard lock(events_mutex_);
+    const size_t count = std::min(events.size(), pending_events_.size());
+    std::copy_n(pending_events_.begin(), count, events.begin());
+    pending_events_.erase(pending_events_.begin(), pending_events_.begin() + static_cast<std::ptrdiff_t>(count));
+    return static_cast<int>(count);
+}
+
+std::string UringManager::name() const {
+    return "io_uring";
+}
+
+void UringManager::submit(const io_uring_sqe& sqe, const bool now) const {
+    {
+        std::lock_guard lock(sq_mutex_);
+        const uint32_t tail = *sq_tail_;
+        if (tail - loadAcquire(sq_head_) >= sq_entries_) {
+            // 提交队列已满，先提交再写入
+            enter();
+            if (tail - loadAcquire(sq_head_) >= sq_entries_) {
+                throw std::runtime_error("io_uring submission queue is full");
+            }
+        }
+
+        sqes_[tail & sq_mask_] = sqe;  // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        storeRelease(sq_tail_, tail + 1);
+    }
+
+    if (now || !onLoopThread()) {
+        enter();
+    }
+}
+
+void UringManager::enter() const {
+    // 内核提交队列中所有已写入的 SQE，其他线程同时写入的也一并提交
+    while (ioUringEnter(ring_fd_, sq_entries_, 0, 0, nullptr, 0) == -1 && errno == EINTR) {
+    }
+}
+
+void UringManager::submitRecv(const int fd, FdState& state) const {  // NOLINT(readability-identifier-length)
+    state.recv_active = true;
+
+    io_uring_sqe sqe{};
+    sqe.opcode = IORING_OP_RECV;
+    sqe.fd = fd;
+    sqe.ioprio = IORING_RECV_MULTISHOT;
+    sqe.flags = IOSQE_BUFFER_SELECT;
+    sqe.buf_group = BUFFER_GROUP;
+    sqe.user_data = userData(Op::RECV, fd, state.data);
+    submit(sqe);
+}
+
+void UringManager::submitAccept(const int fd, FdState& state) const {  // NOLINT(readability-identifier-length)
+    state.accept_active = true;
+
+    io_uring_sqe sqe{};
+    sqe.opcode = IORING_OP_ACCEPT;
+    sqe.fd = fd;
+    sqe.ioprio = IORING_ACCEPT_MULTISHOT;
+    sqe.accept_flags = SOCK_NONBLOCK | SOCK_CLOEXEC;
+    sqe.user_data = userData(Op::ACCEPT, fd, state.data);
+    submit(sqe);
+}
+
+void UringManager::submitPoll(const int fd, FdState& state, const uint32_t events,  // NOLINT
+                              const bool multishot) const {
+    state.poll_active = true;
+
+    io_uring_sqe sqe{};
+    sqe.opcode = IORING_OP_POLL_ADD;
+    sqe.fd = fd;
+    sqe.poll32_events = events;
+    sqe.len = multishot ? IORING_POLL_ADD_MULTI : 0;
+    sqe.user_data = userData(Op::POLL, fd, state.data);
+    submit(sqe);
+}
+
+void UringManager::recycle(const uint16_t buffer_id) const {
+    {
+        std::lock_guard lock(buffer_mutex_);
+        // 逐字段写入：第一个条目的 resv 字段是环的尾指针
+        auto& entry = static_cast<io_uring_buf*>(buffer_ring_ptr_)[buffer_tail_ & (BUFFER_COUNT - 1)];  // NOLINT
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        entry.addr = reinterpret_cast<uint64_t>(bufferAt(buffer_id));
+        entry.len = BUFFER_SIZE;
+        entry.bid = buffer_id;
+        std::atomic_ref(*bufferRingTail(buffer_ring_ptr_)).store(++buffer_tail_, std::memory_order_release);
+    }
+
+    ++free_buffers_;
+    if (starving_.exchange(false) && !onLoopThread()) {
+        // 唤醒事件循环重新开始接收
+        bool wake = false;
+        {
+            std::lock_guard lock(events_mutex_);
+            wake = std::exchange(waiting_, false);
+        }
+        if (wake) {
+            io_uring_sqe sqe{};
+            sqe.opcode = IORING_OP_NOP;
+            sqe.user_data = userData(Op::IGNORED, -1, 0);
+            submit(sqe, true);
+        }
+    }
+}
+
+char* UringManager::bufferAt(const uint16_t buffer_id) const {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    return buffers_ + (static_cast<size_t>(buffer_id) * BUFFER_SIZE);
+}
+
+void UringManager::emit(const FdState& state, const uint32_t events) const {
+    bool wake = false;
+    {
+        std::lock_guard lock(events_mutex_);
+        pending_events_.push_back({.events = events, .data = {.u64 = state.data}});
+        wake = std::exchange(waiting_, false);
+    }
+
+    // 事件循环阻塞时用一个空操作唤醒它（在事件循环线程中调用时不会阻塞）
+    if (wake) {
+        io_uring_sqe sqe{};
+        sqe.opcode = IORING_OP_NOP;
+        sqe.user_data = userData(Op::IGNORED, -1, 0);
+        submit(sqe, true);
+    }
+}
+
+void UringManager::rearmStarved() const {
+    if (starved_.empty()) {
+        return;
+    }
+
+    // 先标记再检查，归还缓冲区的线程要么看到标记并唤醒事件循环，要么这里看到归还的缓冲区
+    starving_ = true;
+    if (free_buffers_ <= 0) {
+        return;
+    }
+    starving_ = false;
+
+    for (const auto& [fd, data] : std::exchange(starved_, {})) {
+        FdState& state = stateAt(fd);
+        std::lock_guard lock(state.mutex);
+        if (state.kind == Kind::SOCKET && state.data == data && !state.recv_active && !state.recv_paused &&
+            !state.eof && state.error == 0) {
+            submitRecv(fd, state);
+        }
+    }
+}
+
+void UringManager::reap() const {
+    uint32_t head = *cq_head_;
+    for (const uint32_t tail = loadAcquire(cq_tail_); head != tail; ++head) {
+        const io_uring_cqe cqe = cqes_[head & cq_mask_];  // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        storeRelease(cq_head_, head + 1);
+        handleCompletion(cqe);
+    }
+}
+
+void UringManager::handleCompletion(const io_uring_cqe& cqe) const {
+    const auto operation = static_cast<Op>(cqe.user_data >> USER_DATA_OP_SHIFT);
+    const auto fd = static_cast<int>(cqe.user_data & FD_MASK);  // NOLINT(readability-identifier-length)
+    const auto generation = (cqe.user_data >> USER_DATA_GENERATION_SHIFT) & USER_DATA_GENERATION_MASK;
+
+    const bool has_buffer = (cqe.flags & IORING_CQE_F_BUFFER) != 0;
+    const auto buffer_id = static_cast<uint16_t>(cqe.flags >> BUFFER_ID_SHIFT);
+    if (has_buffer) {
+        free_buffers_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    std::shared_ptr<const void> owner;  // 在释放状态锁之后析构（可能析构连接并调用 delFd）
+    if (operation != Op::IGNORED) {
+        FdState& state = stateAt(fd);
+        std::lock_guard lock(state.mutex);
+
+        // fd 已删除或已被新连接复用：过期的完成事件
+        const bool stale =
+            state.kind == Kind::NONE ||
+            ((EventBackend::eventGeneration(state.data) & USER_DATA_GENERATION_MASK) != generation);
+        if (!stale) {
+            switch (operation) {
+                case Op::RECV:
+                    onRecv(fd, state, cqe);
+                    return;
+                case Op::ACCEPT:
+                    onAccept(state, cqe);
+                    return;
+                case Op::SEND:
+                    owner = onSend(state, cqe);
+                    break;
+                case Op::POLL:
+                    onPoll(fd, state, cqe);
+                    break;
+                case Op::IGNORED:
+                    break;
+            }
+        } else if (operation == Op::ACCEPT && cqe.res >= 0) {
+            close(cqe.res);  // 监听 socket 已删除，丢弃刚接受的连接
+        }
+    }
+
+    if (has_buffer) {
+        recycle(buffer_id);
+    }
+}
+
+void UringManager::onRecv(const int fd, FdState& state,  // NOLINT(readability-identifier-length)
+                          const io_uring_cqe& cqe) const {
+    if ((cqe.flags & IORING_CQE_F_BUFFER) != 0) {
+        const auto buffer_id = static_cast<uint16_t>(cqe.flags >> BUFFER_ID_SHIFT);
+        if (cqe.res > 0) {
+            state.inbox.push_back({.id = buffer_id, .offset = 0, .length = static_cast<uint32_t>(cqe.res)});
+        } else {
+            recycle(buffer_id);
+        }
+    }
+
+    if (cqe.res == 0) {
+        state.eof = true;
+    } else if (cqe.res < 0 && cqe.res != -ENOBUFS && cqe.res != -ECANCELED) {
+        state.error = -cqe.res;
+    }
+
+    if ((cqe.flags & IORING_CQE_F_MORE) == 0) {
+        state.recv_active = false;
+        if (!state.eof && state.error == 0 && !state.recv_paused) {
+            if (cqe.res == -ENOBUFS) {
+                starved_.emplace_back(fd, state.data);  // 所有缓冲区都在使用中，有缓冲区归还后再接收
+            } else {
+                submitRecv(fd, state);
+            }
+        }
+    } else if (state.inbox.size() >= MAX_HELD_BUFFERS && !state.recv_paused) {
+        // 连接处理得比数据到达慢：暂停接收，避免单个连接占满缓冲区，读取后再恢复
+        state.recv_paused = true;
+
+        io_uring_sqe sqe{};
+        sqe.opcode = IORING_OP_ASYNC_CANCEL;
+        sqe.addr = userData(Op::RECV, fd, state.data);
+        sqe.user_data = userData(Op::IGNORED, fd, 0);
+        submit(sqe);
+    }
+
+    if (!state.enabled) {
+        return;
+    }
+    if (state.error != 0) {
+        state.enabled = false;
+        emit(state, EPOLLERR | EPOLLHUP | (state.events & EPOLLIN));
+    } else if ((state.events & EPOLLIN) != 0 && (!state.inbox.empty() || state.eof)) {
+        state.enabled = false;
+        emit(state, EPOLLIN);
+    }
+}
+
+void UringManager::onAccept(FdState& state, const io_uring_cqe& cqe) const {
+    if (cqe.res >= 0) {
+        state.accepted.push_back(cqe.res);
+    } else if (cqe.res != -ECANCELED) {
+        state.accept_error = -cqe.res;
+    }
+
+    if ((cqe.flags & IORING_CQE_F_MORE) == 0) {
+        // 出错终止时等调用方取出错误并退避后再重新提交（见 accept()）
+        state.accept_active = false;
+    }
+
+    if (!state.accept_notified && (!state.accepted.empty() || state.accept_error != 0)) {
+        state.accept_notified = true;
+        emit(state, EPOLLIN);
+    }
+}
+
+std::shared_ptr<const void> UringManager::onSend(FdState& state, const io_uring_cqe& cqe) const {
+    state.send_active = false;
+    state.send_done = true;
+    state.send_result = cqe.res;
+    state.send_iov.clear();
+
+    if (state.enabled && (state.events & EPOLLOUT) != 0) {
+        state.enabled = false;
+        emit(state, EPOLLOUT);
+    }
+    return std::move(state.send_owner);
+}
+
+void UringManager::onPoll(const int fd, FdState& state,  // NOLINT(readability-identifier-length)
+                          const io_uring_cqe& cqe) const {
+    const bool more = (cqe.flags & IORING_CQE_F_MORE) != 0;
+    if (!more) {
+        state.poll_active = false;
+    }
+    if (cqe.res < 0) {
+        return;
+    }
+
+    const auto ready = static_cast<uint32_t>(cqe.res);
+    if (state.kind == Kind::POLL) {
+        emit(state, ready);
+        if (!more) {
+            submitPoll(fd, state, state.events, true);
+        }
+        return;
+    }
+
+    // 客户端 socket 等待可写：异步发送中时以发送完成为准
+    if (state.enabled && (state.events & EPOLLOUT) != 0 && !state.send_active) {
+        state.enabled = false;
+        emit(state, ready & (EPOLLOUT | EPOLLERR | EPOLLHUP));
+    }
+}
+
+uint64_t UringManager::userData(const Op op, const int fd, const uint64_t data) {  // NOLINT
+    return (static_cast<uint64_t>(op) << USER_DATA_OP_SHIFT) |
+           ((EventBackend::eventGeneration(data) & USER_DATA_GENERATION_MASK) << USER_DATA_GENERATION_SHIFT) |
+           static_cast<uint32_t>(fd);
+}
@@ -10,9 +10,9 @@
 
 #include "core/http_request.h"
 #include "core/http_response.h"
+#include "core/request_context.h"
 #include "user/session_manager.h"
 #include "utils/base64.h"
-#include "utils/cookie_parser.h"
 #include "utils/hash.h"
 #include "utils/http_form_data.h"
 #include "utils/logger.h"
@@ -37,14 +37,14 @@ UserManager::~UserManager() {
     logger_->log(LogLevel::INFO, "UserManager destroyed");
 }
 
-HttpResponse UserManager::registerUser(const HttpRequest& request) {
-    if (isLoggedIn(request)) {
+HttpResponse UserManager::registerUser(const RequestContext& context) {
+    if (context.isLoggedIn()) {
         return HttpResponse::responseAlert("已登录，请先注销当前会话。", "/");
     }
 
-    const auto form_data = HttpFormData(request.body());
+    const auto form_data = HttpFormData(context.request().body());
     if (auto invalid = form_data.check({"username", "password", "confirm_password"})) {
-        return *invalid;
+        return std::move(*invalid);
     }
 
     const std::string username = form_data.get("username").value_or("");
@@ -76,20 +76,21 @@ HttpResponse UserManager::registerUser(const HttpRequest& request) {
     auto session_id = session_manager_->createSession(username);
 
     constexpr int redirect_code = 302;
-    return HttpResponse::responseRedirect(redirect_code, drive_dir_)
-        .addHeader("Set-Cookie", std::format("session_id={}; Path=/; HttpOnly", session_id))
+    HttpResponse response = HttpResponse::responseRedirect(redirect_code, drive_dir_);
+    response.addHeader(HttpHeader::SET_COOKIE, std::format("session_id={}; Path=/; HttpOnly", session_id))
         .setContentType("text/plain; charset=UTF-8")
         .setBody("Registration successful.");
+    return response;
 }
 
-HttpResponse UserManager::loginUser(const HttpRequest& request) {
-    if (isLoggedIn(request)) {
+HttpResponse UserManager::loginUser(const RequestContext& context) {
+    if (context.isLoggedIn()) {
         return HttpResponse::responseAlert("已登录，请先注销当前会话。", "/");
     }
 
-    const auto form_data = HttpFormData(request.body());
+    const auto form_data = HttpFormData(context.request().body());
     if (auto invalid = form_data.check({"username", "password"})) {
-        return *invalid;
+        return std::move(*invalid);
     }
 
     const std::string username = form_data.get("username").value_or("");
@@ -111,16 +112,17 @@ HttpResponse UserManager::loginUser(const HttpRequest& request) {
     auto session_id = session_manager_->createSession(username);
 
     constexpr int redirect_code = 302;
-    return HttpResponse::responseRedirect(redirect_code, drive_dir_)
-        .addHeader("Set-Cookie", std::format("session_id={}; Path=/; HttpOnly", session_id))
+    HttpResponse response = HttpResponse::responseRedirect(redirect_code, drive_dir_);
+    response.addHeader(HttpHeader::SET_COOKIE, std::format("session_id={}; Path=/; HttpOnly", session_id))
         .setContentType("text/plain; charset=UTF-8")
         .setBody("Login successful.");
+    return response;
 }
 
-HttpResponse UserManager::changePassword(const HttpRequest& request) {
-    const auto form_data = HttpFormData(request.body());
+HttpResponse UserManager::changePassword(const RequestContext& context) {
+    const auto form_data = HttpFormData(context.request().body());
     if (auto invalid = form_data.check({"username", "old_password", "new_password", "confirm_password"})) {
-        return *invalid;
+        return std::move(*invalid);
     }
 
     const std::string username = form_data.get("username").value_or("");
@@ -150,43 +152,38 @@ HttpResponse UserManager::changePassword(const HttpRequest& request) {
     logger_->log(LogLevel::INFO, std::format("User password changed successfully: {}", username));
     saveUsers();
 
-    if (const auto session_id = CookieParser::get(request, "session_id"); session_id && isLoggedIn(*session_id)) {
+    if (context.isLoggedIn()) {
         // 如果用户已登录，则注销当前会话
-        session_manager_->removeSession(*session_id);
+        session_manager_->removeSession(std::string(*context.sessionId()));
         logger_->log(LogLevel::INFO, std::format("User logged out after password change: {}", username));
     }
 
-    return HttpResponse::responseAlert("密码修改成功，请重新登录。", "/login")
-        .addHeader("Set-Cookie", "session_id=; Path=/; HttpOnly; Max-Age=0");
+    HttpResponse response = HttpResponse::responseAlert("密码修改成功，请重新登录。", "/login");
+    response.addHeader(HttpHeader::SET_COOKIE, "session_id=; Path=/; HttpOnly; Max-Age=0");
+    return response;
 }
 
-HttpResponse UserManager::logoutUser(const HttpRequest& request) const {
-    const auto session_id = CookieParser::get(request, "session_id");
-    if (!session_id || !isLoggedIn(*session_id)) {
-        return HttpResponse::responseAlert("未登录或会话已过期，请重新登录。", "/login")
-            .addHeader("Set-Cookie", "session_id=; Path=/; HttpOnly; Max-Age=0");
+HttpResponse UserManager::logoutUser(const RequestContext& context) const {
+    if (!context.isLoggedIn()) {
+        HttpResponse response = HttpResponse::responseAlert("未登录或会话已过期，请重新登录。", "/login");
+        response.addHeader(HttpHeader::SET_COOKIE, "session_id=; Path=/; HttpOnly; Max-Age=0");
+        return response;
     }
 
-    session_manager_->removeSession(*session_id);
-    logger_->log(LogLevel::INFO, std::format("User logged out. Session id: {}", *session_id));
+    const std::string session_id(*context.sessionId());
+    session_manager_->removeSession(session_id);
+    logger_->log(LogLevel::INFO, std::format("User logged out. Session id: {}", session_id));
 
     constexpr int redirect_code = 302;
-    return HttpResponse::responseRedirect(redirect_code, "/")
-        .addHeader("Set-Cookie", "session_id=; Path=/; HttpOnly; Max-Age=0")
+    HttpResponse response = HttpResponse::responseRedirect(redirect_code, "/");
+    response.addHeader(HttpHeader::SET_COOKIE, "session_id=; Path=/; HttpOnly; Max-Age=0")
         .setContentType("text/plain; charset=UTF-8")
         .setBody("Logout successful.");
+    return response;
 }
 
-bool UserManager::isLoggedIn(const HttpRequest& request) const {
-    const auto session_id = CookieParser::get(request, "session_id");
-    if (!session_id) {
-        return false;
-    }
-    return isLoggedIn(*session_id);
-}
-
-bool UserManager::isLoggedIn(const std::string& session_id) const {
-    return session_manager_->getUsername(session_id).has_value();
+RequestContext UserManager::createContext(const HttpRequest& request) const {
+    return {request, session_manager_};
 }
 
 size_t UserManager::loadUsers() {
@@ -0,0 +1,54 @@
+#include "utils/buffer_pool.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+thread_local std::array<std::vector<std::unique_ptr<char[]>>, BufferPool::CLASS_COUNT>  // NOLINT
+    BufferPool::free_blocks_;
+
+BufferPool::Block BufferPool::acquire(const size_t min_size, const size_t max_size) {
+    size_t capacity = roundUp(min_size);
+    if (max_size != 0 && capacity > max_size) {
+        capacity = std::max(min_size, max_size);
+    }
+    if (capacity <= MAX_POOLED_SIZE && capacity == roundUp(capacity)) {
+        auto& blocks = free_blocks_.at(classIndex(capacity));
+        if (!blocks.empty()) {
+            Block block{.data = std::move(blocks.back()), .capacity = capacity};
+            blocks.pop_back();
+            return block;
+        }
+    }
+
+    // 接收缓冲区马上会被 recv 覆盖，不需要清零
+    return {.data = std::make_unique_for_overwrite<char[]>(capacity), .capacity = capacity};  // NOLINT
+}
+
+void BufferPool::release(Block block) {
+    if (!block.data || block.capacity > MAX_POOLED_SIZE || block.capacity != roundUp(block.capacity)) {
+        return;
+    }
+
+    auto& blocks = free_blocks_.at(classIndex(block.capacity));
+    if (blocks.size() * block.capacity < MAX_CACHED_BYTES) {
+        blocks.push_back(std::move(block.data));
+    }
+}
+
+size_t BufferPool::roundUp(const size_t min_size) {
+    size_t capacity = MIN_BLOCK_SIZE;
+    while (capacity < min_size && capacity < MAX_POOLED_SIZE) {
+        capacity <<= CLASS_SHIFT;
+    }
+    return capacity >= min_size ? capacity : std::bit_ceil(min_size);
+}
+
+size_t BufferPool::classIndex(const size_t capacity) {
+    static_assert(MIN_BLOCK_SIZE << (CLASS_SHIFT * (CLASS_COUNT - 1)) == MAX_POOLED_SIZE);
+    return static_cast<size_t>(std::countr_zero(capacity / MIN_BLOCK_SIZE)) / CLASS_SHIFT;
+}
@@ -0,0 +1,130 @@
+#include "utils/byte_scanner.h"
+
+#include <bit>
+#include <cstddef>
+#include <cstring>
+#include <string_view>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+namespace {
+    // 在 [data, data + size) 中查找长度不小于 2 的 needle，返回偏移或 npos
+    using FindFunc = size_t (*)(const char* data, size_t size, std::string_view needle);
+
+    size_t findScalar(const char* data, const size_t size, const std::string_view needle) {
+        return std::string_view(data, size).find(needle);
+    }
+
+    // 候选位置 offset + bit 的首、尾字节已匹配，比较中间部分
+    bool matchesAt(const char* data, const std::string_view needle) {
+        return std::memcmp(data + 1, needle.data() + 1, needle.size() - 2) == 0;
+    }
+
+#if defined(__x86_64__)
+    // SSE2 是 x86-64 的基础指令集，无需检测
+    size_t findSse2(const char* data, const size_t size, const std::string_view needle) {
+        constexpr size_t lanes = 16;
+        const size_t last_offset = needle.size() - 1;
+        const size_t candidates = size - last_offset;  // 可作为起点的位置数
+        const __m128i first = _mm_set1_epi8(needle.front());
+        const __m128i last = _mm_set1_epi8(needle.back());
+
+        size_t offset = 0;
+        for (; offset + lanes <= candidates; offset += lanes) {
+            const __m128i block_first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + offset));  // NOLINT
+            const __m128i block_last =
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + offset + last_offset));  // NOLINT
+            auto mask = static_cast<unsigned>(
+                _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(first, block_first), _mm_cmpeq_epi8(last, block_last))));
+            while (mask != 0) {
+                const auto bit = static_cast<size_t>(std::countr_zero(mask));
+                if (matchesAt(data + offset + bit, needle)) {
+                    return offset + bit;
+                }
+                mask &= mask - 1;
+            }
+        }
+
+        const size_t tail = findScalar(data + offset, size - offset, needle);
+        return tail == std::string_view::npos ? tail : offset + tail;
+    }
+
+    __attribute__((target("avx2"))) size_t findAvx2(const char* data, const size_t size,
+                                                    const std::string_view needle) {
+        constexpr size_t lanes = 32;
+        const size_t last_offset = needle.size() - 1;
+        const size_t candidates = size - last_offset;
+        const __m256i first = _mm256_set1_epi8(needle.front());
+        const __m256i last = _mm256_set1_epi8(needle.back());
+
+        size_t offset = 0;
+        for (; offset + lanes <= candidates; offset += lanes) {
+            const __m256i block_first =
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + offset));  // NOLINT
+            const __m256i block_last =
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + offset + last_offset));  // NOLINT
+            auto mask = static_cast<unsigned>(_mm256_movemask_epi8(
+                _mm256_and_si256(_mm256_cmpeq_epi8(first, block_first), _mm256_cmpeq_epi8(last, block_last))));
+            while (mask != 0) {
+                const auto bit = static_cast<size_t>(std::countr_zero(mask));
+                if (matchesAt(data + offset + bit, needle)) {
+                    return offset + bit;
+                }
+                mask &= mask - 1;
+            }
+        }
+
+        // 不足一个 AVX2 块的剩余部分交给 SSE2
+        const size_t tail = findSse2(data + offset, size - offset, needle);
+        return tail == std::string_view::npos ? tail : offset + tail;
+    }
+#endif
+
+    struct Implementation {
+        FindFunc find;
+        std::string_view name;
+    };
+
+    Implementation select() {
+#if defined(__x86_64__)
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+            return {.find = findAvx2, .name = "avx2"};
+        }
+        return {.find = findSse2, .name = "sse2"};
+#else
+        return {.find = findScalar, .name = "scalar"};
+#endif
+    }
+
+    const Implementation& implementation() {
+        static const Implementation impl = select();
+        return impl;
+    }
+}  // namespace
+
+size_t ByteScanner::find(const std::string_view haystack, const std::string_view needle, const size_t pos) {
+    if (pos > haystack.size() || needle.size() > haystack.size() - pos) {
+        return std::string_view::npos;
+    }
+    if (needle.size() < 2) {
+        return haystack.find(needle, pos);  // 单字节由 memchr 处理
+    }
+
+    const size_t found = ::implementation().find(haystack.data() + pos, haystack.size() - pos, needle);
+    return found == std::string_view::npos ? found : pos + found;
+}
+
+size_t ByteScanner::findCrlf(const std::string_view haystack, const size_t pos) {
+    return find(haystack, "\r\n", pos);
+}
+
+size_t ByteScanner::findHeaderEnd(const std::string_view haystack, const size_t pos) {
+    return find(haystack, "\r\n\r\n", pos);
+}
+
+std::string_view ByteScanner::implementation() {
+    return ::implementation().name;
+}
@@ -0,0 +1,396 @@
+#include "utils/hpack.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace {
+    // 静态表（RFC 7541 附录 A），下标从 1 开始
+    constexpr std::array<std::pair<std::string_view, std::string_view>, 61> STATIC_TABLE = {{
+        {":authority", ""},
+        {":method", "GET"},
+        {":method", "POST"},
+        {":path", "/"},
+        {":path", "/index.html"},
+        {":scheme", "http"},
+        {":scheme", "https"},
+        {":status", "200"},
+        {":status", "204"},
+        {":status", "206"},
+        {":status", "304"},
+        {":status", "400"},
+        {":status", "404"},
+        {":status", "500"},
+        {"accept-charset", ""},
+        {"accept-encoding", "gzip, deflate"},
+        {"accept-language", ""},
+        {"accept-ranges", ""},
+        {"accept", ""},
+        {"access-control-allow-origin", ""},
+        {"age", ""},
+        {"allow", ""},
+        {"authorization", ""},
+        {"cache-control", ""},
+        {"content-disposition", ""},
+        {"content-encoding", ""},
+        {"content-language", ""},
+        {"content-length", ""},
+        {"content-location", ""},
+        {"content-range", ""},
+        {"content-type", ""},
+        {"cookie", ""},
+        {"date", ""},
+        {"etag", ""},
+        {"expect", ""},
+        {"expires", ""},
+        {"from", ""},
+        {"host", ""},
+        {"if-match", ""},
+        {"if-modified-since", ""},
+        {"if-none-match", ""},
+        {"if-range", ""},
+        {"if-unmodified-since", ""},
+        {"last-modified", ""},
+        {"link", ""},
+        {"location", ""},
+        {"max-forwards", ""},
+        {"proxy-authenticate", ""},
+        {"proxy-authorization", ""},
+        {"range", ""},
+        {"referer", ""},
+        {"refresh", ""},
+        {"retry-after", ""},
+        {"server", ""},
+        {"set-cookie", ""},
+        {"strict-transport-security", ""},
+        {"transfer-encoding", ""},
+        {"user-agent", ""},
+        {"vary", ""},
+        {"via", ""},
+        {"www-authenticate", ""},
+    }};
+
+    constexpr size_t ENTRY_OVERHEAD = 32;  // 每个动态表条目的额外开销
+
+    // NOLINTBEGIN(readability-magic-numbers, cppcoreguidelines-avoid-magic-numbers)
+
+    // Huffman 编码表（RFC 7541 附录 B），不含 EOS
+    constexpr std::array<uint32_t, 256> HUFFMAN_CODES = {
+        0x1ff8, 0x7fffd8, 0xfffffe2, 0xfffffe3, 0xfffffe4, 0xfffffe5, 0xfffffe6, 0xfffffe7,
+        0xfffffe8, 0xffffea, 0x3ffffffc, 0xfffffe9, 0xfffffea, 0x3ffffffd, 0xfffffeb, 0xfffffec,
+        0xfffffed, 0xfffffee, 0xfffffef, 0xffffff0, 0xffffff1, 0xffffff2, 0x3ffffffe, 0xffffff3,
+        0xffffff4, 0xffffff5, 0xffffff6, 0xffffff7, 0xffffff8, 0xffffff9, 0xffffffa, 0xffffffb,
+        0x14, 0x3f8, 0x3f9, 0xffa, 0x1ff9, 0x15, 0xf8, 0x7fa,
+        0x3fa, 0x3fb, 0xf9, 0x7fb, 0xfa, 0x16, 0x17, 0x18,
+        0x0, 0x1, 0x2, 0x19, 0x1a, 0x1b, 0x1c, 0x1d,
+        0x1e, 0x1f, 0x5c, 0xfb, 0x7ffc, 0x20, 0xffb, 0x3fc,
+        0x1ffa, 0x21, 0x5d, 0x5e, 0x5f, 0x60, 0x61, 0x62,
+        0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6a,
+        0x6b, 0x6c, 0x6d, 0x6e, 0x6f, 0x70, 0x71, 0x72,
+        0xfc, 0x73, 0xfd, 0x1ffb, 0x7fff0, 0x1ffc, 0x3ffc, 0x22,
+        0x7ffd, 0x3, 0x23, 0x4, 0x24, 0x5, 0x25, 0x26,
+        0x27, 0x6, 0x74, 0x75, 0x28, 0x29, 0x2a, 0x7,
+        0x2b, 0x76, 0x2c, 0x8, 0x9, 0x2d, 0x77, 0x78,
+        0x79, 0x7a, 0x7b, 0x7ffe, 0x7fc, 0x3ffd, 0x1ffd, 0xffffffc,
+        0xfffe6, 0x3fffd2, 0xfffe7, 0xfffe8, 0x3fffd3, 0x3fffd4, 0x3fffd5, 0x7fffd9,
+        0x3fffd6, 0x7fffda, 0x7fffdb, 0x7fffdc, 0x7fffdd, 0x7fffde, 0xffffeb, 0x7fffdf,
+        0xffffec, 0xffffed, 0x3fffd7, 0x7fffe0, 0xffffee, 0x7fffe1, 0x7fffe2, 0x7fffe3,
+        0x7fffe4, 0x1fffdc, 0x3fffd8, 0x7fffe5, 0x3fffd9, 0x7fffe6, 0x7fffe7, 0xffffef,
+        0x3fffda, 0x1fffdd, 0xfffe9, 0x3fffdb, 0x3fffdc, 0x7fffe8, 0x7fffe9, 0x1fffde,
+        0x7fffea, 0x3fffdd, 0x3fffde, 0xfffff0, 0x1fffdf, 0x3fffdf, 0x7fffeb, 0x7fffec,
+        0x1fffe0, 0x1fffe1, 0x3fffe0, 0x1fffe2, 0x7fffed, 0x3fffe1, 0x7fffee, 0x7fffef,
+        0xfffea, 0x3fffe2, 0x3fffe3, 0x3fffe4, 0x7ffff0, 0x3fffe5, 0x3fffe6, 0x7ffff1,
+        0x3ffffe0, 0x3ffffe1, 0xfffeb, 0x7fff1, 0x3fffe7, 0x7ffff2, 0x3fffe8, 0x1ffffec,
+        0x3ffffe2, 0x3ffffe3, 0x3ffffe4, 0x7ffffde, 0x7ffffdf, 0x3ffffe5, 0xfffff1, 0x1ffffed,
+        0x7fff2, 0x1fffe3, 0x3ffffe6, 0x7ffffe0, 0x7ffffe1, 0x3ffffe7, 0x7ffffe2, 0xfffff2,
+        0x1fffe4, 0x1fffe5, 0x3ffffe8, 0x3ffffe9, 0xffffffd, 0x7ffffe3, 0x7ffffe4, 0x7ffffe5,
+        0xfffec, 0xfffff3, 0xfffed, 0x1fffe6, 0x3fffe9, 0x1fffe7, 0x1fffe8, 0x7ffff3,
+        0x3fffea, 0x3fffeb, 0x1ffffee, 0x1ffffef, 0xfffff4, 0xfffff5, 0x3ffffea, 0x7ffff4,
+        0x3ffffeb, 0x7ffffe6, 0x3ffffec, 0x3ffffed, 0x7ffffe7, 0x7ffffe8, 0x7ffffe9, 0x7ffffea,
+        0x7ffffeb, 0xffffffe, 0x7ffffec, 0x7ffffed, 0x7ffffee, 0x7ffffef, 0x7fffff0, 0x3ffffee,    };
+
+    constexpr std::array<uint8_t, 256> HUFFMAN_CODE_LENGTHS = {
+        13, 23, 28, 28, 28, 28, 28, 28, 28, 24, 30, 28, 28, 30, 28, 28,
+        28, 28, 28, 28, 28, 28, 30, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+        6, 10, 10, 12, 13, 6, 8, 11, 10, 10, 8, 11, 8, 6, 6, 6,
+        5, 5, 5, 6, 6, 6, 6, 6, 6, 6, 7, 8, 15, 6, 12, 10,
+        13, 6, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+        7, 7, 7, 7, 7, 7, 7, 7, 8, 7, 8, 13, 19, 13, 14, 6,
+        15, 5, 6, 5, 6, 5, 6, 6, 6, 5, 7, 7, 6, 6, 6, 5,
+        6, 7, 6, 5, 5, 6, 7, 7, 7, 7, 7, 15, 11, 14, 13, 28,
+        20, 22, 20, 20, 22, 22, 22, 23, 22, 23, 23, 23, 23, 23, 24, 23,
+        24, 24, 22, 23, 24, 23, 23, 23, 23, 21, 22, 23, 22, 23, 23, 24,
+        22, 21, 20, 22, 22, 23, 23, 21, 23, 22, 22, 24, 21, 22, 23, 23,
+        21, 21, 22, 21, 23, 22, 23, 23, 20, 22, 22, 22, 23, 22, 22, 23,
+        26, 26, 20, 19, 22, 23, 22, 25, 26, 26, 26, 27, 27, 26, 24, 25,
+        19, 21, 26, 27, 27, 26, 27, 24, 21, 21, 26, 26, 28, 27, 27, 27,
+        20, 24, 20, 21, 22, 21, 21, 23, 22, 22, 25, 25, 24, 24, 26, 23,
+        26, 27, 26, 26, 27, 27, 27, 27, 27, 28, 27, 27, 27, 27, 27, 26,    };
+
+    // NOLINTEND(readability-magic-numbers, cppcoreguidelines-avoid-magic-numbers)
+
+    // 由编码表构建的二叉解码树，叶子节点保存符号
+    class HuffmanTree {
+    public:
+        static constexpr int NO_NODE = -1;
+
+        struct Node {
+            std::array<int, 2> children = {NO_NODE, NO_NODE};
+            int symbol = NO_NODE;
+        };
+
+        HuffmanTree() : nodes_(1) {
+            for (size_t symbol = 0; symbol < HUFFMAN_CODES.size(); ++symbol) {
+                int node = 0;
+                for (int bit = HUFFMAN_CODE_LENGTHS.at(symbol) - 1; bit >= 0; --bit) {
+                    const auto branch = (HUFFMAN_CODES.at(symbol) >> bit) & 1U;
+                    if (nodes_[node].children.at(branch) == NO_NODE) {
+                        nodes_[node].children.at(branch) = static_cast<int>(nodes_.size());
+                        nodes_.emplace_back();
+                    }
+                    node = nodes_[node].children.at(branch);
+                }
+                nodes_[node].symbol = static_cast<int>(symbol);
+            }
+        }
+
+        [[nodiscard]] const Node& node(const int index) const { return nodes_[index]; }
+
+    private:
+        std::vector<Node> nodes_;
+    };
+
+    const HuffmanTree& huffmanTree() {
+        static const HuffmanTree tree;
+        return tree;
+    }
+
+    size_t entrySize(const HeaderField& field) {
+        return field.first.size() + field.second.size() + ENTRY_OVERHEAD;
+    }
+}  // namespace
+
+// NOLINTBEGIN(readability-magic-numbers, cppcoreguidelines-avoid-magic-numbers)
+
+HpackDecoder::HpackDecoder(const size_t max_table_size, const size_t max_header_list_size)
+    : max_table_size_(max_table_size), table_size_limit_(max_table_size), max_header_list_size_(max_header_list_size) {}
+
+HeaderList HpackDecoder::decode(const std::string_view block) {
+    HeaderList headers;
+    size_t list_size = 0;
+    size_t pos = 0;
+    bool field_seen = false;
+
+    while (pos < block.size()) {
+        const auto byte = static_cast<uint8_t>(block[pos]);
+        HeaderField field;
+
+        if ((byte & 0x80) != 0) {
+            // 索引字段
+            field = lookup(decodeInteger(block, pos, 7));
+        } else if ((byte & 0xc0) == 0x40) {
+            // 带增量索引的字面量，解码后插入动态表
+            const uint64_t index = decodeInteger(block, pos, 6);
+            field.first = index == 0 ? decodeString(block, pos) : lookup(index).first;
+            field.second = decodeString(block, pos);
+            insert(field);
+        } else if ((byte & 0xe0) == 0x20) {
+            // 动态表大小更新，只能出现在头部块开头
+            if (field_seen) {
+                throw std::invalid_argument("Dynamic table size update after header field");
+            }
+            const uint64_t limit = decodeInteger(block, pos, 5);
+            if (limit > max_table_size_) {
+                throw std::invalid_argument("Dynamic table size update exceeds limit");
+            }
+            table_size_limit_ = limit;
+            evict(table_size_limit_);
+            continue;
+        } else {
+            // 不索引 / 永不索引的字面量
+            const uint64_t index = decodeInteger(block, pos, 4);
+            field.first = index == 0 ? decodeString(block, pos) : lookup(index).first;
+            field.second = decodeString(block, pos);
+        }
+
+        field_seen = true;
+        list_size += entrySize(field);
+        if (list_size > max_header_list_size_) {
+            throw std::invalid_argument("Header list too large");
+        }
+        headers.push_back(std::move(field));
+    }
+
+    return headers;
+}
+
+const HeaderField& HpackDecoder::lookup(const uint64_t index) const {
+    static const auto static_fields = [] {
+        std::vector<HeaderField> fields;
+        for (const auto& [name, value] : STATIC_TABLE) {
+            fields.emplace_back(name, value);
+        }
+        return fields;
+    }();
+
+    if (index == 0) {
+        throw std::invalid_argument("Invalid header index 0");
+    }
+    if (index <= static_fields.size()) {
+        return static_fields[index - 1];
+    }
+
+    const uint64_t dynamic_index = index - static_fields.size() - 1;
+    if (dynamic_index >= dynamic_table_.size()) {
+        throw std::invalid_argument("Header index out of range");
+    }
+    return dynamic_table_[dynamic_index];
+}
+
+void HpackDecoder::insert(HeaderField field) {
+    const size_t size = entrySize(field);
+    if (size > table_size_limit_) {
+        // 条目大于整个动态表时清空动态表，不报错
+        evict(0);
+        return;
+    }
+
+    evict(table_size_limit_ - size);
+    dynamic_table_size_ += size;
+    dynamic_table_.push_front(std::move(field));
+}
+
+void HpackDecoder::evict(const size_t limit) {
+    while (dynamic_table_size_ > limit) {
+        dynamic_table_size_ -= entrySize(dynamic_table_.back());
+        dynamic_table_.pop_back();
+    }
+}
+
+uint64_t HpackDecoder::decodeInteger(const std::string_view block, size_t& pos, const int prefix_bits) {
+    const uint64_t prefix_max = (1U << prefix_bits) - 1;
+    uint64_t value = static_cast<uint8_t>(block[pos++]) & prefix_max;
+    if (value < prefix_max) {
+        return value;
+    }
+
+    // 超出前缀的部分以 7 位一组、低位在前的方式编码
+    for (int shift = 0; shift <= 56; shift += 7) {
+        if (pos >= block.size()) {
+            throw std::invalid_argument("Truncated integer");
+        }
+        const auto byte = static_cast<uint8_t>(block[pos++]);
+        value += static_cast<uint64_t>(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0) {
+            return value;
+        }
+    }
+    throw std::invalid_argument("Integer overflow");
+}
+
+std::string HpackDecoder::decodeString(const std::string_view block, size_t& pos) {
+    if (pos >= block.size()) {
+        throw std::invalid_argument("Truncated string");
+    }
+
+    const bool huffman = (static_cast<uint8_t>(block[pos]) & 0x80) != 0;
+    const uint64_t length = decodeInteger(block, pos, 7);
+    if (length > block.size() - pos) {
+        throw std::invalid_argument("Truncated string");
+    }
+
+    const std::string_view data = block.substr(pos, length);
+    pos += length;
+    return huffman ? decodeHuffman(data) : std::string(data);
+}
+
+std::string HpackDecoder::decodeHuffman(const std::string_view data) {
+    const HuffmanTree& tree = huffmanTree();
+    std::string output;
+    output.reserve(data.size() * 8 / 5);
+
+    int node = 0;
+    int depth = 0;         // 当前未完成码字已消耗的位数
+    bool all_ones = true;  // 未完成码字是否全为 1（合法的填充）
+    for (const char chr : data) {
+        for (int bit = 7; bit >= 0; --bit) {
+            const auto branch = (static_cast<uint8_t>(chr) >> bit) & 1U;
+            node = tree.node(node).children.at(branch);
+            if (node == HuffmanTree::NO_NODE) {
+                // 只有 EOS 会走到树外
+                throw std::invalid_argument("Invalid Huffman code");
+            }
+
+            ++depth;
+            all_ones = all_ones && branch == 1;
+            if (const int symbol = tree.node(node).symbol; symbol != HuffmanTree::NO_NODE) {
+                output.push_back(static_cast<char>(symbol));
+                node = 0;
+                depth = 0;
+                all_ones = true;
+            }
+        }
+    }
+
+    // 末尾填充必须是不超过 7 位的 EOS 前缀
+    if (depth > 7 || !all_ones) {
+        throw std::invalid_argument("Invalid Huffman padding");
+    }
+    return output;
+}
+
+std::string HpackEncoder::encode(const HeaderList& headers) {
+    std::string out;
+
+    for (const auto& [name, value] : headers) {
+        const auto exact = std::ranges::find_if(STATIC_TABLE, [&](const auto& entry) {
+            return entry.first == name && entry.second == value;
+        });
+        if (exact != STATIC_TABLE.end()) {
+            // 静态表中完全匹配，如 :status 200
+            encodeInteger(out, exact - STATIC_TABLE.begin() + 1, 7, 0x80);
+            continue;
+        }
+
+        // 不索引的字面量，名称能在静态表中找到时引用其下标
+        const auto named = std::ranges::find_if(STATIC_TABLE, [&](const auto& entry) { return entry.first == name; });
+        if (named != STATIC_TABLE.end()) {
+            encodeInteger(out, named - STATIC_TABLE.begin() + 1, 4, 0x00);
+        } else {
+            out.push_back(0x00);
+            encodeString(out, name);
+        }
+        encodeString(out, value);
+    }
+
+    return out;
+}
+
+void HpackEncoder::encodeInteger(std::string& out, uint64_t value, const int prefix_bits, const uint8_t flags) {
+    const uint64_t prefix_max = (1U << prefix_bits) - 1;
+    if (value < prefix_max) {
+        out.push_back(static_cast<char>(flags | value));
+        return;
+    }
+
+    out.push_back(static_cast<char>(flags | prefix_max));
+    value -= prefix_max;
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+void HpackEncoder::encodeString(std::string& out, const std::string_view str) {
+    encodeInteger(out, str.size(), 7, 0x00);
+    out.append(str);
+}
+
+// NOLINTEND(readability-magic-numbers, cppcoreguidelines-avoid-magic-numbers)
@@ -2,46 +2,47 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <memory_resource>
 #include <optional>
-#include <sstream>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 
 #include "core/http_response.h"
 #include "utils/url.h"
 
-HttpFormData::HttpFormData(const std::string& body) {
-    data_ = parse(body);
-}
+HttpFormData::HttpFormData(const std::string_view body, std::pmr::memory_resource* resource)
+    : data_(parse(body, resource)) {}
 
-std::unordered_map<std::string, std::string> HttpFormData::parse(const std::string& body) {
-    std::unordered_map<std::string, std::string> result;
-    std::istringstream iss(body);
-    std::string pair;
+HttpFormData::FieldMap HttpFormData::parse(const std::string_view body, std::pmr::memory_resource* resource) {
+    FieldMap result(resource);
 
-    while (std::getline(iss, pair, '&')) {
-        if (const auto pos = pair.find('='); pos != std::string::npos) {
-            std::string key = pair.substr(0, pos);
-            std::string value = pair.substr(pos + 1);
-            result[Url::decode(key)] = Url::decode(value);
+    for (size_t start = 0; start < body.size();) {
+        const size_t end = std::min(body.find('&', start), body.size());
+        const std::string_view pair = body.substr(start, end - start);
+        if (const auto pos = pair.find('='); pos != std::string_view::npos) {
+            // 同名字段以最后一个为准
+            result.insert_or_assign(std::pmr::string(Url::decode(pair.substr(0, pos)), resource),
+                                    Url::decode(pair.substr(pos + 1)));
         }
+        start = end + 1;
     }
 
     return result;
 }
 
-std::optional<std::string> HttpFormData::get(const std::string& key) const {
+std::optional<std::string> HttpFormData::get(const std::string_view key) const {
     if (const auto iter = data_.find(key); iter != data_.end()) {
-        return iter->second;
+        return std::string(iter->second);
     }
     return std::nullopt;
 }
 
-bool HttpFormData::contains(const std::string& key) const {
+bool HttpFormData::contains(const std::string_view key) const {
     return data_.contains(key);
 }
 
-const std::unordered_map<std::string, std::string>& HttpFormData::getData() const {
+const HttpFormData::FieldMap& HttpFormData::getData() const {
     return data_;
 }
 
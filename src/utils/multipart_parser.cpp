@@ -1,116 +1,239 @@
 #include "utils/multipart_parser.h"
 
+#include <algorithm>
+#include <cctype>
 #include <cstddef>
-#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
 #include <utility>
 
-MultipartParser::MultipartParser(std::string body, std::string boundary)
-    : body_(std::move(body)), boundary_(std::move(boundary)) {
-    parse();
-}
+#include "utils/byte_scanner.h"
 
-void MultipartParser::parse() const {
-    const std::string delimiter = "--" + boundary_;
-    size_t pos = 0;
+namespace {
+    constexpr std::string_view CRLF = "\r\n";
+    constexpr std::string_view HEADER_END = "\r\n\r\n";
 
-    while (true) {
-        size_t start = body_.find(delimiter, pos);
-        if (start == std::string::npos) {
-            break;
-        }
-        start += delimiter.length();
+    bool equalsIgnoreCase(const std::string_view lhs, const std::string_view rhs) {
+        return std::ranges::equal(lhs, rhs, [](const unsigned char lhs_chr, const unsigned char rhs_chr) {
+            return std::tolower(lhs_chr) == std::tolower(rhs_chr);
+        });
+    }
+}  // namespace
+
+MultipartParser::MultipartParser(const std::string_view boundary, Handler handler)
+    : delimiter_(std::string(CRLF) + "--" + std::string(boundary)),
+      handler_(std::move(handler)),
+      carry_(CRLF) {  // 第一个分隔符可以直接位于请求体开头，视作前面有一个 CRLF
+    if (boundary.empty()) {
+        throw std::invalid_argument("Empty multipart boundary");
+    }
+}
 
-        if (body_.substr(start, 2) == "\r\n") {
-            start += 2;
+void MultipartParser::feed(std::string_view data) {
+    while (!data.empty() && state_ != State::END) {
+        switch (state_) {
+            case State::PREAMBLE:
+            case State::DATA:
+                data = scanBody(data);
+                break;
+            case State::BOUNDARY_TAIL:
+                data = scanBoundaryTail(data);
+                break;
+            case State::HEADERS:
+                data = scanHeaders(data);
+                break;
+            case State::END:
+                break;
         }
+    }
+}
+
+bool MultipartParser::finished() const {
+    return state_ == State::END;
+}
+
+bool MultipartParser::inPart() const {
+    return state_ == State::DATA;
+}
 
-        const size_t next = body_.find(delimiter, start);
-        if (next == std::string::npos) {
-            break;
+std::string_view MultipartParser::scanBody(const std::string_view data) {
+    const size_t keep = delimiter_.size() - 1;
+
+    if (!carry_.empty()) {
+        // 上一段末尾可能是分隔符的前缀：与新数据的开头拼接后查找，只复制不超过两倍分隔符长度的数据
+        probe_.assign(carry_);
+        probe_.append(data.substr(0, keep));
+        if (const size_t pos = ByteScanner::find(probe_, delimiter_); pos != std::string_view::npos) {
+            emit(std::string_view(probe_).substr(0, pos));
+            const size_t used = pos + delimiter_.size() - carry_.size();
+            carry_.clear();
+            onDelimiter();
+            return data.substr(used);
         }
 
-        const std::string part = body_.substr(start, next - start);
-        const size_t header_end = part.find("\r\n\r\n");
-        if (header_end == std::string::npos) {
-            pos = next;
-            continue;
+        if (data.size() < keep) {
+            // 新数据太短，仍可能与后续数据组成分隔符
+            carry_.append(data);
+            if (carry_.size() > keep) {
+                emit(std::string_view(carry_).substr(0, carry_.size() - keep));
+                carry_.erase(0, carry_.size() - keep);
+            }
+            return {};
         }
 
-        const std::string headers = part.substr(0, header_end);
-        std::string content = part.substr(header_end + 4);
-        parseHeaders(headers);
+        // 分隔符不会从 carry_ 中开始，carry_ 全部是数据
+        emit(carry_);
+        carry_.clear();
+    }
 
-        if (content.ends_with("\r\n")) {
-            content.erase(content.length() - 2);
-        }
+    if (const size_t pos = ByteScanner::find(data, delimiter_); pos != std::string_view::npos) {
+        emit(data.substr(0, pos));
+        onDelimiter();
+        return data.substr(pos + delimiter_.size());
+    }
 
-        if (const auto iter = headers_.find("Content-Disposition"); iter != headers_.end()) {
-            const std::string name = getHeaderValue(iter->second, "name");
+    // 末尾不足一个分隔符长度的数据留到下一段再判断
+    const size_t safe = data.size() > keep ? data.size() - keep : 0;
+    emit(data.substr(0, safe));
+    carry_.assign(data.substr(safe));
+    return {};
+}
 
-            if (const std::string filename = getHeaderValue(iter->second, "filename"); !filename.empty()) {
-                // 处理文件上传
-                std::string content_type = "application/octet-stream";
-                if (const auto type_iter = headers_.find("Content-Type"); type_iter != headers_.end()) {
-                    content_type = type_iter->second;
-                    trim(content_type);
+std::string_view MultipartParser::scanBoundaryTail(const std::string_view data) {
+    for (size_t index = 0; index < data.size(); ++index) {
+        const char chr = data[index];
+        switch (tail_state_) {
+            case TailState::START:
+                if (chr == '-') {
+                    tail_state_ = TailState::DASH;
+                } else if (chr == '\r') {
+                    tail_state_ = TailState::CR;
+                } else if (chr != ' ' && chr != '\t') {  // 分隔符行末尾允许有空白
+                    throw std::invalid_argument("Invalid multipart delimiter");
                 }
-
-                files_.emplace_back(name, filename, content_type, content);
-            } else {
-                // 处理表单字段
-                fields_.emplace_back(name, content);
-            }
+                break;
+            case TailState::DASH:
+                if (chr != '-') {
+                    throw std::invalid_argument("Invalid multipart delimiter");
+                }
+                state_ = State::END;
+                return data.substr(index + 1);
+            case TailState::CR:
+                if (chr != '\n') {
+                    throw std::invalid_argument("Invalid multipart delimiter");
+                }
+                // 分隔符行的 CRLF 保留在头部缓冲区开头，使没有头部的部分同样以 CRLFCRLF 结束
+                state_ = State::HEADERS;
+                carry_.assign(CRLF);
+                return data.substr(index + 1);
         }
-
-        pos = next;
     }
+    return {};
 }
 
-void MultipartParser::parseHeaders(const std::string& headers) const {
-    std::istringstream header_stream(headers);
-    std::string line;
+std::string_view MultipartParser::scanHeaders(const std::string_view data) {
+    const size_t old_size = carry_.size();
+    const size_t scan_from = old_size > HEADER_END.size() - 1 ? old_size - (HEADER_END.size() - 1) : 0;
+    const size_t room = MAX_PART_HEADER_SIZE + HEADER_END.size() + CRLF.size() - old_size;
+    carry_.append(data.substr(0, room));
 
-    while (std::getline(header_stream, line)) {
-        if (!line.empty() && line.back() == '\r') {
-            line.pop_back();
+    const size_t pos = ByteScanner::findHeaderEnd(carry_, scan_from);
+    if (pos == std::string_view::npos) {
+        if (carry_.size() >= MAX_PART_HEADER_SIZE + HEADER_END.size() + CRLF.size()) {
+            throw std::invalid_argument("Multipart part header too large");
         }
+        return data.substr(std::min(room, data.size()));
+    }
 
-        if (const size_t colon = line.find(':'); colon != std::string::npos) {
-            std::string key = line.substr(0, colon);
-            std::string value = line.substr(colon + 1);
-            trim(key);
-            trim(value);
-            headers_[key] = value;
-        }
+    // 没有头部时结尾的空行与缓冲区开头的 CRLF 重叠，pos 为 0
+    const size_t headers_length = pos > CRLF.size() ? pos - CRLF.size() : 0;
+    const MultipartPart part = parseHeaders(std::string_view(carry_).substr(CRLF.size(), headers_length));
+    const size_t used = pos + HEADER_END.size() - old_size;
+    carry_.clear();
+    state_ = State::DATA;
+    if (handler_.on_part_begin) {
+        handler_.on_part_begin(part);
     }
+    return data.substr(used);
 }
 
-std::string MultipartParser::getHeaderValue(const std::string& header, const std::string& key) {
-    const std::string key_token = key + "=\"";
-    size_t pos = header.find(key_token);
-
-    if (pos == std::string::npos) {
-        return "";
+void MultipartParser::emit(const std::string_view data) const {
+    if (state_ == State::DATA && !data.empty() && handler_.on_part_data) {
+        handler_.on_part_data(data);
     }
+}
 
-    pos += key_token.length();
-    const size_t end_pos = header.find('"', pos);
-    if (end_pos == std::string::npos) {
-        return "";
+void MultipartParser::onDelimiter() {
+    if (state_ == State::DATA && handler_.on_part_end) {
+        handler_.on_part_end();
     }
-
-    return header.substr(pos, end_pos - pos);
+    state_ = State::BOUNDARY_TAIL;
+    tail_state_ = TailState::START;
 }
 
-const std::vector<FormField>& MultipartParser::fields() const {
-    return fields_;
+MultipartPart MultipartParser::parseHeaders(const std::string_view headers) {
+    MultipartPart part;
+
+    for (size_t line_start = 0; line_start < headers.size();) {
+        const size_t line_end = std::min(ByteScanner::findCrlf(headers, line_start), headers.size());
+        const std::string_view line = headers.substr(line_start, line_end - line_start);
+        line_start = line_end + CRLF.size();
+
+        const size_t colon = line.find(':');
+        if (colon == std::string_view::npos) {
+            continue;
+        }
+
+        const std::string_view key = trim(line.substr(0, colon));
+        const std::string_view value = trim(line.substr(colon + 1));
+        if (equalsIgnoreCase(key, "Content-Disposition")) {
+            part.name = getParameter(value, "name");
+            part.filename = getParameter(value, "filename");
+        } else if (equalsIgnoreCase(key, "Content-Type") && !value.empty()) {
+            part.content_type = value;
+        }
+    }
+    return part;
 }
 
-const std::vector<UploadedFile>& MultipartParser::files() const {
-    return files_;
+std::string MultipartParser::getParameter(const std::string_view header, const std::string_view key) {
+    // form-data; name="field"; filename="a.txt"，参数名不区分大小写，带引号的值中可以出现 ';'
+    size_t pos = header.find(';');
+    while (pos != std::string_view::npos && pos < header.size()) {
+        const size_t name_end = std::min(header.find_first_of("=;", pos + 1), header.size());
+        const std::string_view name = trim(header.substr(pos + 1, name_end - pos - 1));
+        if (name_end == header.size() || header[name_end] == ';') {
+            pos = name_end;
+            continue;
+        }
+
+        size_t value_start = header.find_first_not_of(" \t", name_end + 1);
+        std::string_view value;
+        if (value_start != std::string_view::npos && header[value_start] == '"') {
+            ++value_start;
+            const size_t quote = std::min(header.find('"', value_start), header.size());
+            value = header.substr(value_start, quote - value_start);
+            pos = header.find(';', quote);
+        } else {
+            value_start = std::min(value_start, header.size());
+            const size_t value_end = std::min(header.find(';', value_start), header.size());
+            value = trim(header.substr(value_start, value_end - value_start));
+            pos = value_end;
+        }
+
+        if (equalsIgnoreCase(name, key)) {
+            return std::string(value);
+        }
+    }
+    return "";
 }
 
-void MultipartParser::trim(std::string& str) {
-    str.erase(0, str.find_first_not_of(" \t"));
-    str.erase(str.find_last_not_of(" \t") + 1);
+std::string_view MultipartParser::trim(std::string_view str) {
+    const size_t begin = str.find_first_not_of(" \t");
+    if (begin == std::string_view::npos) {
+        return str.substr(str.size());
+    }
+    str.remove_prefix(begin);
+    return str.substr(0, str.find_last_not_of(" \t") + 1);
 }
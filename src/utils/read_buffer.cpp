@@ -0,0 +1,95 @@
+#include "utils/read_buffer.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <span>
+#include <string_view>
+#include <utility>
+
+#include "utils/buffer_pool.h"
+
+ReadBuffer::ReadBuffer(const size_t limit) : limit_(limit) {}
+
+ReadBuffer::~ReadBuffer() {
+    BufferPool::release(std::move(block_));
+}
+
+std::span<char> ReadBuffer::prepare() {
+    if (full()) {
+        return {};
+    }
+
+    if (!block_.data) {
+        block_ = BufferPool::acquire(limit_ == 0 ? initial_size_ : std::min(initial_size_, limit_), limit_);
+        begin_ = end_ = 0;
+    }
+
+    if (end_ == block_.capacity) {
+        const size_t length = size();
+        const bool at_limit = limit_ != 0 && block_.capacity >= limit_;
+        if (begin_ > 0 && (length <= block_.capacity / 2 || at_limit)) {
+            // 头部已处理的空间足够多，或容量已达上限，把剩余数据移到开头即可
+            std::memmove(block_.data.get(), block_.data.get() + begin_, length);
+        } else {
+            // 存储已满，换用下一级别的缓冲区（不超过上限），旧缓冲区归还
+            BufferPool::Block larger = BufferPool::acquire(block_.capacity + 1, limit_);
+            std::memcpy(larger.data.get(), block_.data.get() + begin_, length);
+            BufferPool::release(std::exchange(block_, std::move(larger)));
+        }
+        begin_ = 0;
+        end_ = length;
+    }
+
+    size_t available = block_.capacity - end_;
+    if (limit_ != 0) {
+        available = std::min(available, limit_ - size());
+    }
+    return {block_.data.get() + end_, available};
+}
+
+void ReadBuffer::commit(const size_t bytes) {
+    end_ += bytes;
+    peak_ = std::max(peak_, size());
+}
+
+void ReadBuffer::consume(const size_t bytes) {
+    begin_ += std::min(bytes, size());
+    if (begin_ == end_) {
+        begin_ = end_ = 0;
+    }
+}
+
+void ReadBuffer::clear() {
+    begin_ = end_ = 0;
+}
+
+void ReadBuffer::release() {
+    if (!empty() || !block_.data) {
+        return;
+    }
+
+    // 按本次的用量决定下次的初始容量：小请求只占用最小的缓冲区，持续的大请求免去逐级扩大
+    initial_size_ = std::min(BufferPool::roundUp(std::max<size_t>(peak_, 1)), MAX_INITIAL_SIZE);
+    peak_ = 0;
+    BufferPool::release(std::exchange(block_, {}));
+}
+
+std::string_view ReadBuffer::view() const {
+    if (!block_.data) {
+        return {};
+    }
+    return {block_.data.get() + begin_, size()};
+}
+
+size_t ReadBuffer::size() const {
+    return end_ - begin_;
+}
+
+bool ReadBuffer::empty() const {
+    return begin_ == end_;
+}
+
+bool ReadBuffer::full() const {
+    return limit_ != 0 && size() >= limit_;
+}
@@ -0,0 +1,26 @@
+#include "utils/request_arena.h"
+
+#include <memory_resource>
+
+RequestArena::Scope::Scope() {
+    ++state().depth;
+}
+
+RequestArena::Scope::~Scope() {
+    State& current = state();
+    if (--current.depth == 0) {
+        // 单调缓冲区回到初始状态，向内存池申请的块归还给内存池
+        current.arena.release();
+    }
+}
+
+std::pmr::memory_resource* RequestArena::resource() {
+    State& current = state();
+    return current.depth > 0 ? &current.arena : std::pmr::get_default_resource();
+}
+
+RequestArena::State& RequestArena::state() {
+    // 随线程退出释放
+    thread_local State current;
+    return current;
+}
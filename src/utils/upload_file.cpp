@@ -1,18 +1,28 @@
 #include "utils/upload_file.h"
 
 #include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
 #include <filesystem>
 #include <format>
 #include <optional>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
-#include "core/http_request.h"
 #include "core/http_response.h"
 #include "core/static_file.h"
 #include "utils/logger.h"
-#include "utils/multipart_parser.h"
 #include "utils/url.h"
 
 namespace {
+    constexpr size_t WRITE_CHUNK_SIZE = 1024 * 1024;  // 检查客户端是否已断开的间隔
+
     void escapeJsonString(std::string& input) {
         std::string output;
         output.reserve(input.size());
@@ -54,148 +64,298 @@ namespace {
     }
 }  // namespace
 
-UploadFile::UploadFile(const HttpRequest& request, Logger* logger, StaticFile* static_file, const Address& info)
-    : logger_(logger), static_file_(static_file), drive_path_(static_file->getDrivePath()) {
-    response_ = handle(request, info);
+UploadFile::UploadFile(const std::string_view request_path, const std::string_view boundary, Logger* logger,
+                       StaticFile* static_file, const Address& info, CancellationToken cancel)
+    : logger_(logger),
+      static_file_(static_file),
+      drive_path_(static_file->getDrivePath()),
+      info_(info),
+      cancel_(std::move(cancel)) {
+    if (boundary.empty()) {
+        // 没有边界，返回 400 错误
+        logger_->log(LogLevel::INFO, info_, "Missing boundary in Content-Type header.");
+        constexpr int error_code = 400;
+        rejection_ = HttpResponse::responseError(error_code, "No boundary found in request.");
+        return;
+    }
+
+    // 解析上传路径
+    upload_path_ = static_file_->getFileInfo(Url::decode(request_path)).first.parent_path();
+    logger_->log(LogLevel::DEBUG, info_, std::format("Upload path: {}", upload_path_.string()));
+
+    if (!checkPath(upload_path_)) {
+        // 上传路径不安全，返回 403 错误
+        constexpr int error_code = 403;
+        rejection_ = HttpResponse::responseError(error_code);
+        return;
+    }
+
+    parser_.emplace(boundary, MultipartParser::Handler{
+                                  .on_part_begin = [this](const MultipartPart& part) { onPartBegin(part); },
+                                  .on_part_data = [this](const std::string_view data) { onPartData(data); },
+                                  .on_part_end = [this] { onPartEnd(); },
+                              });
+}
+
+UploadFile::~UploadFile() {
+    // 请求体未接收完毕（如连接断开），删除未写完的文件
+    discardTemp();
+}
+
+const std::optional<HttpResponse>& UploadFile::rejection() const {
+    return rejection_;
+}
+
+void UploadFile::write(const std::string_view data) {
+    if (!parser_) {
+        return;
+    }
+
+    unchecked_bytes_ += data.size();
+    if (unchecked_bytes_ >= WRITE_CHUNK_SIZE) {
+        unchecked_bytes_ = 0;
+        if (cancel_.cancelled()) {
+            logger_->log(LogLevel::INFO, info_, std::format("Upload cancelled, removed: {}", filename_));
+            discardTemp();
+            throw OperationCancelled();
+        }
+    }
+
+    parser_->feed(data);
+}
+
+HttpResponse UploadFile::finish() {
+    if (rejection_) {
+        return *rejection_;
+    }
+
+    if (!parser_->finished()) {
+        // 请求体在结束分隔符之前结束，正在接收的文件不完整
+        logger_->log(LogLevel::INFO, info_, "Multipart body ended before the closing boundary.");
+        if (receiving_ && !skipping_) {
+            fail("文件不完整");
+        }
+        receiving_ = false;
+    }
+
+    if (file_count_ == 0) {
+        // 没有文件，返回 400 错误
+        logger_->log(LogLevel::INFO, info_, "No files found in upload request.");
+        constexpr int error_code = 400;
+        return HttpResponse::responseError(error_code, "No files found in upload request.");
+    }
+
+    std::ranges::sort(failure_files_);
+    return buildJsonResponse();
+}
+
+void UploadFile::onPartBegin(const MultipartPart& part) {
+    // 普通表单字段不保存
+    receiving_ = !part.filename.empty();
+    skipping_ = false;
+    if (!receiving_) {
+        return;
+    }
+
+    ++file_count_;
+    filename_ = part.filename;
+
+    const std::filesystem::path file_path = upload_path_ / filename_;
+    logger_->log(LogLevel::DEBUG, info_, std::format("Uploading file: {}", filename_));
+    logger_->log(LogLevel::DEBUG, info_, std::format("File path: {}", file_path.string()));
+
+    if (auto message = checkFilePath(file_path)) {
+        fail(std::move(*message));
+        return;
+    }
+
+    if (auto message = checkFilename(filename_)) {
+        fail(std::move(*message));
+        return;
+    }
+
+    if (!openTemp()) {
+        fail("写入文件失败");
+    }
+}
+
+void UploadFile::onPartData(const std::string_view data) {
+    if (!receiving_ || skipping_) {
+        return;
+    }
+
+    if (!writeTemp(data)) {
+        fail("写入文件失败");
+    }
+}
+
+void UploadFile::onPartEnd() {
+    if (!receiving_) {
+        return;
+    }
+    receiving_ = false;
+    if (skipping_) {
+        return;
+    }
+
+    if (auto message = commitTemp(upload_path_ / filename_)) {
+        fail(std::move(*message));
+        return;
+    }
+
+    logger_->log(LogLevel::INFO, info_, std::format("File upload successful: {}", upload_path_.string()));
+    ++success_count_;
+}
+
+bool UploadFile::openTemp() {
+    // 临时文件与目标文件位于同一目录，接收完毕后原子地改名
+    std::string pattern = (upload_path_ / std::format("{}XXXXXX", TEMP_FILE_PREFIX)).string();
+    const int file_fd = mkostemp(pattern.data(), O_CLOEXEC);
+    if (file_fd == -1) {
+        // 无法创建文件，上传失败
+        logger_->log(LogLevel::ERROR, info_,
+                     std::format("Failed to create temporary file in {}: {}", upload_path_.string(), strerror(errno)));
+        return false;
+    }
+
+    // mkostemp 创建的文件权限为 0600，与直接创建的文件保持一致
+    constexpr mode_t file_mode = 0644;
+    fchmod(file_fd, file_mode);
+
+    temp_fd_ = file_fd;
+    temp_path_ = pattern;
+    return true;
 }
 
-HttpResponse UploadFile::process() const {
-    return response_;
+bool UploadFile::writeTemp(std::string_view data) {
+    while (!data.empty()) {
+        const ssize_t written = ::write(temp_fd_, data.data(), data.size());
+        if (written == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            // 写入文件失败（如磁盘已满），上传失败
+            logger_->log(LogLevel::ERROR, info_,
+                         std::format("Failed to write {}: {}", temp_path_.string(), strerror(errno)));
+            return false;
+        }
+        data.remove_prefix(static_cast<size_t>(written));
+    }
+    return true;
 }
 
-std::optional<std::string> UploadFile::checkFilename(const std::string& name, const Address& info) const {
+std::optional<std::string> UploadFile::commitTemp(const std::filesystem::path& path) {
+    if (close(std::exchange(temp_fd_, -1)) == -1) {
+        logger_->log(LogLevel::ERROR, info_, std::format("Failed to close {}: {}", temp_path_.string(), strerror(errno)));
+        return "写入文件失败";
+    }
+
+    // RENAME_NOREPLACE：接收期间同名文件已被创建时不覆盖
+    if (renameat2(AT_FDCWD, temp_path_.c_str(), AT_FDCWD, path.c_str(), RENAME_NOREPLACE) == 0) {
+        temp_path_.clear();
+        return std::nullopt;
+    }
+
+    if (errno == EEXIST) {
+        logger_->log(LogLevel::DEBUG, info_, std::format("File already exists: {}", path.string()));
+        return "文件已存在";
+    }
+
+    if (errno != EINVAL && errno != ENOSYS) {
+        logger_->log(LogLevel::ERROR, info_,
+                     std::format("Failed to rename {} to {}: {}", temp_path_.string(), path.string(), strerror(errno)));
+        return "写入文件失败";
+    }
+
+    // 文件系统不支持 RENAME_NOREPLACE，退回到先检查再改名
+    std::error_code error;
+    if (exists(path, error)) {
+        logger_->log(LogLevel::DEBUG, info_, std::format("File already exists: {}", path.string()));
+        return "文件已存在";
+    }
+    std::filesystem::rename(temp_path_, path, error);
+    if (error) {
+        logger_->log(LogLevel::ERROR, info_,
+                     std::format("Failed to rename {} to {}: {}", temp_path_.string(), path.string(), error.message()));
+        return "写入文件失败";
+    }
+    temp_path_.clear();
+    return std::nullopt;
+}
+
+void UploadFile::fail(std::string message) {
+    failure_files_.emplace_back(filename_, std::move(message));
+    skipping_ = true;
+    discardTemp();
+}
+
+void UploadFile::discardTemp() {
+    if (temp_fd_ != -1) {
+        close(std::exchange(temp_fd_, -1));
+    }
+    if (!temp_path_.empty()) {
+        std::error_code error;
+        std::filesystem::remove(temp_path_, error);
+        temp_path_.clear();
+    }
+}
+
+std::optional<std::string> UploadFile::checkFilename(const std::string& name) const {
     // 检查文件名是否包含非法字符
     static constexpr std::string_view illegal_chars = "<>:\"/\\|?*";
     if (name.find_first_of(illegal_chars) != std::string::npos) {
         // 文件名包含非法字符
-        logger_->log(LogLevel::DEBUG, info, std::format("Filename contains illegal characters: {}", name));
+        logger_->log(LogLevel::DEBUG, info_, std::format("Filename contains illegal characters: {}", name));
         return "文件名包含非法字符";
     }
 
     if (name.empty()) {
         // 文件名为空
-        logger_->log(LogLevel::DEBUG, info, "Filename is empty.");
+        logger_->log(LogLevel::DEBUG, info_, "Filename is empty.");
         return "文件名为空";
     }
 
     return std::nullopt;
 }
 
-bool UploadFile::checkPath(const std::filesystem::path& path, const Address& info) const {
+bool UploadFile::checkPath(const std::filesystem::path& path) const {
     if (!weakly_canonical(path).string().starts_with(drive_path_.string())) {
         // 路径不安全
-        logger_->log(LogLevel::DEBUG, info, "Path is not safe.");
+        logger_->log(LogLevel::DEBUG, info_, "Path is not safe.");
         return false;
     }
 
     if (!exists(path)) {
         // 上传路径不存在，创建目录
-        logger_->log(LogLevel::DEBUG, info, std::format("Creating upload directory: {}", path.string()));
+        logger_->log(LogLevel::DEBUG, info_, std::format("Creating upload directory: {}", path.string()));
         create_directories(path);
     }
 
     if (!is_directory(path)) {
         // 上传路径不是目录
-        logger_->log(LogLevel::DEBUG, info, "Upload path is not a directory.");
+        logger_->log(LogLevel::DEBUG, info_, "Upload path is not a directory.");
         return false;
     }
 
     return true;
 }
 
-std::optional<std::string> UploadFile::checkFilePath(const std::filesystem::path& path, const Address& info) const {
+std::optional<std::string> UploadFile::checkFilePath(const std::filesystem::path& path) const {
     if (!weakly_canonical(path).string().starts_with(drive_path_.string())) {
         // 路径不安全
-        logger_->log(LogLevel::DEBUG, info, std::format("Unsafe file path: {}", path.string()));
+        logger_->log(LogLevel::DEBUG, info_, std::format("Unsafe file path: {}", path.string()));
         return "路径不安全";
     }
 
     if (exists(path)) {
         // 文件已存在
-        logger_->log(LogLevel::DEBUG, info, std::format("File already exists: {}", path.string()));
+        logger_->log(LogLevel::DEBUG, info_, std::format("File already exists: {}", path.string()));
         return "文件已存在";
     }
 
     return std::nullopt;
 }
 
-HttpResponse UploadFile::handle(const HttpRequest& request, const Address& info) {
-    const std::string boundary = request.getBoundary().value_or("");
-    if (boundary.empty()) {
-        // 没有边界，返回 400 错误
-        logger_->log(LogLevel::INFO, info, "Missing boundary in Content-Type header.");
-        constexpr int error_code = 400;
-        return HttpResponse::responseError(error_code, "No boundary found in request.");
-    }
-
-    const MultipartParser parser(request.body(), boundary);
-    const auto& files = parser.files();
-
-    if (files.empty()) {
-        // 没有文件，返回 400 错误
-        logger_->log(LogLevel::INFO, info, "No files found in upload request.");
-        constexpr int error_code = 400;
-        return HttpResponse::responseError(error_code, "No files found in upload request.");
-    }
-
-    // 解析上传路径
-    const std::string& path = request.path();
-    const auto upload_path = static_file_->getFileInfo(Url::decode(path)).first.parent_path();
-    logger_->log(LogLevel::DEBUG, info, std::format("Upload path: {}", upload_path.string()));
-
-    if (!checkPath(upload_path, info)) {
-        // 上传路径不安全，返回 403 错误
-        constexpr int error_code = 403;
-        return HttpResponse::responseError(error_code);
-    }
-
-    for (const auto& file : files) {
-        const std::filesystem::path file_path = upload_path / file.filename;
-        logger_->log(LogLevel::DEBUG, info, std::format("Uploading file: {}", file.filename));
-        logger_->log(LogLevel::DEBUG, info, std::format("File path: {}", file_path.string()));
-
-        if (const auto message = checkFilePath(file_path, info)) {
-            failure_files_.emplace_back(file.filename, *message);
-            continue;
-        }
-
-        if (const auto message = checkFilename(file.filename, info)) {
-            failure_files_.emplace_back(file.filename, *message);
-            continue;
-        }
-
-        if (!write(file_path, file.data, info)) {
-            failure_files_.emplace_back(file.filename, "写入文件失败");
-            continue;
-        }
-
-        logger_->log(LogLevel::INFO, info, std::format("File upload successful: {}", upload_path.string()));
-        ++success_count_;
-    }
-
-    std::ranges::sort(failure_files_);
-    return buildJsonResponse();
-}
-
-bool UploadFile::write(const std::filesystem::path& path, const std::string& data, const Address& info) const {
-    try {
-        std::ofstream ofs(path, std::ios::binary);
-        if (!ofs.is_open()) {
-            // 无法打开文件，上传失败
-            logger_->log(LogLevel::ERROR, info, std::format("Failed to open file for writing: {}", path.string()));
-            return false;
-        }
-
-        ofs.write(data.data(), static_cast<std::streamsize>(data.size()));
-        ofs.close();
-    } catch (const std::exception& e) {
-        // 写入文件失败，上传失败
-        logger_->log(LogLevel::ERROR, info, std::format("File upload failed: {}", e.what()));
-        return false;
-    }
-    return true;
-}
-
 HttpResponse UploadFile::buildMessage(const std::string& location) const {
     std::string message = std::format("上传完成：{} 成功，{} 失败", success_count_, failure_files_.size());
 
@@ -244,7 +404,9 @@ HttpResponse UploadFile::buildJsonResponse() const {
     }
 
     json += "}";
-    return HttpResponse{}.setContentType("application/json").setBody(json);
+    HttpResponse response;
+    response.setContentType("application/json").setBody(json);
+    return response;
 }
 
 std::string UploadFile::getLocation(const std::string& path) {